@@ -0,0 +1,211 @@
+//=============================================================================
+// Results
+//=============================================================================
+// CPU: Intel Xeon (virtual machine), single thread
+// Each operation is applied to 1024 random polygons, so that branches are not
+// perfectly predicted. Most of the cost of the quadratic polygons is in the
+// quadratic edges: a quadratic equation per edge for intersect and contains, and
+// numerical quadrature for centroid and meanChordLength.
+// clang-format off
+// area<1, 3>                  2353 ns         2306 ns        29709 items_per_second=443.989M/s
+// area<1, 4>                  2320 ns         2304 ns        31502 items_per_second=444.532M/s
+// area<2, 6>                  6971 ns         6964 ns         9411 items_per_second=147.046M/s
+// area<2, 8>                 10037 ns         9656 ns         7841 items_per_second=106.047M/s
+// centroid<1, 3>              1802 ns         1799 ns        38407 items_per_second=569.075M/s
+// centroid<1, 4>              5018 ns         4980 ns        12413 items_per_second=205.642M/s
+// centroid<2, 6>             33024 ns        31927 ns         2093 items_per_second=32.0727M/s
+// centroid<2, 8>             48483 ns        48125 ns         1350 items_per_second=21.2781M/s
+// contains<1, 3>              5441 ns         5286 ns        10878 items_per_second=193.702M/s
+// contains<1, 4>              6099 ns         6087 ns        12342 items_per_second=168.231M/s
+// contains<2, 6>             36053 ns        35513 ns         2092 items_per_second=28.8344M/s
+// contains<2, 8>             44541 ns        44473 ns         1727 items_per_second=23.0254M/s
+// meanChordLength<1, 3>      10024 ns         9918 ns         7306 items_per_second=103.243M/s
+// meanChordLength<1, 4>      12571 ns        12538 ns         5564 items_per_second=81.6705M/s
+// meanChordLength<2, 6>     100293 ns        99787 ns          823 items_per_second=10.2618M/s
+// meanChordLength<2, 8>     124857 ns       124771 ns          543 items_per_second=8.20703M/s
+// intersect<1, 3>            15876 ns        15873 ns         5417 items_per_second=64.5136M/s
+// intersect<1, 4>            19086 ns        19002 ns         3291 items_per_second=53.8892M/s
+// intersect<2, 6>            50347 ns        48839 ns         1343 items_per_second=20.9669M/s
+// intersect<2, 8>            61629 ns        59969 ns         1106 items_per_second=17.0754M/s
+// clang-format on
+
+#include "../helpers.hpp"
+
+#include <um2/common/cast_if_not.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/polygon.hpp>
+#include <um2/geometry/quadratic_quadrilateral.hpp>
+#include <um2/geometry/quadratic_triangle.hpp>
+#include <um2/geometry/quadrilateral.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/geometry/triangle.hpp>
+#include <um2/stdlib/math/trigonometric_functions.hpp>
+#include <um2/stdlib/numbers.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+Int constexpr num_polygons = 1024;
+Float constexpr box_size = 100;
+
+// A random convex polygon in the box: the regular polygon with random center,
+// radius and rotation. The edge midpoints of a quadratic polygon are displaced
+// along the edge normal by up to 10% of the radius, so that the edges curve
+// both inward and outward.
+template <Int P, Int N>
+auto
+makeRandomPolygon() -> um2::PlanarPolygon<P, N, Float>
+{
+  Int constexpr num_edges = um2::polygonNumEdges<P, N>();
+  Float const radius = 1 + randomFloat<Float>();
+  um2::Point2F const center(radius + randomFloat<Float>() * (box_size - 2 * radius),
+                            radius + randomFloat<Float>() * (box_size - 2 * radius));
+  Float const rotation = 2 * um2::pi<Float> * randomFloat<Float>();
+  um2::PlanarPolygon<P, N, Float> poly;
+  for (Int i = 0; i < num_edges; ++i) {
+    Float const angle = rotation + 2 * um2::pi<Float> * static_cast<Float>(i) /
+                                       static_cast<Float>(num_edges);
+    poly[i] = center + radius * um2::Vec2F(um2::cos(angle), um2::sin(angle));
+  }
+  if constexpr (P == 2) {
+    for (Int i = 0; i < num_edges; ++i) {
+      auto const & v0 = poly[i];
+      auto const & v1 = poly[(i + 1) % num_edges];
+      um2::Vec2F const normal(v1[1] - v0[1], v0[0] - v1[0]);
+      Float const offset = radius * (randomFloat<Float>() - castIfNot<Float>(0.5)) / 5;
+      poly[i + num_edges] = (v0 + v1) / 2 + offset * normal.normalized();
+    }
+  }
+  return poly;
+}
+
+template <Int P, Int N>
+auto
+makeRandomPolygons() -> um2::Vector<um2::PlanarPolygon<P, N, Float>>
+{
+  um2::Vector<um2::PlanarPolygon<P, N, Float>> polys(num_polygons);
+  for (auto & poly : polys) {
+    poly = makeRandomPolygon<P, N>();
+  }
+  return polys;
+}
+
+template <Int P, Int N>
+void
+area(benchmark::State & state)
+{
+  auto const polys = makeRandomPolygons<P, N>();
+  for (auto s : state) {
+    Float total = 0;
+    for (auto const & poly : polys) {
+      total += poly.area();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * num_polygons);
+}
+
+template <Int P, Int N>
+void
+centroid(benchmark::State & state)
+{
+  auto const polys = makeRandomPolygons<P, N>();
+  for (auto s : state) {
+    um2::Point2F total = um2::Point2F::zero();
+    for (auto const & poly : polys) {
+      total += poly.centroid();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * num_polygons);
+}
+
+template <Int P, Int N>
+void
+contains(benchmark::State & state)
+{
+  auto const polys = makeRandomPolygons<P, N>();
+  // Points near each polygon, roughly half of which are inside.
+  um2::Vector<um2::Point2F> points(num_polygons);
+  for (Int i = 0; i < num_polygons; ++i) {
+    auto const box = polys[i].boundingBox();
+    points[i] = makeVectorOfRandomPoints(1, box)[0];
+  }
+  for (auto s : state) {
+    Int count = 0;
+    for (Int i = 0; i < num_polygons; ++i) {
+      count += polys[i].contains(points[i]) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * num_polygons);
+}
+
+template <Int P, Int N>
+void
+meanChordLength(benchmark::State & state)
+{
+  auto const polys = makeRandomPolygons<P, N>();
+  for (auto s : state) {
+    Float total = 0;
+    for (auto const & poly : polys) {
+      total += poly.meanChordLength();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * num_polygons);
+}
+
+template <Int P, Int N>
+void
+intersect(benchmark::State & state)
+{
+  auto const polys = makeRandomPolygons<P, N>();
+  // Rays starting near each polygon, most of which intersect it.
+  um2::Vector<um2::Ray2F> rays;
+  rays.reserve(num_polygons);
+  for (Int i = 0; i < num_polygons; ++i) {
+    auto box = polys[i].boundingBox();
+    box.scale(2);
+    rays.emplace_back(makeVectorOfRandomRays(1, box)[0]);
+  }
+  Float buffer[2 * N];
+  for (auto s : state) {
+    Int hits = 0;
+    for (Int i = 0; i < num_polygons; ++i) {
+      hits += polys[i].intersect(rays[i], buffer);
+    }
+    benchmark::DoNotOptimize(hits);
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetItemsProcessed(state.iterations() * num_polygons);
+}
+
+BENCHMARK_TEMPLATE(area, 1, 3);
+BENCHMARK_TEMPLATE(area, 1, 4);
+BENCHMARK_TEMPLATE(area, 2, 6);
+BENCHMARK_TEMPLATE(area, 2, 8);
+
+BENCHMARK_TEMPLATE(centroid, 1, 3);
+BENCHMARK_TEMPLATE(centroid, 1, 4);
+BENCHMARK_TEMPLATE(centroid, 2, 6);
+BENCHMARK_TEMPLATE(centroid, 2, 8);
+
+BENCHMARK_TEMPLATE(contains, 1, 3);
+BENCHMARK_TEMPLATE(contains, 1, 4);
+BENCHMARK_TEMPLATE(contains, 2, 6);
+BENCHMARK_TEMPLATE(contains, 2, 8);
+
+BENCHMARK_TEMPLATE(meanChordLength, 1, 3);
+BENCHMARK_TEMPLATE(meanChordLength, 1, 4);
+BENCHMARK_TEMPLATE(meanChordLength, 2, 6);
+BENCHMARK_TEMPLATE(meanChordLength, 2, 8);
+
+BENCHMARK_TEMPLATE(intersect, 1, 3);
+BENCHMARK_TEMPLATE(intersect, 1, 4);
+BENCHMARK_TEMPLATE(intersect, 2, 6);
+BENCHMARK_TEMPLATE(intersect, 2, 8);
+
+BENCHMARK_MAIN();
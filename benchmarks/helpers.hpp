@@ -1,4 +1,9 @@
 #include <um2/common/logger.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/stdlib/math/trigonometric_functions.hpp>
+#include <um2/stdlib/numbers.hpp>
 #include <um2/stdlib/vector.hpp>
 
 #include <random>
@@ -47,6 +52,36 @@ makeVectorOfRandomInts(Int size) -> um2::Vector<T>
   return v;
 }
 
+template <class T>
+auto
+makeVectorOfRandomPoints(Int size, um2::AxisAlignedBox2<T> const & box)
+    -> um2::Vector<um2::Point2<T>>
+{
+  um2::Vector<um2::Point2<T>> v(size);
+  for (auto & p : v) {
+    p[0] = box.minima(0) + randomFloat<T>() * box.extents(0);
+    p[1] = box.minima(1) + randomFloat<T>() * box.extents(1);
+  }
+  return v;
+}
+
+// Rays with origins in the box and directions uniformly distributed in (0, 2π).
+template <class T>
+auto
+makeVectorOfRandomRays(Int size, um2::AxisAlignedBox2<T> const & box)
+    -> um2::Vector<um2::Ray2<T>>
+{
+  um2::Vector<um2::Ray2<T>> v;
+  v.reserve(size);
+  for (Int i = 0; i < size; ++i) {
+    um2::Point2<T> const origin(box.minima(0) + randomFloat<T>() * box.extents(0),
+                                box.minima(1) + randomFloat<T>() * box.extents(1));
+    T const angle = 2 * um2::pi<T> * randomFloat<T>();
+    v.emplace_back(origin, um2::Vec2<T>(um2::cos(angle), um2::sin(angle)));
+  }
+  return v;
+}
+
 #if UM2_USE_CUDA
 template <class T>
 void
@@ -0,0 +1,364 @@
+//=============================================================================
+// Results
+//=============================================================================
+// CPU: Intel Xeon (virtual machine), single thread
+// The meshes are n by n grids with 2n² triangles or n² quadrilaterals, with
+// shuffled faces. intersect and faceContaining test every face, hence scale with
+// the number of faces, while the BVH makes intersect roughly proportional to n.
+// clang-format off
+// intersect<1, 3>/16                        481 us          480 us          139 items_per_second=133.205k/s
+// intersect<1, 3>/64                       9080 us         9021 us            8 items_per_second=7.09447k/s
+// intersect<1, 3>/256                    167656 us       166838 us            1 items_per_second=383.606/s
+// intersect<1, 4>/16                        289 us          289 us          252 items_per_second=221.624k/s
+// intersect<1, 4>/64                       5224 us         5183 us           10 items_per_second=12.3473k/s
+// intersect<1, 4>/256                    106106 us       106110 us            1 items_per_second=603.148/s
+// intersect<2, 6>/16                       1841 us         1812 us           40 items_per_second=35.3175k/s
+// intersect<2, 6>/64                      39208 us        36609 us            2 items_per_second=1.74821k/s
+// intersect<2, 6>/256                   1584411 us      1560363 us            1 items_per_second=41.0161/s
+// intersect<2, 8>/16                       1128 us         1127 us           58 items_per_second=56.7695k/s
+// intersect<2, 8>/64                      21893 us        20617 us            4 items_per_second=3.10418k/s
+// intersect<2, 8>/256                    592986 us       589203 us            1 items_per_second=108.621/s
+// intersectBVH<1, 3>/16                    59.8 us         59.0 us         1098 items_per_second=1084.64k/s
+// intersectBVH<1, 3>/64                     282 us          270 us          326 items_per_second=236.915k/s
+// intersectBVH<1, 3>/256                   1255 us         1246 us           63 items_per_second=51.38k/s
+// intersectBVH<1, 4>/16                    61.4 us         61.4 us         1286 items_per_second=1042.47k/s
+// intersectBVH<1, 4>/64                     301 us          301 us          212 items_per_second=212.612k/s
+// intersectBVH<1, 4>/256                   1479 us         1389 us           44 items_per_second=46.0804k/s
+// intersectBVH<2, 6>/16                     188 us          186 us          355 items_per_second=344.781k/s
+// intersectBVH<2, 6>/64                     880 us          880 us           91 items_per_second=72.7594k/s
+// intersectBVH<2, 6>/256                   9955 us         9485 us            9 items_per_second=6.74772k/s
+// intersectBVH<2, 8>/16                     231 us          228 us          275 items_per_second=281.195k/s
+// intersectBVH<2, 8>/64                    1237 us         1237 us           60 items_per_second=51.7181k/s
+// intersectBVH<2, 8>/256                   5655 us         5642 us           12 items_per_second=11.3426k/s
+// sortRayMeshIntersections<1, 3>/16        24.9 us         24.4 us         3297 items_per_second=2.62756M/s
+// sortRayMeshIntersections<1, 3>/64         324 us          297 us          354 items_per_second=215.186k/s
+// sortRayMeshIntersections<1, 3>/256       1292 us         1291 us           63 items_per_second=49.5559k/s
+// sortRayMeshIntersections<1, 4>/16        14.6 us         14.5 us         5686 items_per_second=4.40423M/s
+// sortRayMeshIntersections<1, 4>/64        57.0 us         55.5 us         1118 items_per_second=1.1537M/s
+// sortRayMeshIntersections<1, 4>/256        897 us          892 us           78 items_per_second=71.7464k/s
+// sortRayMeshIntersections<2, 6>/16        26.3 us         26.3 us         2434 items_per_second=2.43626M/s
+// sortRayMeshIntersections<2, 6>/64         240 us          240 us          240 items_per_second=266.999k/s
+// sortRayMeshIntersections<2, 6>/256       1451 us         1441 us           48 items_per_second=44.4276k/s
+// sortRayMeshIntersections<2, 8>/16        16.4 us         16.3 us         4144 items_per_second=3.93384M/s
+// sortRayMeshIntersections<2, 8>/64        85.3 us         84.7 us          750 items_per_second=755.577k/s
+// sortRayMeshIntersections<2, 8>/256        643 us          643 us           97 items_per_second=99.5652k/s
+// faceContaining<1, 3>/16                   612 us          609 us          116 items_per_second=420.523k/s
+// faceContaining<1, 3>/64                 11284 us        11132 us            6 items_per_second=22.9959k/s
+// faceContaining<1, 3>/256               189388 us       188209 us            1 items_per_second=1.36019k/s
+// faceContaining<1, 4>/16                   154 us          154 us          476 items_per_second=1.66455M/s
+// faceContaining<1, 4>/64                  7173 us         7173 us           10 items_per_second=35.69k/s
+// faceContaining<1, 4>/256               130442 us       128169 us            1 items_per_second=1.99737k/s
+// faceContaining<2, 6>/16                  1686 us         1669 us           37 items_per_second=153.37k/s
+// faceContaining<2, 6>/64                 30661 us        30662 us            2 items_per_second=8.34902k/s
+// faceContaining<2, 6>/256               676782 us       671489 us            1 items_per_second=381.242/s
+// faceContaining<2, 8>/16                   704 us          699 us           97 items_per_second=366.188k/s
+// faceContaining<2, 8>/64                 13130 us        12202 us            6 items_per_second=20.9803k/s
+// faceContaining<2, 8>/256               291815 us       291305 us            1 items_per_second=878.804/s
+// mortonSort<1, 3>/16                      37.3 us         37.3 us         1967 items_per_second=13.7238M/s
+// mortonSort<1, 3>/64                      2110 us         2104 us           33 items_per_second=3.89329M/s
+// mortonSort<1, 3>/256                    52143 us        52116 us            1 items_per_second=2.51499M/s
+// mortonSort<1, 4>/16                      25.1 us         24.4 us         2812 items_per_second=10.4904M/s
+// mortonSort<1, 4>/64                      1341 us         1296 us           57 items_per_second=3.1604M/s
+// mortonSort<1, 4>/256                    31885 us        31574 us            2 items_per_second=2.07561M/s
+// mortonSort<2, 6>/16                       209 us          178 us          392 items_per_second=2.87913M/s
+// mortonSort<2, 6>/64                      6042 us         6039 us           11 items_per_second=1.35655M/s
+// mortonSort<2, 6>/256                   180071 us       172076 us            1 items_per_second=761.712k/s
+// mortonSort<2, 8>/16                      66.8 us         66.4 us          887 items_per_second=3.85618M/s
+// mortonSort<2, 8>/64                      3734 us         3628 us           19 items_per_second=1.12908M/s
+// mortonSort<2, 8>/256                    91314 us        91310 us            1 items_per_second=717.728k/s
+// populateVF<1, 3>/16                      2.68 us         2.66 us        27312 items_per_second=192.293M/s
+// populateVF<1, 3>/64                      89.4 us         88.9 us          812 items_per_second=92.1784M/s
+// populateVF<1, 3>/256                     3107 us         3080 us           22 items_per_second=42.5625M/s
+// populateVF<1, 4>/16                      1.97 us         1.96 us        35433 items_per_second=130.361M/s
+// populateVF<1, 4>/64                      50.4 us         50.4 us         1000 items_per_second=81.3118M/s
+// populateVF<1, 4>/256                     1565 us         1559 us           44 items_per_second=42.0475M/s
+// populateVF<2, 6>/16                      6.28 us         6.28 us        11609 items_per_second=81.5135M/s
+// populateVF<2, 6>/64                       250 us          249 us          281 items_per_second=32.9506M/s
+// populateVF<2, 6>/256                    11699 us        11697 us            5 items_per_second=11.2055M/s
+// populateVF<2, 8>/16                      4.16 us         4.16 us        16355 items_per_second=61.5527M/s
+// populateVF<2, 8>/64                       136 us          136 us          505 items_per_second=30.1183M/s
+// populateVF<2, 8>/256                     5349 us         5309 us           10 items_per_second=12.3432M/s
+// validate<1, 3>/16                        92.0 us         89.7 us          753 items_per_second=5.70793M/s
+// validate<1, 3>/64                        3048 us         2855 us           25 items_per_second=2.8694M/s
+// validate<1, 3>/256                      61535 us        59623 us            1 items_per_second=2.19834M/s
+// validate<1, 4>/16                        45.3 us         43.3 us         1659 items_per_second=5.91263M/s
+// validate<1, 4>/64                        1782 us         1771 us           37 items_per_second=2.31224M/s
+// validate<1, 4>/256                      34269 us        34269 us            2 items_per_second=1.91241M/s
+// validate<2, 6>/16                        1032 us         1032 us           57 items_per_second=496.19k/s
+// validate<2, 6>/64                       16589 us        16453 us            5 items_per_second=497.918k/s
+// validate<2, 6>/256                     294520 us       265351 us            1 items_per_second=493.957k/s
+// validate<2, 8>/16                         456 us          456 us          157 items_per_second=561.105k/s
+// validate<2, 8>/64                        9490 us         9439 us            9 items_per_second=433.928k/s
+// validate<2, 8>/256                     180898 us       172821 us            1 items_per_second=379.212k/s
+// clang-format on
+
+#include "../helpers.hpp"
+
+#include <um2/common/cast_if_not.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/stdlib/utility/swap.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+// The meshes are n by n grids of unit squares, for n in [lo, hi].
+Int constexpr lo = 16;
+Int constexpr hi = 256;
+Int constexpr num_rays = 64;
+Int constexpr num_points = 256;
+
+// An n by n grid of unit squares, split into triangles (N = 3, 6) or kept as
+// quadrilaterals (N = 4, 8). The interior vertices are displaced randomly, and
+// the faces are shuffled, so that the mesh has no convenient ordering.
+template <Int P, Int N>
+auto
+makeRandomMesh(Int const n) -> um2::FaceVertexMesh<P, N>
+{
+  // Vertex IDs:
+  //  - corner (i, j) for i, j in [0, n]
+  //  - midpoint of the horizontal edge from (i, j) to (i + 1, j)
+  //  - midpoint of the vertical edge from (i, j) to (i, j + 1)
+  //  - midpoint of the diagonal of cell (i, j), for quadratic triangles
+  Int const num_corners = (n + 1) * (n + 1);
+  Int const num_h = n * (n + 1);
+  Int const num_v = (n + 1) * n;
+  auto const corner = [n](Int i, Int j) { return j * (n + 1) + i; };
+  auto const hmid = [=](Int i, Int j) { return num_corners + j * n + i; };
+  auto const vmid = [=](Int i, Int j) { return num_corners + num_h + j * (n + 1) + i; };
+  auto const dmid = [=](Int i, Int j) { return num_corners + num_h + num_v + j * n + i; };
+
+  Int num_vertices = num_corners;
+  if constexpr (P == 2) {
+    num_vertices += num_h + num_v + (N == 6 ? n * n : 0);
+  }
+  um2::Vector<um2::Point2F> v(num_vertices);
+  for (Int j = 0; j <= n; ++j) {
+    for (Int i = 0; i <= n; ++i) {
+      um2::Point2F p(static_cast<Float>(i), static_cast<Float>(j));
+      if (0 < i && i < n && 0 < j && j < n) {
+        p[0] += castIfNot<Float>(0.4) * (randomFloat<Float>() - castIfNot<Float>(0.5));
+        p[1] += castIfNot<Float>(0.4) * (randomFloat<Float>() - castIfNot<Float>(0.5));
+      }
+      v[corner(i, j)] = p;
+    }
+  }
+  if constexpr (P == 2) {
+    for (Int j = 0; j <= n; ++j) {
+      for (Int i = 0; i < n; ++i) {
+        v[hmid(i, j)] = (v[corner(i, j)] + v[corner(i + 1, j)]) / 2;
+      }
+    }
+    for (Int j = 0; j < n; ++j) {
+      for (Int i = 0; i <= n; ++i) {
+        v[vmid(i, j)] = (v[corner(i, j)] + v[corner(i, j + 1)]) / 2;
+      }
+    }
+    if constexpr (N == 6) {
+      for (Int j = 0; j < n; ++j) {
+        for (Int i = 0; i < n; ++i) {
+          v[dmid(i, j)] = (v[corner(i, j)] + v[corner(i + 1, j + 1)]) / 2;
+        }
+      }
+    }
+  }
+
+  um2::Vector<um2::Vec<N, Int>> fv;
+  fv.reserve((N == 3 || N == 6 ? 2 : 1) * n * n);
+  for (Int j = 0; j < n; ++j) {
+    for (Int i = 0; i < n; ++i) {
+      Int const v00 = corner(i, j);
+      Int const v10 = corner(i + 1, j);
+      Int const v11 = corner(i + 1, j + 1);
+      Int const v01 = corner(i, j + 1);
+      if constexpr (N == 3) {
+        fv.emplace_back(v00, v10, v11);
+        fv.emplace_back(v11, v01, v00);
+      } else if constexpr (N == 4) {
+        fv.emplace_back(v00, v10, v11, v01);
+      } else if constexpr (N == 6) {
+        fv.emplace_back(v00, v10, v11, hmid(i, j), vmid(i + 1, j), dmid(i, j));
+        fv.emplace_back(v11, v01, v00, hmid(i, j + 1), vmid(i, j), dmid(i, j));
+      } else {
+        fv.emplace_back(v00, v10, v11, v01, hmid(i, j), vmid(i + 1, j), hmid(i, j + 1),
+                        vmid(i, j));
+      }
+    }
+  }
+
+  // Fisher-Yates shuffle of the faces
+  Int const num_faces = fv.size();
+  for (Int i = num_faces - 1; i > 0; --i) {
+    auto j = static_cast<Int>(randomFloat<Float>() * static_cast<Float>(i + 1));
+    j = j > i ? i : j;
+    um2::swap(fv[i], fv[j]);
+  }
+  return {v, fv};
+}
+
+template <Int P, Int N>
+void
+intersect(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto const mesh = makeRandomMesh<P, N>(n);
+  auto const rays = makeVectorOfRandomRays(num_rays, mesh.boundingBox());
+  Int const max_hits = 2 * mesh.numFaces();
+  um2::Vector<Float> coords(max_hits);
+  um2::Vector<Int> offsets(mesh.numFaces() + 1);
+  um2::Vector<Int> faces(mesh.numFaces());
+  for (auto s : state) {
+    for (auto const & ray : rays) {
+      auto const hits_faces =
+          mesh.intersect(ray, coords.data(), offsets.data(), faces.data());
+      benchmark::DoNotOptimize(hits_faces);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rays);
+}
+
+// Same as intersect, but with a BVH over the morton sorted faces.
+template <Int P, Int N>
+void
+intersectBVH(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto mesh = makeRandomMesh<P, N>(n);
+  mesh.mortonSort();
+  mesh.populateBVH();
+  auto const rays = makeVectorOfRandomRays(num_rays, mesh.boundingBox());
+  Int const max_hits = 2 * mesh.numFaces();
+  um2::Vector<Float> coords(max_hits);
+  um2::Vector<Int> offsets(mesh.numFaces() + 1);
+  um2::Vector<Int> faces(mesh.numFaces());
+  for (auto s : state) {
+    for (auto const & ray : rays) {
+      auto const hits_faces =
+          mesh.intersect(ray, coords.data(), offsets.data(), faces.data());
+      benchmark::DoNotOptimize(hits_faces);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rays);
+}
+
+template <Int P, Int N>
+void
+sortRayMeshIntersections(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto const mesh = makeRandomMesh<P, N>(n);
+  auto const rays = makeVectorOfRandomRays(num_rays, mesh.boundingBox());
+  Int const num_faces = mesh.numFaces();
+  Int const max_hits = 2 * num_faces;
+  um2::Vector<um2::Vector<Float>> coords(num_rays, um2::Vector<Float>(max_hits));
+  um2::Vector<um2::Vector<Int>> offsets(num_rays, um2::Vector<Int>(num_faces + 1));
+  um2::Vector<um2::Vector<Int>> faces(num_rays, um2::Vector<Int>(num_faces));
+  um2::Vector<um2::Vec2I> hits_faces(num_rays);
+  for (Int i = 0; i < num_rays; ++i) {
+    hits_faces[i] = mesh.intersect(rays[i], coords[i].data(), offsets[i].data(),
+                                   faces[i].data());
+  }
+  um2::Vector<Float> sorted_coords(max_hits);
+  um2::Vector<Int> sorted_offsets(num_faces + 1);
+  um2::Vector<Int> sorted_faces(num_faces);
+  um2::Vector<Int> perm(num_faces);
+  for (auto s : state) {
+    for (Int i = 0; i < num_rays; ++i) {
+      um2::sortRayMeshIntersections(coords[i].data(), offsets[i].data(), faces[i].data(),
+                                    sorted_coords.data(), sorted_offsets.data(),
+                                    sorted_faces.data(), perm.data(), hits_faces[i]);
+      benchmark::DoNotOptimize(sorted_coords.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rays);
+}
+
+template <Int P, Int N>
+void
+faceContaining(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto const mesh = makeRandomMesh<P, N>(n);
+  auto const points = makeVectorOfRandomPoints(num_points, mesh.boundingBox());
+  for (auto s : state) {
+    for (auto const & p : points) {
+      Int const face = mesh.faceContaining(p);
+      benchmark::DoNotOptimize(face);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+template <Int P, Int N>
+void
+mortonSort(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto const mesh = makeRandomMesh<P, N>(n);
+  for (auto s : state) {
+    state.PauseTiming();
+    auto sorted = mesh;
+    state.ResumeTiming();
+    sorted.mortonSort();
+    benchmark::DoNotOptimize(sorted.vertices().data());
+  }
+  state.SetItemsProcessed(state.iterations() * mesh.numFaces());
+}
+
+template <Int P, Int N>
+void
+populateVF(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto mesh = makeRandomMesh<P, N>(n);
+  for (auto s : state) {
+    mesh.populateVF();
+    benchmark::DoNotOptimize(mesh.vertexFaceConn().data());
+  }
+  state.SetItemsProcessed(state.iterations() * mesh.numFaces());
+}
+
+template <Int P, Int N>
+void
+validate(benchmark::State & state)
+{
+  Int const n = static_cast<Int>(state.range(0));
+  auto mesh = makeRandomMesh<P, N>(n);
+  for (auto s : state) {
+    mesh.validate();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * mesh.numFaces());
+}
+
+#define UM2_MESH_BENCHMARK(name)                                                         \
+  BENCHMARK_TEMPLATE(name, 1, 3)                                                         \
+      ->RangeMultiplier(4)                                                               \
+      ->Range(lo, hi)                                                                    \
+      ->Unit(benchmark::kMicrosecond);                                                   \
+  BENCHMARK_TEMPLATE(name, 1, 4)                                                         \
+      ->RangeMultiplier(4)                                                               \
+      ->Range(lo, hi)                                                                    \
+      ->Unit(benchmark::kMicrosecond);                                                   \
+  BENCHMARK_TEMPLATE(name, 2, 6)                                                         \
+      ->RangeMultiplier(4)                                                               \
+      ->Range(lo, hi)                                                                    \
+      ->Unit(benchmark::kMicrosecond);                                                   \
+  BENCHMARK_TEMPLATE(name, 2, 8)                                                         \
+      ->RangeMultiplier(4)                                                               \
+      ->Range(lo, hi)                                                                    \
+      ->Unit(benchmark::kMicrosecond)
+
+UM2_MESH_BENCHMARK(intersect);
+UM2_MESH_BENCHMARK(intersectBVH);
+UM2_MESH_BENCHMARK(sortRayMeshIntersections);
+UM2_MESH_BENCHMARK(faceContaining);
+UM2_MESH_BENCHMARK(mortonSort);
+UM2_MESH_BENCHMARK(populateVF);
+UM2_MESH_BENCHMARK(validate);
+
+BENCHMARK_MAIN();
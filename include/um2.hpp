@@ -10,6 +10,8 @@
 #include <um2/common/string_to_lattice.hpp>
 #include <um2/mpact/model.hpp>
 #include <um2/mpact/powers.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/mpact/segment_file.hpp>
 #include <um2/physics/material.hpp>
 
 //==============================================================================
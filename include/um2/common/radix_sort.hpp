@@ -0,0 +1,89 @@
+#pragma once
+
+#include <um2/config.hpp>
+#include <um2/stdlib/assert.hpp>
+#include <um2/stdlib/numeric/iota.hpp>
+#include <um2/stdlib/utility/swap.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <concepts>
+
+namespace um2
+{
+
+//==============================================================================
+// radixSortPermutation
+//==============================================================================
+// Create a permutation that sorts the unsigned integer keys [begin, end) when
+// applied. [begin, end) is not modified.
+//
+// Least significant digit radix sort of (key, index) pairs with 8-bit digits.
+// The histograms of every digit are computed in a single pass over the keys,
+// and the passes for digits which are the same for every key, such as the high
+// digits of Morton codes of points in a small region, are skipped. Hence, the
+// sort takes at most sizeof(U) + 1 passes over the keys, independent of their
+// distribution. The sort is stable: equal keys remain in index order.
+
+template <std::unsigned_integral U>
+void
+radixSortPermutation(U const * const begin, U const * const end,
+                     Int * const perm_begin) noexcept
+{
+  Int constexpr num_digits = static_cast<Int>(sizeof(U));
+  Int constexpr num_buckets = 256;
+  auto const n = static_cast<Int>(end - begin);
+  um2::iota(perm_begin, perm_begin + n, 0);
+  if (n < 2) {
+    return;
+  }
+
+  // Count the occurrences of each value of each digit.
+  Vector<Int> counts(num_digits * num_buckets, 0);
+  for (Int i = 0; i < n; ++i) {
+    U key = begin[i];
+    for (Int d = 0; d < num_digits; ++d) {
+      ++counts[d * num_buckets + static_cast<Int>(key & 0xFFU)];
+      key >>= 8U;
+    }
+  }
+
+  // Sort the (key, index) pairs by each digit, from least to most significant,
+  // alternating between two pairs of buffers.
+  Vector<U> keys(begin, end);
+  Vector<U> keys_tmp(n);
+  Vector<Int> perm_tmp(n);
+  Int * perm = perm_begin;
+  Int * perm_out = perm_tmp.data();
+  U * k = keys.data();
+  U * k_out = keys_tmp.data();
+  Int offsets[num_buckets];
+  for (Int d = 0; d < num_digits; ++d) {
+    Int const * const count = counts.data() + d * num_buckets;
+    auto const shift = static_cast<U>(8 * d);
+    // Skip the digit if it is the same for every key.
+    if (count[static_cast<Int>((k[0] >> shift) & 0xFFU)] == n) {
+      continue;
+    }
+    Int sum = 0;
+    for (Int b = 0; b < num_buckets; ++b) {
+      offsets[b] = sum;
+      sum += count[b];
+    }
+    for (Int i = 0; i < n; ++i) {
+      Int const j = offsets[static_cast<Int>((k[i] >> shift) & 0xFFU)]++;
+      k_out[j] = k[i];
+      perm_out[j] = perm[i];
+    }
+    um2::swap(k, k_out);
+    um2::swap(perm, perm_out);
+  }
+
+  // If the sorted permutation ended up in the temporary buffer, copy it back.
+  if (perm != perm_begin) {
+    for (Int i = 0; i < n; ++i) {
+      perm_begin[i] = perm[i];
+    }
+  }
+}
+
+} // namespace um2
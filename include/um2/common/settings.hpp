@@ -48,12 +48,44 @@ namespace defaults
 {
 String const LIBRARY_PATH = MPACT_DATA_DIR;
 String const LIBRARY_NAME = "mpact51g_71_v4.2m5_12062016_sph.fmt";
+inline constexpr bool use_library_cache = true;
 } // namespace defaults
 
 // Global settings
 extern String library_path;
 extern String library_name;
+// Load libraries from, and save them to, a binary cache next to the library
+// file. See XSLibrary.
+extern bool use_library_cache;
 
 } // namespace um2::settings::xs
 
+//==============================================================================
+// MESH
+//==============================================================================
+
+namespace um2
+{
+
+// The space-filling curve used to order the vertices and faces of a mesh.
+enum class SpaceFillingCurve : int8_t {
+  Morton = 0, // Z-order curve. Cheaper to encode.
+  Hilbert = 1 // No jumps at quadrant boundaries. Better locality.
+};
+
+} // namespace um2
+
+namespace um2::settings::mesh
+{
+
+namespace defaults
+{
+inline constexpr SpaceFillingCurve space_filling_curve = SpaceFillingCurve::Morton;
+} // namespace defaults
+
+// Global settings
+extern SpaceFillingCurve space_filling_curve;
+
+} // namespace um2::settings::mesh
+
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <um2/common/permutation.hpp>
+#include <um2/common/radix_sort.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/math/hilbert.hpp>
+#include <um2/stdlib/algorithm/clamp.hpp>
+#include <um2/stdlib/vector.hpp>
+
+//==============================================================================
+// Hilbert sorting
+//==============================================================================
+// Sort 2D points along the Hilbert curve. The interface mirrors the Morton
+// sort in morton_sort_points.hpp: each point is encoded once into a key of type
+// MortonKey<T>, then the (key, index) pairs are radix sorted.
+
+namespace um2
+{
+
+//==============================================================================
+// hilbertKeys
+//==============================================================================
+// Compute the Hilbert index of each point in [begin, end). The point p is
+// mapped to the unit square by (p - origin) * scale, clamped to [0, 1] to guard
+// against round-off. The keys are computed in parallel with OpenMP.
+
+template <class T>
+void
+hilbertKeys(Point2<T> const * begin, Point2<T> const * end, MortonKey<T> * keys,
+            Point2<T> const & origin, Vec2<T> const & scale) noexcept
+{
+  auto const n = static_cast<Int>(end - begin);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = 0; i < n; ++i) {
+    Point2<T> p = (begin[i] - origin) * scale;
+    p[0] = um2::clamp(p[0], static_cast<T>(0), static_cast<T>(1));
+    p[1] = um2::clamp(p[1], static_cast<T>(0), static_cast<T>(1));
+    keys[i] = hilbertEncode<MortonKey<T>, T>(p[0], p[1]);
+  }
+}
+
+//==============================================================================
+// hilbertSortPermutation
+//==============================================================================
+// Create a permutation that sorts [begin, end) when applied. [begin, end) is
+// not modified. The points are mapped to the unit square by
+// (p - origin) * scale before sorting. If origin and scale are not provided,
+// the points are assumed to be in the unit square.
+
+template <class T>
+void
+hilbertSortPermutation(Point2<T> const * begin, Point2<T> const * end,
+                       Int * perm_begin, Point2<T> const & origin,
+                       Vec2<T> const & scale) noexcept
+{
+  ASSERT(scale.squaredNorm() > epsDistance2<T>());
+  auto const n = static_cast<Int>(end - begin);
+  Vector<MortonKey<T>> keys(n);
+  hilbertKeys(begin, end, keys.data(), origin, scale);
+  radixSortPermutation(keys.cbegin(), keys.cend(), perm_begin);
+}
+
+template <class T>
+void
+hilbertSortPermutation(Point2<T> const * begin, Point2<T> const * end,
+                       Int * perm_begin) noexcept
+{
+  hilbertSortPermutation(begin, end, perm_begin, Point2<T>::zero(),
+                         Vec2<T>(static_cast<T>(1), static_cast<T>(1)));
+}
+
+//==============================================================================
+// hilbertSort
+//==============================================================================
+// Sort the points in the unit square [begin, end) along the Hilbert curve.
+
+template <class T>
+void
+hilbertSort(Point2<T> * const begin, Point2<T> * const end) noexcept
+{
+  Vector<Int> perm(static_cast<Int>(end - begin));
+  hilbertSortPermutation<T>(begin, end, perm.data());
+  applyPermutation(begin, end, perm.data());
+}
+
+} // namespace um2
@@ -2,6 +2,7 @@
 
 #include <um2/geometry/polytope.hpp>
 #include <um2/geometry/ray.hpp>
+#include <um2/geometry/ray_packet.hpp>
 #include <um2/math/mat.hpp>
 #include <um2/stdlib/algorithm/clamp.hpp>
 #include <um2/stdlib/math/roots.hpp>
@@ -116,6 +117,16 @@ public:
   intersect(Ray2<T> ray, T * buffer) const noexcept -> Int
     requires(D == 2);
 
+  // Intersect each ray of the packet with the segment.
+  // The ray coordinate of the k-th ray is stored in r[k], whether or not the
+  // ray intersects the segment. Returns a bit mask, in which the k-th bit is
+  // set if the k-th ray intersects the segment. Equivalent to calling
+  // intersect(Ray2, T *) on each ray.
+  template <Int K>
+  HOSTDEV [[nodiscard]] constexpr auto
+  intersect(RayPacket2<K, T> const & packet, Vec<K, T> & r) const noexcept -> uint32_t
+    requires(D == 2);
+
 }; // LineSegment
 
 //==============================================================================
@@ -368,4 +379,36 @@ LineSegment<D, T>::intersect(Ray2<T> const ray, T * const buffer) const noexcept
   return (0 <= s && s <= 1 && 0 <= r) ? 1 : 0;
 }
 
+// Since the rays share a direction, the denominator z is the same for every ray
+// in the packet. Only the numerators vary, which are computed lane by lane with
+// the same Kahan determinant as Vec2::cross. The lane loops have a fixed trip
+// count and no branches, so they are vectorized, and each lane is bitwise
+// identical to the single ray intersection.
+template <Int D, class T>
+template <Int K>
+HOSTDEV constexpr auto
+LineSegment<D, T>::intersect(RayPacket2<K, T> const & packet,
+                             Vec<K, T> & r) const noexcept -> uint32_t
+  requires(D == 2)
+{
+  static_assert(K <= 32, "The packet must fit in the 32-bit mask");
+  Vec2<T> const v = _v[1] - _v[0];
+  Vec2<T> const d = packet.direction();
+  T const z = v.cross(d);
+  Vec<K, T> const ux = packet.originX() - _v[0][0];
+  Vec<K, T> const uy = packet.originY() - _v[0][1];
+  Vec<K, T> s;
+  for (Int k = 0; k < K; ++k) {
+    s[k] = det2x2(ux[k], uy[k], d[0], d[1]) / z;
+    r[k] = det2x2(ux[k], uy[k], v[0], v[1]) / z;
+  }
+  uint32_t mask = 0;
+  for (Int k = 0; k < K; ++k) {
+    if (0 <= s[k] && s[k] <= 1 && 0 <= r[k]) {
+      mask |= 1U << static_cast<uint32_t>(k);
+    }
+  }
+  return mask;
+}
+
 } // namespace um2
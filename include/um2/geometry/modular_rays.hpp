@@ -43,6 +43,11 @@ public:
   // s: Target ray spacing
   HOSTDEV constexpr ModularRayParams(T a, T s, AxisAlignedBox2<T> box) noexcept;
 
+  // Restore parameters which were previously computed, e.g. when reading them
+  // from a file.
+  HOSTDEV constexpr ModularRayParams(AxisAlignedBox2<T> box, Vec2I num_rays,
+                                     Vec2<T> spacing, Vec2<T> direction) noexcept;
+
   //============================================================================
   // Methods
   //============================================================================
@@ -64,6 +69,9 @@ public:
 
   PURE HOSTDEV [[nodiscard]] constexpr auto
   getDirection() const noexcept -> Vec2<T>;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getBox() const noexcept -> AxisAlignedBox2<T>;
 };
 
 //==============================================================================
@@ -105,6 +113,20 @@ HOSTDEV constexpr ModularRayParams<T>::ModularRayParams(
   _direction[1] = um2::sin(a_eff);
 }
 
+template <class T>
+HOSTDEV constexpr ModularRayParams<T>::ModularRayParams(AxisAlignedBox2<T> const box,
+                                                        Vec2I const num_rays,
+                                                        Vec2<T> const spacing,
+                                                        Vec2<T> const direction) noexcept
+    : _box(box),
+      _num_rays(num_rays),
+      _spacing(spacing),
+      _direction(direction)
+{
+  ASSERT(_num_rays[0] > 0);
+  ASSERT(_num_rays[1] > 0);
+}
+
 //==============================================================================
 // Methods
 //==============================================================================
@@ -197,4 +219,11 @@ ModularRayParams<T>::getDirection() const noexcept -> Vec2<T>
   return _direction;
 }
 
+template <class T>
+HOSTDEV constexpr auto
+ModularRayParams<T>::getBox() const noexcept -> AxisAlignedBox2<T>
+{
+  return _box;
+}
+
 } // namespace um2
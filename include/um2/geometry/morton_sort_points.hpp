@@ -1,10 +1,13 @@
 #pragma once
 
+#include <um2/common/permutation.hpp>
+#include <um2/common/radix_sort.hpp>
 #include <um2/geometry/point.hpp>
 #include <um2/math/morton.hpp>
-#include <um2/stdlib/numeric/iota.hpp>
+#include <um2/stdlib/algorithm/clamp.hpp>
+#include <um2/stdlib/vector.hpp>
 
-#include <algorithm>
+#include <type_traits> // std::conditional_t
 
 //==============================================================================
 // Morton encoding/decoding
@@ -17,6 +20,10 @@
 //
 // On CPU, the double -> uint64_t mapping is used is approximately as performant
 // as double -> uint32_t, but provides a more accurate sorting of points
+//
+// Sorting encodes each point once into a MortonKey, then radix sorts the
+// (key, index) pairs. MortonKey<double> is 64 bits, so with UM2_ENABLE_FLOAT64
+// points are resolved to 2^-32 (2D) of the unit square, rather than 2^-16.
 
 namespace um2
 {
@@ -58,32 +65,59 @@ mortonLess(Point<D, T> const & lhs, Point<D, T> const & rhs) noexcept -> bool
   return mortonEncode(lhs) < mortonEncode(rhs);
 }
 
+// The Morton code used to sort points with coordinates of type T.
+template <class T>
+using MortonKey = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+
+//==============================================================================
+// mortonKeys
+//==============================================================================
+// Compute the Morton key of each point in [begin, end). The point p is mapped
+// to the unit square/cube by (p - origin) * scale, clamped to [0, 1] to guard
+// against round-off. The keys are computed in parallel with OpenMP.
+
 template <Int D, class T>
 void
-mortonSort(Point<D, T> * const begin, Point<D, T> * const end) noexcept
+mortonKeys(Point<D, T> const * begin, Point<D, T> const * end, MortonKey<T> * keys,
+           Point<D, T> const & origin, Vec<D, T> const & scale) noexcept
 {
-  std::sort(begin, end, mortonLess<D, T>);
+  static_assert(D == 2 || D == 3);
+  auto const n = static_cast<Int>(end - begin);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = 0; i < n; ++i) {
+    Point<D, T> p = (begin[i] - origin) * scale;
+    for (Int d = 0; d < D; ++d) {
+      p[d] = um2::clamp(p[d], static_cast<T>(0), static_cast<T>(1));
+    }
+    if constexpr (D == 2) {
+      keys[i] = mortonEncode<MortonKey<T>, T>(p[0], p[1]);
+    } else {
+      keys[i] = mortonEncode<MortonKey<T>, T>(p[0], p[1], p[2]);
+    }
+  }
 }
 
 //==============================================================================
-// sortPermutation
+// mortonSortPermutation
 //==============================================================================
 // Create a permutation that sorts [begin, end) when applied. [begin, end) is
-// not modified. scale is used to scale the points to the unit square/cube
-// before sorting. If the argument is not provided, the points are assumed to
-// be in the unit square/cube.
+// not modified. The points are mapped to the unit square/cube by
+// (p - origin) * scale before sorting. If origin and scale are not provided,
+// the points are assumed to be in the unit square/cube.
 
 template <Int D, class T>
 void
 mortonSortPermutation(Point<D, T> const * begin, Point<D, T> const * end,
-                      Int * perm_begin) noexcept
-
+                      Int * perm_begin, Point<D, T> const & origin,
+                      Vec<D, T> const & scale) noexcept
 {
-  auto const n = end - begin;
-  um2::iota(perm_begin, perm_begin + n, 0);
-  std::sort(perm_begin, perm_begin + n, [&](Int const i, Int const j) {
-    return mortonEncode(begin[i]) < mortonEncode(begin[j]);
-  });
+  ASSERT(scale.squaredNorm() > epsDistance2<T>());
+  auto const n = static_cast<Int>(end - begin);
+  Vector<MortonKey<T>> keys(n);
+  mortonKeys(begin, end, keys.data(), origin, scale);
+  radixSortPermutation(keys.cbegin(), keys.cend(), perm_begin);
 }
 
 template <Int D, class T>
@@ -91,11 +125,33 @@ void
 mortonSortPermutation(Point<D, T> const * begin, Point<D, T> const * end,
                       Int * perm_begin, Vec<D, T> const scale) noexcept
 {
-  auto const n = end - begin;
-  um2::iota(perm_begin, perm_begin + n, 0);
-  ASSERT(scale.squaredNorm() > epsDistance2<T>());
-  std::sort(perm_begin, perm_begin + n, [&](Int const i, Int const j) {
-    return mortonEncode(begin[i] * scale) < mortonEncode(begin[j] * scale);
-  });
+  mortonSortPermutation(begin, end, perm_begin, Point<D, T>::zero(), scale);
+}
+
+template <Int D, class T>
+void
+mortonSortPermutation(Point<D, T> const * begin, Point<D, T> const * end,
+                      Int * perm_begin) noexcept
+{
+  Vec<D, T> scale;
+  for (Int d = 0; d < D; ++d) {
+    scale[d] = 1;
+  }
+  mortonSortPermutation(begin, end, perm_begin, Point<D, T>::zero(), scale);
+}
+
+//==============================================================================
+// mortonSort
+//==============================================================================
+// Sort the points in the unit square/cube [begin, end) by Morton code.
+
+template <Int D, class T>
+void
+mortonSort(Point<D, T> * const begin, Point<D, T> * const end) noexcept
+{
+  Vector<Int> perm(static_cast<Int>(end - begin));
+  mortonSortPermutation<D, T>(begin, end, perm.data());
+  applyPermutation(begin, end, perm.data());
 }
+
 } // namespace um2
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <um2/geometry/polytope.hpp>
+#include <um2/geometry/ray_packet.hpp>
 #include <um2/stdlib/numbers.hpp>
 
 //==============================================================================
@@ -17,6 +18,7 @@
 //  - contains(Point2)
 //  - meanChordLength
 //  - intersect(Ray2)
+//  - intersect(RayPacket2) (linear polygons only)
 //  - hasSelfIntersection (quadratic polygons only)
 //  - fixSelfIntersection (quadratic polygons only)
 
@@ -261,6 +263,31 @@ intersect(PlanarPolygon<P, N, T> const & poly, Ray2<T> const & ray,
   return hits;
 }
 
+// Intersect each ray of the packet with the polygon.
+// The coordinates of the k-th ray are appended to buffer + k * stride, after the
+// hits[k] coordinates already stored there, and hits[k] is incremented by the
+// number of intersections. As with intersect(Ray2), a coordinate may be written
+// one past the last intersection, so each ray needs room for N coordinates.
+// Returns a bit mask, in which the k-th bit is set if the k-th ray intersects
+// the polygon.
+template <Int N, class T, Int K>
+HOSTDEV constexpr auto
+intersect(PlanarLinearPolygon<N, T> const & poly, RayPacket2<K, T> const & packet,
+          T * const buffer, Int const stride, Int * const hits) noexcept -> uint32_t
+{
+  uint32_t any = 0;
+  Vec<K, T> r;
+  for (Int i = 0; i < N; ++i) {
+    uint32_t const mask = poly.getEdge(i).intersect(packet, r);
+    for (Int k = 0; k < K; ++k) {
+      buffer[k * stride + hits[k]] = r[k];
+      hits[k] += static_cast<Int>((mask >> static_cast<uint32_t>(k)) & 1U);
+    }
+    any |= mask;
+  }
+  return any;
+}
+
 //==============================================================================
 // hasSelfIntersection
 //==============================================================================
@@ -152,6 +152,13 @@ template <Int D, class T>
 PURE HOSTDEV constexpr auto
 isStraight(QuadraticSegment<D, T> const & q) noexcept -> bool;
 
+// Intersect the ray with the quadratic segment Q(r) = C + rB + r²A, given the
+// coefficients {C, B, A} from getPolyCoeffs. Equivalent to
+// QuadraticSegment::intersect, for callers which cache the coefficients.
+template <class T>
+HOSTDEV constexpr auto
+intersect(Vec<3, Vec2<T>> const & coeffs, Ray2<T> ray, T * buffer) noexcept -> Int;
+
 // The area enclosed by the segment and the straight line from the p0 to p1.
 template <class T>
 PURE HOSTDEV constexpr auto
@@ -664,14 +671,11 @@ QuadraticSegment<D, T>::isLeft(Point2<T> const p) const noexcept -> bool
 // r = [(C - O) + s(B + sA)] ⋅ D
 // r is valid if 0 ≤ r ≤ ∞
 
-template <Int D, class T>
+template <class T>
 HOSTDEV constexpr auto
-QuadraticSegment<D, T>::intersect(Ray2<T> const ray,
-                                  T * const buffer) const noexcept -> Int
-  requires(D == 2)
+intersect(Vec<3, Vec2<T>> const & coeffs, Ray2<T> const ray, T * const buffer) noexcept
+    -> Int
 {
-  auto const coeffs = getPolyCoeffs();
-
   Vec2<T> const vc = coeffs[0];
   Vec2<T> const vb = coeffs[1];
   Vec2<T> const va = coeffs[2];
@@ -700,6 +704,15 @@ QuadraticSegment<D, T>::intersect(Ray2<T> const ray,
   return hits;
 }
 
+template <Int D, class T>
+HOSTDEV constexpr auto
+QuadraticSegment<D, T>::intersect(Ray2<T> const ray,
+                                  T * const buffer) const noexcept -> Int
+  requires(D == 2)
+{
+  return um2::intersect(getPolyCoeffs(), ray, buffer);
+}
+
 //==============================================================================
 // intersect (QuadraticSegment)
 //==============================================================================
@@ -128,6 +128,13 @@ public:
   intersect(Ray2<T> ray, T * buffer) const noexcept -> Int
     requires(D == 2);
 
+  // See intersect(PlanarLinearPolygon, RayPacket2, ...) in polygon.hpp.
+  template <Int K>
+  HOSTDEV constexpr auto
+  intersect(RayPacket2<K, T> const & packet, T * buffer, Int stride,
+            Int * hits) const noexcept -> uint32_t
+    requires(D == 2);
+
 }; // Quadrilateral
 
 //==============================================================================
@@ -417,4 +424,14 @@ Quadrilateral<D, T>::intersect(Ray2<T> const ray, T * buffer) const noexcept ->
   return um2::intersect(*this, ray, buffer);
 }
 
+template <Int D, class T>
+template <Int K>
+HOSTDEV constexpr auto
+Quadrilateral<D, T>::intersect(RayPacket2<K, T> const & packet, T * buffer,
+                               Int const stride, Int * hits) const noexcept -> uint32_t
+  requires(D == 2)
+{
+  return um2::intersect(*this, packet, buffer, stride, hits);
+}
+
 } // namespace um2
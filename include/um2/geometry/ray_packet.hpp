@@ -0,0 +1,101 @@
+#pragma once
+
+#include <um2/common/cast_if_not.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/stdlib/math/abs.hpp>
+
+//==============================================================================
+// RAY PACKET
+//==============================================================================
+// A packet of K 2D rays with a common direction, such as K adjacent modular
+// rays of the same angle. The origins are stored as a Vec of x-coordinates and
+// a Vec of y-coordinates, so that intersection kernels can process all K rays
+// at once with the SIMD vector types of Vec (see UM2_ENABLE_SIMD_VEC).
+//
+// K should be a power of 2 (4 or 8 for float, 2 or 4 for double) to map onto a
+// hardware vector register.
+
+namespace um2
+{
+
+template <Int K, class T>
+class RayPacket2
+{
+
+  Vec<K, T> _ox; // x-coordinates of the origins
+  Vec<K, T> _oy; // y-coordinates of the origins
+  Vec2<T> _d;    // common direction (unit vector)
+
+public:
+  //============================================================================
+  // Constructors
+  //============================================================================
+
+  constexpr RayPacket2() noexcept = default;
+
+  HOSTDEV constexpr RayPacket2(Vec<K, T> const & ox, Vec<K, T> const & oy,
+                               Vec2<T> const & direction) noexcept
+      : _ox(ox),
+        _oy(oy),
+        _d(direction)
+  {
+    // Check that the direction is a unit vector
+    ASSERT(um2::abs(direction.squaredNorm() - static_cast<T>(1)) < castIfNot<T>(1e-5));
+  }
+
+  // Gather K rays, which must share the same direction.
+  HOSTDEV explicit constexpr RayPacket2(Ray2<T> const * rays) noexcept
+      : _d(rays[0].direction())
+  {
+    for (Int k = 0; k < K; ++k) {
+      ASSERT(rays[k].direction().isApprox(_d));
+      _ox[k] = rays[k].origin()[0];
+      _oy[k] = rays[k].origin()[1];
+    }
+  }
+
+  //============================================================================
+  // Accessors
+  //============================================================================
+
+  PURE HOSTDEV [[nodiscard]] static constexpr auto
+  size() noexcept -> Int
+  {
+    return K;
+  }
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  originX() const noexcept -> Vec<K, T> const &
+  {
+    return _ox;
+  }
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  originY() const noexcept -> Vec<K, T> const &
+  {
+    return _oy;
+  }
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  direction() const noexcept -> Vec2<T> const &
+  {
+    return _d;
+  }
+
+  //============================================================================
+  // Other member functions
+  //============================================================================
+
+  // The k-th ray of the packet
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getRay(Int k) const noexcept -> Ray2<T>
+  {
+    ASSERT(0 <= k);
+    ASSERT(k < K);
+    return {Point2<T>(_ox[k], _oy[k]), _d};
+  }
+
+}; // class RayPacket2
+
+} // namespace um2
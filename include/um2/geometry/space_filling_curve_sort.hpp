@@ -0,0 +1,51 @@
+#pragma once
+
+#include <um2/common/logger.hpp>
+#include <um2/common/settings.hpp>
+#include <um2/geometry/hilbert_sort_points.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
+
+//==============================================================================
+// Space-filling curve sorting
+//==============================================================================
+// Sort 2D points along the space-filling curve selected at runtime, by default
+// settings::mesh::space_filling_curve.
+
+namespace um2
+{
+
+// Create a permutation that sorts [begin, end) along the curve when applied.
+// The points are mapped to the unit square by (p - origin) * scale.
+template <class T>
+void
+spaceFillingCurveSortPermutation(SpaceFillingCurve const curve,
+                                 Point2<T> const * begin, Point2<T> const * end,
+                                 Int * perm_begin, Point2<T> const & origin,
+                                 Vec2<T> const & scale) noexcept
+{
+  switch (curve) {
+  case SpaceFillingCurve::Morton:
+    mortonSortPermutation(begin, end, perm_begin, origin, scale);
+    break;
+  case SpaceFillingCurve::Hilbert:
+    hilbertSortPermutation(begin, end, perm_begin, origin, scale);
+    break;
+  default:
+    logger::error("Unknown space-filling curve");
+  }
+}
+
+// Sort the points in the unit square [begin, end) along the curve.
+template <class T>
+void
+spaceFillingCurveSort(Point2<T> * const begin, Point2<T> * const end,
+                      SpaceFillingCurve const curve =
+                          settings::mesh::space_filling_curve) noexcept
+{
+  Vector<Int> perm(static_cast<Int>(end - begin));
+  spaceFillingCurveSortPermutation(curve, begin, end, perm.data(), Point2<T>::zero(),
+                                   Vec2<T>(static_cast<T>(1), static_cast<T>(1)));
+  applyPermutation(begin, end, perm.data());
+}
+
+} // namespace um2
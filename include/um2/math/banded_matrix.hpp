@@ -0,0 +1,502 @@
+#pragma once
+
+#include <um2/config.hpp>
+#include <um2/math/matrix.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/algorithm/min.hpp>
+#include <um2/stdlib/assert.hpp>
+#include <um2/stdlib/utility/move.hpp>
+#include <um2/stdlib/vector.hpp>
+
+//==============================================================================
+// BANDED MATRIX
+//==============================================================================
+// A matrix with dynamic size which stores a contiguous band of columns in each
+// row, [first(i), last(i)), and treats every entry outside the band as zero.
+// The bands of different rows are independent, so this is a variable-bandwidth
+// (skyline) row storage:
+//  - _values[_offsets[i] + j - _first[i]] is entry (i, j) for j in the band
+//  - _offsets[i + 1] - _offsets[i] is the width of the band of row i
+//
+// Multi-group scattering matrices are the intended use: entry (i, j) is the
+// scattering from group j into group i, and is zero unless j is within a few
+// groups of i, apart from limited upscatter. Hence, storing the band of each
+// row takes a fraction of the memory of a dense matrix, and a matrix-vector
+// product is a contiguous dot product per row.
+//
+// Writing outside the band of a row widens the band, which moves the values of
+// all later rows. Build matrices from a dense matrix, or widen each row once
+// before writing it, rather than writing entries one at a time.
+
+namespace um2
+{
+
+template <class T>
+class BandedMatrix
+{
+  Int _rows = 0;
+  Int _cols = 0;
+  Vector<Int> _first;   // The first column of the band of each row. size = rows
+  Vector<Int> _offsets; // The offset of each row in _values. size = rows + 1
+  Vector<T> _values;
+
+  // Widen the band of each row i to include [lo[i], hi[i]).
+  void
+  widen(Int const * lo, Int const * hi) noexcept;
+
+public:
+  //==============================================================================
+  // Constructors
+  //==============================================================================
+
+  constexpr BandedMatrix() noexcept = default;
+
+  // The zero matrix. Every band is empty.
+  BandedMatrix(Int rows, Int cols) noexcept;
+
+  // Store each row of the dense matrix from its first to its last nonzero.
+  explicit BandedMatrix(Matrix<T> const & dense) noexcept;
+
+  //==============================================================================
+  // Accessors
+  //==============================================================================
+
+  PURE [[nodiscard]] constexpr auto
+  rows() const noexcept -> Int
+  {
+    return _rows;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  cols() const noexcept -> Int
+  {
+    return _cols;
+  }
+
+  // The number of stored entries, including any zeros within the bands.
+  PURE [[nodiscard]] constexpr auto
+  numStored() const noexcept -> Int
+  {
+    return _values.size();
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  rowFirst(Int i) const noexcept -> Int
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _rows);
+    return _first[i];
+  }
+
+  // One past the last column of the band of row i.
+  PURE [[nodiscard]] constexpr auto
+  rowLast(Int i) const noexcept -> Int
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _rows);
+    return _first[i] + _offsets[i + 1] - _offsets[i];
+  }
+
+  // The values of the band of row i, starting at column rowFirst(i).
+  PURE [[nodiscard]] constexpr auto
+  rowData(Int i) noexcept -> T *
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _rows);
+    return _values.data() + _offsets[i];
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  rowData(Int i) const noexcept -> T const *
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _rows);
+    return _values.data() + _offsets[i];
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  rowFirsts() const noexcept -> Vector<Int> const &
+  {
+    return _first;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  offsets() const noexcept -> Vector<Int> const &
+  {
+    return _offsets;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  values() const noexcept -> Vector<T> const &
+  {
+    return _values;
+  }
+
+  // Entry (i, j), which is zero outside the band of row i.
+  PURE [[nodiscard]] constexpr auto
+  operator()(Int i, Int j) const noexcept -> T
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _rows);
+    ASSERT_ASSUME(0 <= j);
+    ASSERT(j < _cols);
+    Int const k = j - _first[i];
+    if (k < 0 || k >= _offsets[i + 1] - _offsets[i]) {
+      return static_cast<T>(0);
+    }
+    return _values[_offsets[i] + k];
+  }
+
+  //==============================================================================
+  // Modifiers
+  //==============================================================================
+
+  // Widen the band of row i to include the columns [lo, hi). New entries
+  // are zero.
+  void
+  widenRow(Int i, Int lo, Int hi) noexcept;
+
+  // Widen the bands to include the bands of other.
+  void
+  widen(BandedMatrix const & other) noexcept;
+
+  // Set entry (i, j), widening the band of row i if necessary.
+  void
+  set(Int i, Int j, T value) noexcept;
+
+  // Replace the storage. Returns false, leaving the matrix unchanged, if the
+  // arrays do not describe valid bands of a rows by cols matrix.
+  auto
+  setStorage(Int rows, Int cols, Vector<Int> first, Vector<Int> offsets,
+             Vector<T> values) noexcept -> bool;
+
+  auto
+  operator*=(T scalar) noexcept -> BandedMatrix &;
+
+  // this += a * x
+  void
+  addScaled(T a, BandedMatrix const & x) noexcept;
+
+  // this += a * (x0 + d * (x1 - x0)), the linear interpolation between x0 and x1.
+  void
+  addInterp(T a, T d, BandedMatrix const & x0, BandedMatrix const & x1) noexcept;
+
+  //==============================================================================
+  // Methods
+  //==============================================================================
+
+  // y = A * x, where x has size cols() and y has size rows().
+  void
+  multiply(T const * x, T * y) const noexcept;
+
+  // The sum of each column. sums has size cols().
+  void
+  columnSums(T * sums) const noexcept;
+
+  PURE [[nodiscard]] auto
+  sum() const noexcept -> T;
+
+  [[nodiscard]] auto
+  toDense() const noexcept -> Matrix<T>;
+};
+
+//==============================================================================
+// Constructors
+//==============================================================================
+
+template <class T>
+BandedMatrix<T>::BandedMatrix(Int const rows, Int const cols) noexcept
+    : _rows(rows),
+      _cols(cols),
+      _first(rows, 0),
+      _offsets(rows + 1, 0)
+{
+  ASSERT(rows >= 0);
+  ASSERT(cols >= 0);
+}
+
+template <class T>
+BandedMatrix<T>::BandedMatrix(Matrix<T> const & dense) noexcept
+    : BandedMatrix(dense.rows(), dense.cols())
+{
+  // Find the band of each row, then copy it.
+  Int num_stored = 0;
+  for (Int i = 0; i < _rows; ++i) {
+    Int lo = _cols;
+    Int hi = 0;
+    for (Int j = 0; j < _cols; ++j) {
+      // Exact zeros are not stored
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+      // NOLINTNEXTLINE(clang-diagnostic-float-equal)
+      if (dense(i, j) != static_cast<T>(0)) {
+        lo = um2::min(lo, j);
+        hi = j + 1;
+      }
+#pragma GCC diagnostic pop
+    }
+    if (hi == 0) {
+      lo = 0;
+    }
+    _first[i] = lo;
+    _offsets[i] = num_stored;
+    num_stored += hi - lo;
+  }
+  _offsets[_rows] = num_stored;
+  _values.resize(num_stored);
+  for (Int i = 0; i < _rows; ++i) {
+    T * row = _values.data() + _offsets[i];
+    Int const width = _offsets[i + 1] - _offsets[i];
+    for (Int k = 0; k < width; ++k) {
+      row[k] = dense(i, _first[i] + k);
+    }
+  }
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+
+template <class T>
+void
+BandedMatrix<T>::widen(Int const * lo, Int const * hi) noexcept
+{
+  // Only move the values if some band actually grows.
+  bool grows = false;
+  for (Int i = 0; i < _rows; ++i) {
+    if (lo[i] < hi[i] && (lo[i] < _first[i] || hi[i] > rowLast(i) ||
+                          _offsets[i] == _offsets[i + 1])) {
+      grows = true;
+      break;
+    }
+  }
+  if (!grows) {
+    return;
+  }
+  Vector<Int> new_first(_rows);
+  Vector<Int> new_offsets(_rows + 1);
+  Int num_stored = 0;
+  for (Int i = 0; i < _rows; ++i) {
+    Int row_lo = lo[i];
+    Int row_hi = hi[i];
+    if (_offsets[i] != _offsets[i + 1]) {
+      if (row_lo < row_hi) {
+        row_lo = um2::min(row_lo, _first[i]);
+        row_hi = um2::max(row_hi, rowLast(i));
+      } else {
+        row_lo = _first[i];
+        row_hi = rowLast(i);
+      }
+    } else if (row_lo >= row_hi) {
+      row_lo = 0;
+      row_hi = 0;
+    }
+    new_first[i] = row_lo;
+    new_offsets[i] = num_stored;
+    num_stored += row_hi - row_lo;
+  }
+  new_offsets[_rows] = num_stored;
+  Vector<T> new_values(num_stored, static_cast<T>(0));
+  for (Int i = 0; i < _rows; ++i) {
+    T const * src = _values.data() + _offsets[i];
+    T * dst = new_values.data() + new_offsets[i] + (_first[i] - new_first[i]);
+    Int const width = _offsets[i + 1] - _offsets[i];
+    for (Int k = 0; k < width; ++k) {
+      dst[k] = src[k];
+    }
+  }
+  _first = um2::move(new_first);
+  _offsets = um2::move(new_offsets);
+  _values = um2::move(new_values);
+}
+
+template <class T>
+void
+BandedMatrix<T>::widenRow(Int const i, Int const lo, Int const hi) noexcept
+{
+  ASSERT_ASSUME(0 <= i);
+  ASSERT(i < _rows);
+  ASSERT(0 <= lo);
+  ASSERT(lo <= hi);
+  ASSERT(hi <= _cols);
+  // Cheap check for the common case of writing within the band
+  if (lo >= hi || (_offsets[i] != _offsets[i + 1] && _first[i] <= lo &&
+                   hi <= rowLast(i))) {
+    return;
+  }
+  Vector<Int> los(_rows, 0);
+  Vector<Int> his(_rows, 0);
+  los[i] = lo;
+  his[i] = hi;
+  widen(los.data(), his.data());
+}
+
+template <class T>
+void
+BandedMatrix<T>::widen(BandedMatrix const & other) noexcept
+{
+  ASSERT(other._rows == _rows);
+  ASSERT(other._cols == _cols);
+  Vector<Int> his(_rows);
+  for (Int i = 0; i < _rows; ++i) {
+    his[i] = other.rowLast(i);
+  }
+  widen(other._first.data(), his.data());
+}
+
+template <class T>
+void
+BandedMatrix<T>::set(Int const i, Int const j, T const value) noexcept
+{
+  ASSERT_ASSUME(0 <= j);
+  ASSERT(j < _cols);
+  widenRow(i, j, j + 1);
+  _values[_offsets[i] + j - _first[i]] = value;
+}
+
+template <class T>
+auto
+BandedMatrix<T>::setStorage(Int const rows, Int const cols, Vector<Int> first,
+                            Vector<Int> offsets, Vector<T> values) noexcept -> bool
+{
+  if (rows < 0 || cols < 0 || first.size() != rows || offsets.size() != rows + 1 ||
+      offsets[0] != 0 || offsets[rows] != values.size()) {
+    return false;
+  }
+  for (Int i = 0; i < rows; ++i) {
+    Int const width = offsets[i + 1] - offsets[i];
+    if (width < 0 || first[i] < 0 || first[i] + width > cols) {
+      return false;
+    }
+  }
+  _rows = rows;
+  _cols = cols;
+  _first = um2::move(first);
+  _offsets = um2::move(offsets);
+  _values = um2::move(values);
+  return true;
+}
+
+template <class T>
+auto
+BandedMatrix<T>::operator*=(T const scalar) noexcept -> BandedMatrix &
+{
+  for (auto & v : _values) {
+    v *= scalar;
+  }
+  return *this;
+}
+
+template <class T>
+void
+BandedMatrix<T>::addScaled(T const a, BandedMatrix const & x) noexcept
+{
+  widen(x);
+  for (Int i = 0; i < _rows; ++i) {
+    T const * RESTRICT src = x.rowData(i);
+    T * RESTRICT dst = rowData(i) + (x._first[i] - _first[i]);
+    Int const width = x._offsets[i + 1] - x._offsets[i];
+    for (Int k = 0; k < width; ++k) {
+      dst[k] += a * src[k];
+    }
+  }
+}
+
+template <class T>
+void
+BandedMatrix<T>::addInterp(T const a, T const d, BandedMatrix const & x0,
+                           BandedMatrix const & x1) noexcept
+{
+  ASSERT(x0._rows == x1._rows);
+  ASSERT(x0._cols == x1._cols);
+  widen(x0);
+  widen(x1);
+  T const a0 = a * (1 - d);
+  T const a1 = a * d;
+  for (Int i = 0; i < _rows; ++i) {
+    Int const width0 = x0._offsets[i + 1] - x0._offsets[i];
+    Int const width1 = x1._offsets[i + 1] - x1._offsets[i];
+    T const * RESTRICT src0 = x0.rowData(i);
+    T const * RESTRICT src1 = x1.rowData(i);
+    T * RESTRICT dst0 = rowData(i) + (x0._first[i] - _first[i]);
+    if (width0 == width1 && x0._first[i] == x1._first[i]) {
+      // The usual case: the bands match, so interpolate in one pass.
+      for (Int k = 0; k < width0; ++k) {
+        dst0[k] += a * (src0[k] + d * (src1[k] - src0[k]));
+      }
+    } else {
+      T * RESTRICT dst1 = rowData(i) + (x1._first[i] - _first[i]);
+      for (Int k = 0; k < width0; ++k) {
+        dst0[k] += a0 * src0[k];
+      }
+      for (Int k = 0; k < width1; ++k) {
+        dst1[k] += a1 * src1[k];
+      }
+    }
+  }
+}
+
+//==============================================================================
+// Methods
+//==============================================================================
+
+template <class T>
+void
+BandedMatrix<T>::multiply(T const * RESTRICT x, T * RESTRICT y) const noexcept
+{
+  for (Int i = 0; i < _rows; ++i) {
+    T const * RESTRICT row = rowData(i);
+    T const * RESTRICT xi = x + _first[i];
+    Int const width = _offsets[i + 1] - _offsets[i];
+    T sum = 0;
+    for (Int k = 0; k < width; ++k) {
+      sum += row[k] * xi[k];
+    }
+    y[i] = sum;
+  }
+}
+
+template <class T>
+void
+BandedMatrix<T>::columnSums(T * sums) const noexcept
+{
+  for (Int j = 0; j < _cols; ++j) {
+    sums[j] = 0;
+  }
+  for (Int i = 0; i < _rows; ++i) {
+    T const * RESTRICT row = rowData(i);
+    T * RESTRICT si = sums + _first[i];
+    Int const width = _offsets[i + 1] - _offsets[i];
+    for (Int k = 0; k < width; ++k) {
+      si[k] += row[k];
+    }
+  }
+}
+
+template <class T>
+PURE auto
+BandedMatrix<T>::sum() const noexcept -> T
+{
+  T result = 0;
+  for (auto const v : _values) {
+    result += v;
+  }
+  return result;
+}
+
+template <class T>
+auto
+BandedMatrix<T>::toDense() const noexcept -> Matrix<T>
+{
+  Matrix<T> dense(_rows, _cols, static_cast<T>(0));
+  for (Int i = 0; i < _rows; ++i) {
+    T const * row = rowData(i);
+    Int const width = _offsets[i + 1] - _offsets[i];
+    for (Int k = 0; k < width; ++k) {
+      dense(i, _first[i] + k) = row[k];
+    }
+  }
+  return dense;
+}
+
+} // namespace um2
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <um2/config.hpp>
+
+#include <um2/math/morton.hpp>
+#include <um2/stdlib/assert.hpp>
+
+#include <concepts>
+
+//==============================================================================
+// HILBERT ENCODING/DECODING
+//==============================================================================
+// This file provides functions for mapping to and from 2D Hilbert curve indices.
+// https://en.wikipedia.org/wiki/Hilbert_curve
+//
+// unsigned ints:
+// hilbertEncode(u32, u32) -> u32
+// hilbertEncode(u64, u64) -> u64
+//
+// floating point (normalized to [0,1]):
+// hilbertEncode(f32, f32) -> u32
+// hilbertEncode(f64, f64) -> u64
+//
+// Like the Morton (Z-order) curve, the Hilbert curve visits every cell of a
+// 2^b by 2^b grid, where b = 4 * sizeof(U). Unlike the Morton curve, consecutive
+// cells along the Hilbert curve are always adjacent, so there are no long jumps
+// at quadrant boundaries. Points which are close along the curve are therefore
+// more likely to be close in space, at the cost of a more expensive encoding:
+// one iteration per bit of each coordinate, rather than a single pdep.
+//
+// The curve starts at (0, 0) and ends at (2^b - 1, 0).
+
+namespace um2
+{
+
+//==============================================================================
+// Maximum coordinate values
+//==============================================================================
+
+template <std::unsigned_integral U>
+inline constexpr U max_2d_hilbert_coord = max_2d_morton_coord<U>;
+
+//==============================================================================
+// Hilbert encoding/decoding
+//==============================================================================
+
+// Encode 2D coordinate to Hilbert index
+template <std::unsigned_integral U>
+PURE HOSTDEV constexpr auto
+hilbertEncode(U x, U y) noexcept -> U
+{
+  ASSERT_ASSUME(x <= max_2d_hilbert_coord<U>);
+  ASSERT_ASSUME(y <= max_2d_hilbert_coord<U>);
+  U d = 0;
+  for (U s = static_cast<U>(1) << (4 * sizeof(U) - 1); s > 0; s >>= 1U) {
+    U const rx = (x & s) > 0 ? 1 : 0;
+    U const ry = (y & s) > 0 ? 1 : 0;
+    d += s * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant so that the sub-curve has the canonical orientation.
+    // Only the bits below s matter from here on.
+    if (ry == 0) {
+      if (rx == 1) {
+        x ^= s - 1;
+        y ^= s - 1;
+      }
+      U const t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
+
+// Decode the Hilbert index to 2D coordinates
+template <std::unsigned_integral U>
+HOSTDEV constexpr void
+hilbertDecode(U const d, U & x, U & y) noexcept
+{
+  x = 0;
+  y = 0;
+  U t = d;
+  U constexpr n = static_cast<U>(1) << (4 * sizeof(U) - 1);
+  for (U s = 1; s != 0 && s <= n; s <<= 1U) {
+    U const rx = 1 & (t >> 1U);
+    U const ry = 1 & (t ^ rx);
+    // Undo the rotation of the quadrant.
+    if (ry == 0) {
+      if (rx == 1) {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      U const tmp = x;
+      x = y;
+      y = tmp;
+    }
+    x += s * rx;
+    y += s * ry;
+    t >>= 2U;
+  }
+}
+
+//==============================================================================
+// Hilbert encoding/decoding floats (normalized to [0,1])
+//==============================================================================
+
+// Encode 2D floating point coordinate in [0,1] x [0,1] to U Hilbert index
+template <std::unsigned_integral U, std::floating_point T>
+PURE HOSTDEV auto
+hilbertEncode(T const x, T const y) noexcept -> U
+{
+  ASSERT_ASSUME(0 <= x);
+  ASSERT_ASSUME(0 <= y);
+  ASSERT_ASSUME(x <= 1);
+  ASSERT_ASSUME(y <= 1);
+  static_assert(!(std::same_as<float, T> && std::same_as<uint64_t, U>),
+                "uint64_t -> float conversion can be lossy");
+  U const x_h = static_cast<U>(x * max_2d_hilbert_coord<U>);
+  U const y_h = static_cast<U>(y * max_2d_hilbert_coord<U>);
+  return hilbertEncode(x_h, y_h);
+}
+
+// Decode U Hilbert index to a 2D floating point coordinate in [0,1] x [0,1]
+template <std::unsigned_integral U, std::floating_point T>
+HOSTDEV void
+hilbertDecode(U const d, T & x, T & y) noexcept
+{
+  U x_h;
+  U y_h;
+  hilbertDecode(d, x_h, y_h);
+  x = static_cast<T>(x_h) / static_cast<T>(max_2d_hilbert_coord<U>);
+  y = static_cast<T>(y_h) / static_cast<T>(max_2d_hilbert_coord<U>);
+}
+
+} // namespace um2
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <um2/common/settings.hpp>
 #include <um2/geometry/quadratic_quadrilateral.hpp>
 #include <um2/geometry/quadratic_triangle.hpp>
 #include <um2/geometry/quadrilateral.hpp>
@@ -43,6 +44,13 @@
 // - _fv[i] is the Vec of vertex ids of the i-th face
 // - _vf_offsets[i] is the index of the start of the i-th vertex's face list in _vf.
 //   _vf_offsets[i + 1] - _vf_offsets[i] is the number of faces to which vertex i belongs
+// - _ff[i * E + j] is the (face, edge) pair across the j-th edge of the i-th face,
+//   where E is the number of edges per face. (-1, -1) if the edge is on the
+//   boundary of the mesh.
+// - _bvh[i] is the bounding box of the i-th node of an optional bounding volume
+//   hierarchy over the faces. See populateBVH for more information.
+// - _edge_cache[i * E + j] is the optional precomputed data of the j-th edge of
+//   the i-th face of a quadratic mesh. See populateEdgeCache for more information.
 //
 // ASSUMPTIONS:
 // - Faces are oriented counter-clockwise
@@ -51,6 +59,37 @@
 namespace um2
 {
 
+// The sorted intersections of a batch of rays with a mesh, concatenated in ray
+// order. Each ray has the layout of sortRayMeshIntersections.
+//  - The faces intersected by the i-th ray are [ray_offsets[i], ray_offsets[i + 1]),
+//    ordered along the ray.
+//  - The coordinates of the j-th face are coords[coord_offsets[j]] to
+//    coords[coord_offsets[j + 1] - 1], in ascending order.
+//  - faces[j] is the ID of the j-th face.
+struct RayMeshIntersections {
+  Vector<Int> ray_offsets;
+  Vector<Int> coord_offsets;
+  Vector<Int> faces;
+  Vector<Float> coords;
+
+  PURE [[nodiscard]] constexpr auto
+  numRays() const noexcept -> Int
+  {
+    return ray_offsets.empty() ? 0 : ray_offsets.size() - 1;
+  }
+};
+
+// The data of a quadratic edge needed to intersect it with a ray.
+//  - If the edge is effectively straight (see isStraight), coeffs = {v0, v1, 0}
+//    and the edge is intersected as the line segment (v0, v1).
+//  - Otherwise, coeffs = {C, B, A} from QuadraticSegment::getPolyCoeffs.
+//  - box is the bounding box of the edge, padded by epsDistance.
+struct QuadraticEdgeCache {
+  Vec<3, Vec2F> coeffs;
+  AxisAlignedBox2F box;
+  bool is_straight = false;
+};
+
 template <Int P, Int N>
 class FaceVertexMesh
 {
@@ -63,12 +102,46 @@ public:
   using Vertex = typename Polygon<P, N, 2, Float>::Vertex;
 
 private:
-  bool _is_morton_ordered = false;
+  bool _is_curve_ordered = false; // sorted along a space-filling curve
   bool _has_vf = false;
-  Vector<Vertex> _v;       // vertices
-  Vector<FaceConn> _fv;    // face-vertex connectivity
-  Vector<Int> _vf_offsets; // index into _vf
-  Vector<Int> _vf;         // vertex-face connectivity
+  bool _has_ff = false;
+  bool _has_bvh = false;
+  bool _has_edge_cache = false;
+  Int _bvh_depth = 0;                     // depth of the leaves of the BVH
+  Vector<Vertex> _v;                      // vertices
+  Vector<FaceConn> _fv;                   // face-vertex connectivity
+  Vector<Int> _vf_offsets;                // index into _vf
+  Vector<Int> _vf;                        // vertex-face connectivity
+  Vector<Vec2I> _ff;                      // face-face connectivity (across edges)
+  Vector<Vec2I> _boundary_edges;          // (face, edge) pairs on the boundary
+  Vector<AxisAlignedBox2F> _bvh;          // bounding volume hierarchy over the faces
+  Vector<QuadraticEdgeCache> _edge_cache; // precomputed quadratic edge data
+
+  // Call f(first, last) for each range of faces [first, last) whose bounding
+  // box satisfies hits_box(box), in ascending face order.
+  template <class B, class F>
+  constexpr void
+  forEachFaceRangeIf(B && hits_box, F && f) const noexcept;
+
+  // Call f(first, last) for each range of faces [first, last) which may be
+  // intersected by the ray, in ascending face order.
+  template <class F>
+  constexpr void
+  forEachFaceRange(Ray2F ray, F && f) const noexcept;
+
+  // Same as above, for faces which may be intersected by any ray of the packet.
+  template <Int K, class F>
+  constexpr void
+  forEachFaceRange(RayPacket2<K, Float> const & packet, F && f) const noexcept;
+
+  // Intersect the ray with the i-th face or the iedge-th edge of the iface-th
+  // face, using the edge cache if it has been populated.
+  auto
+  intersectFace(Int i, Ray2F ray, Vec2F inv_dir, Float * coords) const noexcept -> Int;
+
+  auto
+  intersectEdge(Int iface, Int iedge, Ray2F ray, Vec2F inv_dir,
+                Float * coords) const noexcept -> Int;
 
 public:
   //===========================================================================
@@ -83,6 +156,18 @@ public:
 
   explicit FaceVertexMesh(PolytopeSoup const & soup, bool validate = true);
 
+  // As above, then release the memory of the soup, which is left empty.
+  // NOTE: this is not zero-copy. The vertices and the connectivity are copied,
+  // then the soup is freed, so the peak memory is the same as for the const&
+  // overload. No buffer of the soup can be reused for any N:
+  //  - the soup stores 3D points and the mesh stores 2D points.
+  //  - the soup stores the connectivity as Vector<Int>, while the mesh stores
+  //    Vector<Vec<N, Int>>. For N = 3 and 6, Vec<N, Int> is padded. For N = 4
+  //    and 8 the layout matches, but Vec<N, Int> is over-aligned, and Vector
+  //    frees its buffer with the alignment of its element type.
+  // Use it to shorten the lifetime of a large soup, not to avoid the copy.
+  explicit FaceVertexMesh(PolytopeSoup && soup, bool validate = true);
+
   //===========================================================================
   // Member access
   //===========================================================================
@@ -105,6 +190,9 @@ public:
   PURE HOSTDEV [[nodiscard]] constexpr auto
   vertexFaceConn() const noexcept -> Vector<Int> const &;
 
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  faceFaceConn() const noexcept -> Vector<Vec2I> const &;
+
   //===========================================================================
   // Capacity
   //===========================================================================
@@ -134,6 +222,11 @@ public:
   PURE HOSTDEV [[nodiscard]] constexpr auto
   getFaceConn(Int i) const noexcept -> FaceConn const &;
 
+  // The (face, edge) pair across the iedge-th edge of the iface-th face.
+  // (-1, -1) if the edge is on the boundary. Requires populateFF.
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getAdjacentFace(Int iface, Int iedge) const noexcept -> Vec2I;
+
   //===========================================================================
   // Modifiers
   //===========================================================================
@@ -147,6 +240,27 @@ public:
   constexpr void
   flipFace(Int i) noexcept;
 
+  // Sort the vertices and faces along a space-filling curve to improve the
+  // locality of mesh traversals. Any connectivity, BVH, or edge cache that the
+  // mesh had is rebuilt. Returns the permutation of the faces, as
+  // spaceFillingCurveSortFaces.
+  auto
+  spaceFillingCurveSort(
+      SpaceFillingCurve curve = settings::mesh::space_filling_curve) noexcept
+      -> Vector<Int>;
+
+  // Sort the faces by centroid. Returns the permutation which was applied: the
+  // i-th face after sorting is face perm[i] before sorting, so per-face data
+  // such as material IDs can be reordered to match.
+  auto
+  spaceFillingCurveSortFaces(
+      SpaceFillingCurve curve = settings::mesh::space_filling_curve) noexcept
+      -> Vector<Int>;
+
+  void
+  spaceFillingCurveSortVertices(
+      SpaceFillingCurve curve = settings::mesh::space_filling_curve) noexcept;
+
   void
   mortonSort() noexcept;
 
@@ -156,9 +270,47 @@ public:
   void
   mortonSortVertices() noexcept;
 
+  void
+  hilbertSort() noexcept;
+
+  void
+  hilbertSortFaces() noexcept;
+
+  void
+  hilbertSortVertices() noexcept;
+
   void
   populateVF() noexcept;
 
+  // Compute the face-face connectivity across edges. Populates the vertex-face
+  // connectivity if necessary.
+  void
+  populateFF() noexcept;
+
+  // Build a bounding volume hierarchy over the faces to accelerate intersect.
+  // The hierarchy is a complete binary tree stored in heap order, in which
+  // each node bounds a contiguous range of face IDs and each leaf bounds at
+  // most leaf_size faces. Since faces are never reordered, traversing the tree
+  // left to right visits faces in ascending order, and intersect produces
+  // exactly the same output as the brute-force search. The tree is only as
+  // tight as the face ordering is spatially coherent, so call
+  // spaceFillingCurveSort first.
+  // Any modification of the mesh invalidates the hierarchy, except direct
+  // modification of the vertices through vertices(), after which populateBVH
+  // must be called again.
+  void
+  populateBVH(Int leaf_size = 8) noexcept;
+
+  // Quadratic meshes only. Precompute the polynomial coefficients, whether the
+  // edge is effectively straight, and the bounding box of each edge of each
+  // face (see QuadraticEdgeCache). Afterwards, intersect and intersectWalk
+  // skip the edges whose box misses the ray, intersect straight edges as line
+  // segments, and do not recompute the coefficients of curved edges.
+  // Invalidated in the same way as the bounding volume hierarchy.
+  void
+  populateEdgeCache() noexcept
+    requires(P == 2);
+
   //===========================================================================
   // Methods
   //===========================================================================
@@ -166,12 +318,42 @@ public:
   PURE [[nodiscard]] constexpr auto
   boundingBox() const noexcept -> AxisAlignedBox2F;
 
+  // Return the ID of a face containing the point, or -1 if no face contains it.
+  // If the BVH has been populated, only the faces whose bounding box contains
+  // the point are tested. Otherwise, every face is tested.
   PURE [[nodiscard]] constexpr auto
   faceContaining(Point2F p) const noexcept -> Int;
 
+  // As above, but first walk from the hint face towards the point across the
+  // face-face connectivity, which is fast when the hint is near the point, as
+  // for consecutive points along a path. If the face-face connectivity has not
+  // been populated, or the walk leaves the mesh, fall back to the search above.
+  PURE [[nodiscard]] constexpr auto
+  faceContaining(Point2F p, Int hint) const noexcept -> Int;
+
+  // Bulk per-face geometric properties, computed serially on a
+  // PackedFaceVertexMesh of the faces. Each output array must have size >=
+  // numFaces(), and the i-th entry is getFace(i).area(), etc., up to rounding.
+  // When several properties are needed for the same faces, construct the
+  // PackedFaceVertexMesh once. To process many meshes, parallelize over the
+  // meshes.
+  void
+  faceAreas(Float * areas) const noexcept;
+
+  void
+  faceCentroids(Point2F * centroids) const noexcept;
+
+  void
+  faceBoundingBoxes(AxisAlignedBox2F * boxes) const noexcept;
+
+  void
+  faceMeanChordLengths(Float * mcls) const noexcept;
+
   // NOLINTNEXTLINE(google-explicit-constructor)
   operator PolytopeSoup() const noexcept;
 
+  // Check the mesh and repair what can be repaired. Invalidates the BVH and
+  // the quadratic edge cache.
   void
   validate();
 
@@ -191,6 +373,49 @@ public:
   auto
   intersect(Ray2F ray, Float * coords, Int * RESTRICT offsets,
             Int * RESTRICT faces) const noexcept -> Vec2I;
+
+  // Intersect the mesh with a ray by walking from face to face.
+  // The ray enters the mesh through the closest boundary edge, then steps into
+  // the adjacent face through each exit edge. The output has the same layout as
+  // intersect, but each visit of the ray to a face is stored as the pair
+  // (entry, exit) of ray coordinates, and the faces are ordered along the ray.
+  // Hence, sortRayMeshIntersections is not needed. Faces which the ray only
+  // touches at a vertex are not stored.
+  // The origin of the ray must not be in the interior of the mesh.
+  // Requires populateFF.
+  auto
+  intersectWalk(Ray2F ray, Float * coords, Int * RESTRICT offsets,
+                Int * RESTRICT faces) const noexcept -> Vec2I;
+
+  // Intersect the mesh with each ray and sort the intersections along each ray.
+  // With OpenMP, the rays are split into contiguous blocks which are processed
+  // in parallel, each thread with its own intersection and sorting buffers.
+  // The blocks are concatenated in ray order, so the output is identical to
+  // intersecting and sorting each ray serially. For linear meshes, consecutive
+  // rays with exactly the same direction, such as modular rays, are intersected
+  // as packets (see RayPacket2).
+  void
+  intersect(Vector<Ray2F> const & rays, RayMeshIntersections & out) const noexcept;
+
+  // Intersect the mesh with each ray of a packet of rays with a common
+  // direction, using the packet kernels of the faces. Linear meshes only.
+  // Equivalent to intersect(packet.getRay(k), coords + k * stride) for each ray,
+  // with the number of intersections of the k-th ray stored in hits[k].
+  template <Int K>
+  void
+  intersect(RayPacket2<K, Float> const & packet, Float * coords, Int stride,
+            Int * hits) const noexcept
+    requires(P == 1);
+
+  // Equivalent to intersect(packet.getRay(k), coords + k * coord_stride,
+  // offsets + k * face_stride, faces + k * face_stride) for each ray, with the
+  // result of the k-th ray stored in hits_faces[k]. Linear meshes only.
+  template <Int K>
+  void
+  intersect(RayPacket2<K, Float> const & packet, Float * coords, Int coord_stride,
+            Int * RESTRICT offsets, Int * RESTRICT faces, Int face_stride,
+            Vec2I * hits_faces) const noexcept
+    requires(P == 1);
 };
 
 //==============================================================================
@@ -290,6 +515,13 @@ FaceVertexMesh<P, N>::vertexFaceConn() const noexcept -> Vector<Int> const &
   return _vf;
 }
 
+template <Int P, Int N>
+PURE HOSTDEV constexpr auto
+FaceVertexMesh<P, N>::faceFaceConn() const noexcept -> Vector<Vec2I> const &
+{
+  return _ff;
+}
+
 //==============================================================================
 // Capacity
 //==============================================================================
@@ -387,6 +619,19 @@ FaceVertexMesh<P, N>::getFaceConn(Int i) const noexcept -> FaceConn const &
   return _fv[i];
 }
 
+template <Int P, Int N>
+PURE HOSTDEV [[nodiscard]] constexpr auto
+FaceVertexMesh<P, N>::getAdjacentFace(Int iface, Int iedge) const noexcept -> Vec2I
+{
+  ASSERT(_has_ff);
+  ASSERT_ASSUME(0 <= iface);
+  ASSERT(iface < numFaces());
+  ASSERT_ASSUME(0 <= iedge);
+  Int constexpr num_edges = polygonNumEdges<P, N>();
+  ASSERT_ASSUME(iedge < num_edges);
+  return _ff[iface * num_edges + iedge];
+}
+
 //==============================================================================
 // Modifiers
 //==============================================================================
@@ -395,7 +640,10 @@ template <Int P, Int N>
 constexpr void
 FaceVertexMesh<P, N>::addVertex(Vertex const & v) noexcept
 {
-  _has_vf = false; // Invalidate vertex-face connectivity
+  _has_vf = false;         // Invalidate vertex-face connectivity
+  _has_ff = false;         // Invalidate face-face connectivity
+  _has_bvh = false;        // Invalidate bounding volume hierarchy
+  _has_edge_cache = false; // Invalidate quadratic edge cache
   _v.emplace_back(v);
 }
 
@@ -403,7 +651,10 @@ template <Int P, Int N>
 constexpr void
 FaceVertexMesh<P, N>::addFace(FaceConn const & conn) noexcept
 {
-  _has_vf = false; // Invalidate vertex-face connectivity
+  _has_vf = false;         // Invalidate vertex-face connectivity
+  _has_ff = false;         // Invalidate face-face connectivity
+  _has_bvh = false;        // Invalidate bounding volume hierarchy
+  _has_edge_cache = false; // Invalidate quadratic edge cache
   _fv.emplace_back(conn);
 }
 
@@ -411,7 +662,10 @@ template <Int P, Int N>
 constexpr void
 FaceVertexMesh<P, N>::flipFace(Int i) noexcept
 {
-  _has_vf = false; // Invalidate vertex-face connectivity
+  _has_vf = false;         // Invalidate vertex-face connectivity
+  _has_ff = false;         // Invalidate face-face connectivity
+  _has_bvh = false;        // Invalidate bounding volume hierarchy
+  _has_edge_cache = false; // Invalidate quadratic edge cache
   if constexpr (P == 1 && N == 3) {
     um2::swap(_fv[i][1], _fv[i][2]);
   } else if constexpr (P == 1 && N == 4) {
@@ -459,12 +713,179 @@ template <Int P, Int N>
 PURE constexpr auto
 FaceVertexMesh<P, N>::faceContaining(Point2F const p) const noexcept -> Int
 {
-  for (Int i = 0; i < numFaces(); ++i) {
-    if (getFace(i).contains(p)) {
-      return i;
+  if (!_has_bvh) {
+    for (Int i = 0; i < numFaces(); ++i) {
+      if (getFace(i).contains(p)) {
+        return i;
+      }
     }
+    return -1;
   }
-  return -1;
+  // Once a face is found, no more boxes are hit, so the traversal ends.
+  Int result = -1;
+  forEachFaceRangeIf(
+      [&](AxisAlignedBox2F const & box) { return result == -1 && box.contains(p); },
+      [&](Int const first, Int const last) {
+        for (Int i = first; i < last; ++i) {
+          if (getFace(i).contains(p)) {
+            result = i;
+            return;
+          }
+        }
+      });
+  return result;
+}
+
+template <Int P, Int N>
+PURE constexpr auto
+FaceVertexMesh<P, N>::faceContaining(Point2F const p, Int const hint) const noexcept
+    -> Int
+{
+  if (!_has_ff || hint < 0 || numFaces() <= hint) {
+    return faceContaining(p);
+  }
+  // Walk towards the point: leave each face across an edge which the point is
+  // to the right of, using the linear edge (v_i, v_{i + 1}). For quadratic
+  // faces, this is an approximation used only to choose the direction. Limit
+  // the number of steps, since the walk may cycle on non-convex faces.
+  Int constexpr num_edges = polygonNumEdges<P, N>();
+  Int iface = hint;
+  Int const max_steps = numFaces();
+  for (Int step = 0; step < max_steps; ++step) {
+    auto const face = getFace(iface);
+    if (face.contains(p)) {
+      return iface;
+    }
+    Int exit_edge = -1;
+    Float min_cross = 0;
+    for (Int iedge = 0; iedge < num_edges; ++iedge) {
+      Point2F const & v0 = face[iedge];
+      Point2F const & v1 = face[(iedge + 1) % num_edges];
+      Float const cross = (v1 - v0).cross(p - v0);
+      if (cross < min_cross) {
+        min_cross = cross;
+        exit_edge = iedge;
+      }
+    }
+    if (exit_edge == -1) {
+      break;
+    }
+    iface = _ff[iface * num_edges + exit_edge][0];
+    if (iface == -1) {
+      break;
+    }
+  }
+  return faceContaining(p);
+}
+
+template <Int P, Int N>
+template <class B, class F>
+constexpr void
+FaceVertexMesh<P, N>::forEachFaceRangeIf(B && hits_box, F && f) const noexcept
+{
+  if (!_has_bvh) {
+    f(0, numFaces());
+    return;
+  }
+  // Depth-first traversal, visiting the left child before the right child.
+  // Node k has children 2k + 1 and 2k + 2. The leaves are the nodes in
+  // [2^depth - 1, 2^(depth + 1) - 1). The face range of each node is split in
+  // half between its children.
+  Int constexpr max_depth = 32;
+  ASSERT(_bvh_depth < max_depth);
+  Int const first_leaf = (1 << _bvh_depth) - 1;
+  Vec3I stack[max_depth + 1]; // (node, first face, last face)
+  Int top = 0;
+  stack[0] = Vec3I(0, 0, numFaces());
+  while (top >= 0) {
+    Int const node = stack[top][0];
+    Int const first = stack[top][1];
+    Int const last = stack[top][2];
+    --top;
+    if (first == last || !hits_box(_bvh[node])) {
+      continue;
+    }
+    if (node >= first_leaf) {
+      f(first, last);
+    } else {
+      Int const mid = first + (last - first) / 2;
+      stack[++top] = Vec3I(2 * node + 2, mid, last);
+      stack[++top] = Vec3I(2 * node + 1, first, mid);
+    }
+  }
+}
+
+template <Int P, Int N>
+template <class F>
+constexpr void
+FaceVertexMesh<P, N>::forEachFaceRange(Ray2F const ray, F && f) const noexcept
+{
+  auto const inv_dir = ray.inverseDirection();
+  forEachFaceRangeIf(
+      [&](AxisAlignedBox2F const & box) { return box.intersect(ray, inv_dir)[1] >= 0; },
+      f);
+}
+
+template <Int P, Int N>
+template <Int K, class F>
+constexpr void
+FaceVertexMesh<P, N>::forEachFaceRange(RayPacket2<K, Float> const & packet,
+                                       F && f) const noexcept
+{
+  auto const inv_dir = 1 / packet.direction();
+  forEachFaceRangeIf(
+      [&](AxisAlignedBox2F const & box) {
+        for (Int k = 0; k < K; ++k) {
+          if (box.intersect(packet.getRay(k), inv_dir)[1] >= 0) {
+            return true;
+          }
+        }
+        return false;
+      },
+      f);
+}
+
+template <Int P, Int N>
+auto
+FaceVertexMesh<P, N>::intersectEdge(Int const iface, Int const iedge, Ray2F const ray,
+                                    Vec2F const inv_dir,
+                                    Float * const coords) const noexcept -> Int
+{
+  if constexpr (P == 2) {
+    if (_has_edge_cache) {
+      Int constexpr num_edges = polygonNumEdges<P, N>();
+      auto const & edge = _edge_cache[iface * num_edges + iedge];
+      if (edge.box.intersect(ray, inv_dir)[1] < 0) {
+        return 0;
+      }
+      if (edge.is_straight) {
+        LineSegment2<Float> const line(edge.coeffs[0], edge.coeffs[1]);
+        return line.intersect(ray, coords);
+      }
+      return um2::intersect(edge.coeffs, ray, coords);
+    }
+  }
+  static_cast<void>(inv_dir);
+  return getEdge(iface, iedge).intersect(ray, coords);
+}
+
+template <Int P, Int N>
+auto
+FaceVertexMesh<P, N>::intersectFace(Int const i, Ray2F const ray, Vec2F const inv_dir,
+                                    Float * const coords) const noexcept -> Int
+{
+  if constexpr (P == 2) {
+    if (_has_edge_cache) {
+      Int constexpr num_edges = polygonNumEdges<P, N>();
+      Int hits = 0;
+      for (Int iedge = 0; iedge < num_edges; ++iedge) {
+        hits += intersectEdge(i, iedge, ray, inv_dir, coords + hits);
+      }
+      return hits;
+    }
+  }
+  static_cast<void>(inv_dir);
+  return getFace(i).intersect(ray, coords);
 }
 
 template <Int P, Int N>
@@ -472,10 +893,13 @@ auto
 FaceVertexMesh<P, N>::intersect(Ray2F const ray,
                                 Float * const coords) const noexcept -> Int
 {
+  auto const inv_dir = ray.inverseDirection();
   Int hits = 0;
-  for (Int i = 0; i < numFaces(); ++i) {
-    hits += getFace(i).intersect(ray, coords + hits);
-  }
+  forEachFaceRange(ray, [&](Int const first, Int const last) {
+    for (Int i = first; i < last; ++i) {
+      hits += intersectFace(i, ray, inv_dir, coords + hits);
+    }
+  });
   return hits;
 }
 
@@ -484,19 +908,74 @@ auto
 FaceVertexMesh<P, N>::intersect(Ray2F const ray, Float * coords, Int * RESTRICT offsets,
                                 Int * RESTRICT faces) const noexcept -> Vec2I
 {
+  auto const inv_dir = ray.inverseDirection();
   *offsets++ = 0;
   Int total_hits = 0;
   Int num_faces = 0;
-  for (Int i = 0; i < numFaces(); ++i) {
-    Int const hits = getFace(i).intersect(ray, coords + total_hits);
-    if (hits > 0) {
-      total_hits += hits;
-      ++num_faces;
-      *offsets++ = total_hits;
-      *faces++ = i;
+  forEachFaceRange(ray, [&](Int const first, Int const last) {
+    for (Int i = first; i < last; ++i) {
+      Int const hits = intersectFace(i, ray, inv_dir, coords + total_hits);
+      if (hits > 0) {
+        total_hits += hits;
+        ++num_faces;
+        *offsets++ = total_hits;
+        *faces++ = i;
+      }
     }
-  }
+  });
   return {total_hits, num_faces};
 }
 
+template <Int P, Int N>
+template <Int K>
+void
+FaceVertexMesh<P, N>::intersect(RayPacket2<K, Float> const & packet, Float * coords,
+                                Int const stride, Int * hits) const noexcept
+  requires(P == 1)
+{
+  for (Int k = 0; k < K; ++k) {
+    hits[k] = 0;
+  }
+  forEachFaceRange(packet, [&](Int const first, Int const last) {
+    for (Int i = first; i < last; ++i) {
+      getFace(i).intersect(packet, coords, stride, hits);
+    }
+  });
+}
+
+template <Int P, Int N>
+template <Int K>
+void
+FaceVertexMesh<P, N>::intersect(RayPacket2<K, Float> const & packet, Float * coords,
+                                Int const coord_stride, Int * RESTRICT offsets,
+                                Int * RESTRICT faces, Int const face_stride,
+                                Vec2I * hits_faces) const noexcept
+  requires(P == 1)
+{
+  Int hits[K];
+  for (Int k = 0; k < K; ++k) {
+    hits[k] = 0;
+    hits_faces[k] = Vec2I(0, 0);
+    offsets[k * face_stride] = 0;
+  }
+  forEachFaceRange(packet, [&](Int const first, Int const last) {
+    for (Int i = first; i < last; ++i) {
+      uint32_t const mask = getFace(i).intersect(packet, coords, coord_stride, hits);
+      if (mask == 0) {
+        continue;
+      }
+      for (Int k = 0; k < K; ++k) {
+        if (((mask >> static_cast<uint32_t>(k)) & 1U) != 0) {
+          Int const nfaces = hits_faces[k][1]++;
+          offsets[k * face_stride + nfaces + 1] = hits[k];
+          faces[k * face_stride + nfaces] = i;
+        }
+      }
+    }
+  });
+  for (Int k = 0; k < K; ++k) {
+    hits_faces[k][0] = hits[k];
+  }
+}
+
 } // namespace um2
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/algorithm/min.hpp>
+#include <um2/stdlib/math/roots.hpp>
+#include <um2/stdlib/numbers.hpp>
+#include <um2/stdlib/vector.hpp>
+
+//=============================================================================
+// PACKED FACE-VERTEX MESH
+//=============================================================================
+// A read-only, structure-of-arrays view of the faces of a FaceVertexMesh.
+//
+// FaceVertexMesh::getFace(i) gathers the N vertices of the i-th face through
+// the face-vertex connectivity, which is an indirect, scattered load for each
+// vertex. The packed mesh instead stores the coordinates of each face's
+// vertices directly, one array per vertex slot:
+//  - _x[j * num_faces + i] is the x-coordinate of the j-th vertex of the i-th face
+//  - _y[j * num_faces + i] is the y-coordinate of the j-th vertex of the i-th face
+//
+// Hence, a loop over faces streams through 2N contiguous arrays, with
+// consecutive faces in consecutive memory locations, which is cache-friendly
+// and allows the compiler to vectorize across faces.
+//
+// The bulk operations (faceAreas, faceCentroids, etc.) produce the values of
+// the corresponding Polygon functions on FaceVertexMesh::getFace(i). For
+// triangles and quadrilaterals, they evaluate the same formulas directly on the
+// coordinate arrays, so the results agree up to rounding. Quadratic faces are
+// assembled with getFace(i), since their edges need the general Polygon
+// functions. Packing and the operations are serial, so that callers with many
+// small meshes can parallelize over the meshes instead.
+//
+// The packed mesh is a snapshot: modifying the original mesh does not update it.
+
+namespace um2
+{
+
+template <Int P, Int N>
+class PackedFaceVertexMesh
+{
+
+public:
+  using Face = typename FaceVertexMesh<P, N>::Face;
+  using Vertex = typename FaceVertexMesh<P, N>::Vertex;
+
+private:
+  Int _num_faces = 0;
+  Vector<Float> _x; // x-coordinates of the vertices of each face
+  Vector<Float> _y; // y-coordinates of the vertices of each face
+
+public:
+  //===========================================================================
+  // Constructors
+  //===========================================================================
+
+  constexpr PackedFaceVertexMesh() noexcept = default;
+
+  explicit PackedFaceVertexMesh(FaceVertexMesh<P, N> const & mesh) noexcept;
+
+  //===========================================================================
+  // Accessors
+  //===========================================================================
+
+  PURE [[nodiscard]] constexpr auto
+  numFaces() const noexcept -> Int;
+
+  // The x-coordinates of the j-th vertex of every face.
+  PURE [[nodiscard]] constexpr auto
+  x(Int j) const noexcept -> Float const *;
+
+  // The y-coordinates of the j-th vertex of every face.
+  PURE [[nodiscard]] constexpr auto
+  y(Int j) const noexcept -> Float const *;
+
+  PURE [[nodiscard]] constexpr auto
+  getVertex(Int iface, Int j) const noexcept -> Vertex;
+
+  PURE [[nodiscard]] constexpr auto
+  getFace(Int i) const noexcept -> Face;
+
+  //===========================================================================
+  // Methods
+  //===========================================================================
+
+  PURE [[nodiscard]] constexpr auto
+  boundingBox() const noexcept -> AxisAlignedBox2F;
+
+  // Each output array must have size >= numFaces() and must not overlap the
+  // mesh.
+
+  void
+  faceAreas(Float * areas) const noexcept;
+
+  void
+  faceCentroids(Point2F * centroids) const noexcept;
+
+  void
+  faceBoundingBoxes(AxisAlignedBox2F * boxes) const noexcept;
+
+  void
+  faceMeanChordLengths(Float * mcls) const noexcept;
+};
+
+//==============================================================================
+// Aliases
+//==============================================================================
+
+using PackedTriFVM = PackedFaceVertexMesh<1, 3>;
+using PackedQuadFVM = PackedFaceVertexMesh<1, 4>;
+using PackedTri6FVM = PackedFaceVertexMesh<2, 6>;
+using PackedQuad8FVM = PackedFaceVertexMesh<2, 8>;
+
+//==============================================================================
+// Constructors
+//==============================================================================
+
+template <Int P, Int N>
+PackedFaceVertexMesh<P, N>::PackedFaceVertexMesh(FaceVertexMesh<P, N> const & mesh) noexcept
+    : _num_faces(mesh.numFaces())
+{
+  // Vector(n) requires n > 0, but a mesh may have no faces.
+  _x.resize(N * _num_faces);
+  _y.resize(N * _num_faces);
+  auto const & vertices = mesh.vertices();
+  for (Int i = 0; i < _num_faces; ++i) {
+    auto const & conn = mesh.getFaceConn(i);
+    for (Int j = 0; j < N; ++j) {
+      auto const & v = vertices[conn[j]];
+      _x[j * _num_faces + i] = v[0];
+      _y[j * _num_faces + i] = v[1];
+    }
+  }
+}
+
+//==============================================================================
+// Accessors
+//==============================================================================
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::numFaces() const noexcept -> Int
+{
+  return _num_faces;
+}
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::x(Int const j) const noexcept -> Float const *
+{
+  ASSERT_ASSUME(0 <= j);
+  ASSERT_ASSUME(j < N);
+  return _x.data() + j * _num_faces;
+}
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::y(Int const j) const noexcept -> Float const *
+{
+  ASSERT_ASSUME(0 <= j);
+  ASSERT_ASSUME(j < N);
+  return _y.data() + j * _num_faces;
+}
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::getVertex(Int const iface, Int const j) const noexcept
+    -> Vertex
+{
+  ASSERT_ASSUME(0 <= iface);
+  ASSERT(iface < _num_faces);
+  ASSERT_ASSUME(0 <= j);
+  ASSERT_ASSUME(j < N);
+  return {_x[j * _num_faces + iface], _y[j * _num_faces + iface]};
+}
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::getFace(Int const i) const noexcept -> Face
+{
+  ASSERT_ASSUME(0 <= i);
+  ASSERT(i < _num_faces);
+  Face face;
+  for (Int j = 0; j < N; ++j) {
+    face[j][0] = _x[j * _num_faces + i];
+    face[j][1] = _y[j * _num_faces + i];
+  }
+  return face;
+}
+
+//==============================================================================
+// Methods
+//==============================================================================
+
+template <Int P, Int N>
+PURE constexpr auto
+PackedFaceVertexMesh<P, N>::boundingBox() const noexcept -> AxisAlignedBox2F
+{
+  ASSERT(_num_faces > 0);
+  if constexpr (P == 1) {
+    // The box of the vertices. Reduce over the contiguous coordinate arrays.
+    Float xmin = _x[0];
+    Float xmax = _x[0];
+    Float ymin = _y[0];
+    Float ymax = _y[0];
+    Int const n = N * _num_faces;
+    for (Int i = 1; i < n; ++i) {
+      xmin = um2::min(xmin, _x[i]);
+      xmax = um2::max(xmax, _x[i]);
+      ymin = um2::min(ymin, _y[i]);
+      ymax = um2::max(ymax, _y[i]);
+    }
+    return {Point2F(xmin, ymin), Point2F(xmax, ymax)};
+  } else {
+    // Quadratic edges may bulge past their vertices.
+    auto box = getFace(0).boundingBox();
+    for (Int i = 1; i < _num_faces; ++i) {
+      box += getFace(i).boundingBox();
+    }
+    return box;
+  }
+}
+
+// The linear kernels below repeat the arithmetic of the Triangle and
+// Quadrilateral functions operation for operation.
+
+template <Int P, Int N>
+void
+PackedFaceVertexMesh<P, N>::faceAreas(Float * RESTRICT const areas) const noexcept
+{
+  Int const n = _num_faces;
+  if constexpr (P == 1 && N == 3) {
+    // (v1 - v0).cross(v2 - v0) / 2
+    Float const * const x0 = x(0);
+    Float const * const x1 = x(1);
+    Float const * const x2 = x(2);
+    Float const * const y0 = y(0);
+    Float const * const y1 = y(1);
+    Float const * const y2 = y(2);
+    for (Int i = 0; i < n; ++i) {
+      areas[i] = det2x2(x1[i] - x0[i], y1[i] - y0[i], x2[i] - x0[i], y2[i] - y0[i]) / 2;
+    }
+  } else if constexpr (P == 1 && N == 4) {
+    // (v2 - v0).cross(v3 - v1) / 2
+    Float const * const x0 = x(0);
+    Float const * const x1 = x(1);
+    Float const * const x2 = x(2);
+    Float const * const x3 = x(3);
+    Float const * const y0 = y(0);
+    Float const * const y1 = y(1);
+    Float const * const y2 = y(2);
+    Float const * const y3 = y(3);
+    for (Int i = 0; i < n; ++i) {
+      areas[i] = det2x2(x2[i] - x0[i], y2[i] - y0[i], x3[i] - x1[i], y3[i] - y1[i]) / 2;
+    }
+  } else {
+    for (Int i = 0; i < n; ++i) {
+      areas[i] = getFace(i).area();
+    }
+  }
+}
+
+template <Int P, Int N>
+void
+PackedFaceVertexMesh<P, N>::faceCentroids(Point2F * RESTRICT const centroids) const noexcept
+{
+  Int const n = _num_faces;
+  if constexpr (P == 1 && N == 3) {
+    // (v0 + v1 + v2) / 3
+    Float const * const x0 = x(0);
+    Float const * const x1 = x(1);
+    Float const * const x2 = x(2);
+    Float const * const y0 = y(0);
+    Float const * const y1 = y(1);
+    Float const * const y2 = y(2);
+    for (Int i = 0; i < n; ++i) {
+      centroids[i][0] = (x0[i] + x1[i] + x2[i]) / 3;
+      centroids[i][1] = (y0[i] + y1[i] + y2[i]) / 3;
+    }
+  } else if constexpr (P == 1 && N == 4) {
+    // The area-weighted centroids of the triangles (v0, v1, v2) and
+    // (v0, v2, v3).
+    Float const * const x0 = x(0);
+    Float const * const x1 = x(1);
+    Float const * const x2 = x(2);
+    Float const * const x3 = x(3);
+    Float const * const y0 = y(0);
+    Float const * const y1 = y(1);
+    Float const * const y2 = y(2);
+    Float const * const y3 = y(3);
+    for (Int i = 0; i < n; ++i) {
+      Float const v10x = x1[i] - x0[i];
+      Float const v10y = y1[i] - y0[i];
+      Float const v20x = x2[i] - x0[i];
+      Float const v20y = y2[i] - y0[i];
+      Float const v30x = x3[i] - x0[i];
+      Float const v30y = y3[i] - y0[i];
+      Float const a1 = det2x2(v10x, v10y, v20x, v20y);
+      Float const a2 = det2x2(v20x, v20y, v30x, v30y);
+      Float const a12 = a1 + a2;
+      Float const denom = 3 * a12;
+      centroids[i][0] = (a1 * x1[i] + a2 * x3[i] + a12 * (x0[i] + x2[i])) / denom;
+      centroids[i][1] = (a1 * y1[i] + a2 * y3[i] + a12 * (y0[i] + y2[i])) / denom;
+    }
+  } else {
+    for (Int i = 0; i < n; ++i) {
+      centroids[i] = getFace(i).centroid();
+    }
+  }
+}
+
+template <Int P, Int N>
+void
+PackedFaceVertexMesh<P, N>::faceBoundingBoxes(
+    AxisAlignedBox2F * RESTRICT const boxes) const noexcept
+{
+  Int const n = _num_faces;
+  if constexpr (P == 1) {
+    // The box of the vertices. Reduce a block of faces into scalar arrays,
+    // which vectorizes, then assemble their boxes.
+    Int constexpr block_size = 64;
+    Float xmin[block_size];
+    Float xmax[block_size];
+    Float ymin[block_size];
+    Float ymax[block_size];
+    Float const * const xs = _x.data();
+    Float const * const ys = _y.data();
+    for (Int first = 0; first < n; first += block_size) {
+      Int const m = um2::min(block_size, n - first);
+      for (Int k = 0; k < m; ++k) {
+        Int const i = first + k;
+        xmin[k] = xs[i];
+        xmax[k] = xs[i];
+        ymin[k] = ys[i];
+        ymax[k] = ys[i];
+        for (Int j = 1; j < N; ++j) {
+          xmin[k] = um2::min(xmin[k], xs[j * n + i]);
+          xmax[k] = um2::max(xmax[k], xs[j * n + i]);
+          ymin[k] = um2::min(ymin[k], ys[j * n + i]);
+          ymax[k] = um2::max(ymax[k], ys[j * n + i]);
+        }
+      }
+      for (Int k = 0; k < m; ++k) {
+        boxes[first + k] =
+            AxisAlignedBox2F(Point2F(xmin[k], ymin[k]), Point2F(xmax[k], ymax[k]));
+      }
+    }
+  } else {
+    for (Int i = 0; i < n; ++i) {
+      boxes[i] = getFace(i).boundingBox();
+    }
+  }
+}
+
+template <Int P, Int N>
+void
+PackedFaceVertexMesh<P, N>::faceMeanChordLengths(Float * RESTRICT const mcls) const noexcept
+{
+  Int const n = _num_faces;
+  if constexpr (P == 1) {
+    // pi * area / perimeter. The areas are written to mcls first.
+    faceAreas(mcls);
+    for (Int i = 0; i < n; ++i) {
+      // The last edge (wraparound) first, as in perimeter()
+      Float dx = _x[(N - 1) * n + i] - _x[i];
+      Float dy = _y[(N - 1) * n + i] - _y[i];
+      Float perimeter = um2::sqrt(dx * dx + dy * dy);
+      for (Int j = 0; j < N - 1; ++j) {
+        dx = _x[j * n + i] - _x[(j + 1) * n + i];
+        dy = _y[j * n + i] - _y[(j + 1) * n + i];
+        perimeter += um2::sqrt(dx * dx + dy * dy);
+      }
+      mcls[i] = um2::pi<Float> * mcls[i] / perimeter;
+    }
+  } else {
+    for (Int i = 0; i < n; ++i) {
+      mcls[i] = getFace(i).meanChordLength();
+    }
+  }
+}
+
+} // namespace um2
@@ -42,6 +42,16 @@ class PolytopeSoup
   Vector<Int> _elset_ids;     // Element IDs of each elset (must be sorted)
   Vector<Vector<Float>> _elset_data; // Data associated with each elset
 
+  // Open-addressing hash table of elset indices, keyed by elset name. Empty
+  // slots are -1. At most half of the slots are occupied.
+  Vector<Int> _elset_table;
+
+  void
+  insertIntoElsetTable(Int i);
+
+  void
+  rebuildElsetTable();
+
 public:
   //==============================================================================
   // Constructors
@@ -113,6 +123,10 @@ public:
   void
   getElset(String const & name, Vector<Int> & ids, Vector<Float> & data) const;
 
+  // Return the index of the elset with the given name, or -1 if there is none.
+  PURE [[nodiscard]] auto
+  getElsetIndex(String const & name) const noexcept -> Int;
+
   //==============================================================================
   // Modifiers
   //==============================================================================
@@ -123,9 +137,23 @@ public:
   auto
   addVertex(Point3F const & p) -> Int;
 
+  // Add the vertices in bulk, with z = 0 for 2D vertices. Returns the ID of the
+  // first vertex added.
+  auto
+  addVertices(Vector<Point2F> const & vertices) -> Int;
+
+  auto
+  addVertices(Vector<Point3F> const & vertices) -> Int;
+
   auto
   addElement(VTKElemType type, Vector<Int> const & conn) -> Int;
 
+  // Add elements of the same type in bulk. The vertex IDs of the i-th element
+  // are conn[i * n, (i + 1) * n), where n = verticesPerElem(type). Returns the
+  // ID of the first element added.
+  auto
+  addElements(VTKElemType type, Vector<Int> const & conn) -> Int;
+
   auto
   addElset(String const & name, Vector<Int> const & ids, Vector<Float> data = {}) -> Int;
 
@@ -151,6 +179,16 @@ public:
   void
   getSubset(String const & elset_name, PolytopeSoup & subset) const;
 
+  // Split the soup into the subsets given by each elset whose name starts with
+  // prefix, e.g. "Coarse_Cell_". subsets[i] is the subset given by the elset
+  // names[i], exactly as getSubset would produce it, but every subset is made
+  // in a single pass over the elsets, rather than a search of all elsets per
+  // subset. The elsets with the prefix must not share elements. With OpenMP,
+  // the subsets are built in parallel.
+  void
+  partitionByElsetPrefix(String const & prefix, Vector<String> & names,
+                         Vector<PolytopeSoup> & subsets) const;
+
   PURE [[nodiscard]] auto
   compare(PolytopeSoup const & other) const -> int;
 
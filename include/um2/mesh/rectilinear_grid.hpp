@@ -113,6 +113,13 @@ public:
   PURE HOSTDEV [[nodiscard]] constexpr auto
   getBox(Args... args) const noexcept -> AxisAlignedBox<D, T>;
 
+  // Get the index of the grid cell containing the given point, using a binary
+  // search of the divisions along each axis. Points on the boundary between
+  // two cells belong to the upper cell, except on the maximum boundary of the grid.
+  // If the point is outside the grid, returns -1 for the indices.
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getCellIndexContaining(Point<D, T> const & point) const noexcept -> Vec<D, Int>;
+
 }; // RectilinearGrid
 
 //==============================================================================
@@ -400,4 +407,35 @@ RectilinearGrid<D, T>::getBox(Args... args) const noexcept -> AxisAlignedBox<D,
   return {minima, maxima};
 }
 
+template <Int D, class T>
+PURE HOSTDEV constexpr auto
+RectilinearGrid<D, T>::getCellIndexContaining(Point<D, T> const & point) const noexcept
+    -> Vec<D, Int>
+{
+  Vec<D, Int> result;
+  for (Int i = 0; i < D; ++i) {
+    auto const & divs = _divs[i];
+    ASSERT(divs.size() >= 2);
+    T const x = point[i];
+    if (x < divs.front() || divs.back() < x) {
+      result[i] = -1;
+      continue;
+    }
+    // Find the last division <= x, clamped so that the maximum boundary of the
+    // grid belongs to the last cell.
+    Int lo = 0;
+    Int hi = divs.size() - 2;
+    while (lo < hi) {
+      Int const mid = lo + (hi - lo + 1) / 2;
+      if (divs[mid] <= x) {
+        lo = mid;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    result[i] = lo;
+  }
+  return result;
+}
+
 } // namespace um2
@@ -5,6 +5,7 @@
 #include <um2/mesh/regular_partition.hpp>
 #include <um2/physics/cmfd.hpp>
 #include <um2/physics/material.hpp>
+#include <um2/stdlib/utility/pair.hpp>
 
 namespace um2::mpact
 {
@@ -77,7 +78,32 @@ public:
   using Assembly = RectilinearPartition1<Int>;
   using Core = RectilinearPartition2<Int>;
 
+  // A coarse cell in the flattened spatial hierarchy. The first four indices
+  // locate the instance within its parents, e.g. the assembly is
+  // core.children()[assembly].
+  struct CoarseCellInstance {
+    Int assembly;    // index into the children of the core
+    Int lattice;     // index into the children of the assembly
+    Int rtm;         // index into the children of the lattice
+    Int coarse_cell; // index into the children of the RTM
+    Int cc_id;       // index into the unique coarse cells
+    Int fsr_offset;  // global index of the first fine cell of the instance
+  };
+
 private:
+  // The flattened spatial hierarchy. See coarseCellInstances.
+  struct InstanceTable {
+    Vector<CoarseCellInstance> instances; // In traversal order
+    // The offset of the first fine cell of each child relative to the first
+    // fine cell of its parent, for the core and for each unique assembly,
+    // lattice, and RTM. Used by findFSR. Since the offsets are stored per unique
+    // parent rather than per instance, this is small even for a full core.
+    Vector<Int> core_fsr_offsets;
+    Vector<Vector<Int>> assembly_fsr_offsets;
+    Vector<Vector<Int>> lattice_fsr_offsets;
+    Vector<Vector<Int>> rtm_fsr_offsets;
+  };
+
   // Spatial hierarchy
   Core _core;
   Vector<Assembly> _assemblies;     // Unique assemblies
@@ -94,6 +120,21 @@ private:
   Vector<Tri6FVM> _tri6s;   // Unique triangle6 meshes
   Vector<Quad8FVM> _quad8s; // Unique quadrilateral8 meshes
 
+  // Built on first use and invalidated by any modification of the hierarchy
+  mutable InstanceTable _instance_table;
+  mutable bool _has_instance_table = false;
+
+  auto
+  instanceTable() const -> InstanceTable const &;
+
+  void
+  invalidateInstanceTable() noexcept;
+
+  // See findFSR. If use_z is false, z is ignored and the bottom lattice of each
+  // assembly is used.
+  [[nodiscard]] auto
+  locateFSR(Point2F xy, Float z, bool use_z) const -> Int;
+
 public:
   //============================================================================
   // Constructors
@@ -212,6 +253,22 @@ public:
   PURE [[nodiscard]] constexpr auto
   getQuad8Mesh(Int mesh_id) const noexcept -> Quad8FVM const &;
 
+  // Every coarse cell in the model (including duplicates), in the order of the
+  // global fine cell (FSR) indices: core, assembly, lattice, then RTM children.
+  // The table is built on the first call and cached until the hierarchy is
+  // modified, so the first call must not be made concurrently.
+  [[nodiscard]] auto
+  coarseCellInstances() const -> Vector<CoarseCellInstance> const &;
+
+  // Return the index of the coarse cell instance containing the fine cell and
+  // the index of the fine cell within the coarse cell.
+  [[nodiscard]] auto
+  getFSRLocation(Int fsr) const -> Pair<Int, Int>;
+
+  // Return the global index of the face of the coarse cell instance.
+  [[nodiscard]] auto
+  getFSRIndex(Int instance, Int face) const -> Int;
+
   //============================================================================
   // Modifiers
   //============================================================================
@@ -278,6 +335,27 @@ public:
   void
   importCoarseCellMeshes(String const & filename);
 
+  // Sort the vertices and faces of each coarse cell mesh along a space-filling
+  // curve, reordering the material IDs of each coarse cell to match. This
+  // changes the order of the fine cells (FSRs) within each coarse cell. The BVH
+  // and edge cache of each mesh are rebuilt only if the mesh had them.
+  void
+  spaceFillingCurveSort(
+      SpaceFillingCurve curve = settings::mesh::space_filling_curve) noexcept;
+
+  // Build a bounding volume hierarchy over the faces of each coarse cell mesh to
+  // accelerate point location. Called by read and importCoarseCellMeshes.
+  // Meshes added by any other means are searched face by face until this is
+  // called.
+  void
+  populateMeshBVHs() noexcept;
+
+  // Precompute the edge data of each quadratic coarse cell mesh, which ray
+  // tracing uses to skip and simplify edge intersections. Called wherever
+  // populateMeshBVHs is.
+  void
+  populateMeshEdgeCaches() noexcept;
+
   //============================================================================
   // Methods
   //============================================================================
@@ -303,9 +381,28 @@ public:
   PURE [[nodiscard]] auto
   getCoarseCellHomogenizedXSec(Int cc_id) const -> XSec;
 
-  PURE [[nodiscard]] auto
+  [[nodiscard]] auto
   getMeanChordLengths() const -> Vector<Float>;
 
+  // Return the global index of the fine cell (FSR) containing the point, or -1 if
+  // the point is outside the model. FSRs are numbered in the same order as
+  // getMeanChordLengths. The point is located by descending the core, assembly,
+  // lattice, and RTM grids, then searching the coarse cell mesh. The 2D overload
+  // uses the bottom lattice of each assembly. The FSR index is computed from the
+  // offsets cached with coarseCellInstances.
+  [[nodiscard]] auto
+  findFSR(Point2F p) const -> Int;
+
+  [[nodiscard]] auto
+  findFSR(Point3F p) const -> Int;
+
+  // Locate many points in parallel, as above.
+  [[nodiscard]] auto
+  findFSRs(Vector<Point2F> const & points) const -> Vector<Int>;
+
+  [[nodiscard]] auto
+  findFSRs(Vector<Point3F> const & points) const -> Vector<Int>;
+
 #if UM2_HAS_CMFD
   void
   writeCMFDInfo(String const & filename) const;
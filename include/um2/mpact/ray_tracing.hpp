@@ -0,0 +1,137 @@
+#pragma once
+
+#include <um2/config.hpp>
+#include <um2/geometry/modular_rays.hpp>
+#include <um2/mpact/model.hpp>
+#include <um2/stdlib/vector.hpp>
+
+namespace um2::mpact
+{
+
+//==============================================================================
+// MODULAR RAY TRACING
+//==============================================================================
+// Trace the cyclic modular rays of each azimuthal angle through every RTM in the
+// core and store the segments of each ray.
+//
+// Every RTM has the same width and height, so the modular rays of an angle are
+// the same in every RTM (see modular_rays.hpp). A ray is traced through each
+// coarse cell it crosses, in order, and each face it crosses produces a segment:
+// the global FSR index of the face and the length of the ray inside the face.
+//
+// Since the rays are identical in every instance of an RTM, the segments are
+// only traced once for each unique RTM and angle. These segment templates store
+// FSR indices local to the RTM. The full-core segments are obtained by stitching
+// the templates together, adding the FSR offset of each RTM instance.
+//
+// Global FSR indices follow the ordering of the model: the faces of each coarse
+// cell, for each coarse cell in each RTM, for each RTM in each lattice, for each
+// lattice in each assembly, for each assembly in the core. This is the same
+// ordering as Model::getMeanChordLengths.
+//
+// Layout:
+//  - params[ia] are the modular ray parameters of the ia-th angle. Since the
+//    rays must be cyclic, the effective angle and spacing may differ slightly
+//    from the target values.
+//  - The rays of the ia-th angle are [ray_offsets[ia], ray_offsets[ia + 1]).
+//    For each angle, the rays are ordered by RTM (in global order), then by
+//    modular ray index in the RTM.
+//  - The segments of the i-th ray are [segment_offsets[i], segment_offsets[i + 1]),
+//    ordered along the ray.
+//  - fsr_ids[j] and lengths[j] are the global FSR index and length of the j-th
+//    segment.
+
+struct ModularRaySegments {
+  Vector<ModularRayParams<Float>> params;
+  Vector<Int> ray_offsets;
+  Vector<Int> segment_offsets;
+  Vector<Int> fsr_ids;
+  Vector<Float> lengths;
+
+  PURE [[nodiscard]] constexpr auto
+  numAngles() const noexcept -> Int
+  {
+    return params.size();
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numRays() const noexcept -> Int
+  {
+    return segment_offsets.empty() ? 0 : segment_offsets.size() - 1;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numSegments() const noexcept -> Int
+  {
+    return fsr_ids.size();
+  }
+};
+
+// The segments of the modular rays of a single angle through a unique RTM.
+// Same layout as ModularRaySegments, but with FSR indices local to the RTM: the
+// faces of each coarse cell, for each coarse cell in the RTM.
+struct SegmentTemplate {
+  Vector<Int> segment_offsets;
+  Vector<Int> fsr_ids;
+  Vector<Float> lengths;
+
+  PURE [[nodiscard]] constexpr auto
+  numRays() const noexcept -> Int
+  {
+    return segment_offsets.empty() ? 0 : segment_offsets.size() - 1;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numSegments() const noexcept -> Int
+  {
+    return fsr_ids.size();
+  }
+};
+
+// Segment templates for each (unique RTM, angle) pair, and the RTM instances
+// which they are stitched into.
+//  - templates[rtm_id * numAngles() + ia] is the template of the rtm_id-th
+//    unique RTM and ia-th angle. Templates of RTMs which are not in the core
+//    are empty.
+//  - rtm_ids[i] and fsr_offsets[i] are the unique RTM ID and global index of the
+//    first FSR of the i-th RTM in the core, in the global order.
+struct SegmentTemplates {
+  Vector<ModularRayParams<Float>> params;
+  Vector<SegmentTemplate> templates;
+  Vector<Int> rtm_ids;
+  Vector<Int> fsr_offsets;
+
+  PURE [[nodiscard]] constexpr auto
+  numAngles() const noexcept -> Int
+  {
+    return params.size();
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numRTMs() const noexcept -> Int
+  {
+    return rtm_ids.size();
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  getTemplate(Int rtm_id, Int ia) const noexcept -> SegmentTemplate const &
+  {
+    return templates[rtm_id * numAngles() + ia];
+  }
+};
+
+// angles: Target azimuthal angles γ ∈ (0, π)
+// spacing: Target ray spacing
+[[nodiscard]] auto
+getSegmentTemplates(Model const & model, Vector<Float> const & angles,
+                    Float spacing) -> SegmentTemplates;
+
+[[nodiscard]] auto
+stitchSegmentTemplates(SegmentTemplates const & templates) -> ModularRaySegments;
+
+// Equivalent to stitchSegmentTemplates(getSegmentTemplates(model, angles, spacing))
+[[nodiscard]] auto
+traceModularRays(Model const & model, Vector<Float> const & angles,
+                 Float spacing) -> ModularRaySegments;
+
+} // namespace um2::mpact
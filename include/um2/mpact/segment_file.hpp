@@ -0,0 +1,164 @@
+#pragma once
+
+#include <um2/config.hpp>
+#include <um2/geometry/modular_rays.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/stdlib/string.hpp>
+
+#include <cstddef> // size_t
+
+namespace um2::mpact
+{
+
+//==============================================================================
+// SEGMENT FILE
+//==============================================================================
+// A compact binary format for the segments of the modular rays, which may be
+// memory-mapped and read without copying the file.
+//
+// Layout (native byte order, each section aligned to 8 bytes):
+//  - Header: magic string, version, length format, counts, and the byte offset
+//    of each of the following sections.
+//  - Parameters: the ModularRayParams of each angle (box, number of rays,
+//    spacing, direction), stored as doubles and 32-bit integers.
+//  - Ray offsets: int32[num_angles + 1]. The rays of the ia-th angle are
+//    [ray_offsets[ia], ray_offsets[ia + 1]).
+//  - Segment offsets: int64[num_rays + 1]. The segments of the i-th ray are
+//    [segment_offsets[i], segment_offsets[i + 1]).
+//  - FSR offsets: int64[num_rays + 1]. The byte offset of the FSR IDs of the
+//    i-th ray in the FSR data.
+//  - FSR data: the FSR IDs of each ray, delta-encoded with respect to the
+//    previous segment of the ray (the first is relative to 0), as zigzag
+//    variable-length integers. Consecutive FSRs along a ray tend to have
+//    nearby IDs, so most segments take a single byte.
+//  - Lengths: float32 or 16-bit lengths of each segment.
+//
+// Length formats:
+//  - Float32: IEEE single precision.
+//  - Float16: IEEE half precision (~3 significant digits).
+//  - Quantized16: length = q * scale, with q a uint16 and scale = max length /
+//    65535. Uniform absolute error, which is usually preferable to Float16 for
+//    the short segments near material interfaces.
+
+enum class SegmentLengthFormat : int32_t {
+  Float32 = 0,
+  Float16 = 1,
+  Quantized16 = 2,
+};
+
+void
+writeSegmentFile(String const & filename, ModularRaySegments const & segments,
+                 SegmentLengthFormat format = SegmentLengthFormat::Float32);
+
+// A read-only, memory-mapped segment file.
+class SegmentFile
+{
+
+  void * _map = nullptr; // The memory-mapped file
+  size_t _map_size = 0;
+
+  SegmentLengthFormat _format = SegmentLengthFormat::Float32;
+  Int _num_angles = 0;
+  Int _num_rays = 0;
+  int64_t _num_segments = 0;
+  double _length_scale = 0;
+
+  // Pointers into the memory-mapped file
+  unsigned char const * _params = nullptr;
+  int32_t const * _ray_offsets = nullptr;
+  int64_t const * _segment_offsets = nullptr;
+  int64_t const * _fsr_offsets = nullptr;
+  unsigned char const * _fsr_data = nullptr;
+  void const * _lengths = nullptr;
+
+public:
+  //============================================================================
+  // Constructors
+  //============================================================================
+
+  constexpr SegmentFile() noexcept = default;
+
+  explicit SegmentFile(String const & filename);
+
+  SegmentFile(SegmentFile const &) = delete;
+
+  SegmentFile(SegmentFile && other) noexcept;
+
+  auto
+  operator=(SegmentFile const &) -> SegmentFile & = delete;
+
+  auto
+  operator=(SegmentFile && other) noexcept -> SegmentFile &;
+
+  ~SegmentFile() noexcept;
+
+  //============================================================================
+  // Methods
+  //============================================================================
+
+  // Map the file and check that its header and offset tables are consistent
+  // with the file size. Report an error and leave the file closed otherwise.
+  void
+  open(String const & filename);
+
+  void
+  close() noexcept;
+
+  PURE [[nodiscard]] constexpr auto
+  isOpen() const noexcept -> bool
+  {
+    return _map != nullptr;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  lengthFormat() const noexcept -> SegmentLengthFormat
+  {
+    return _format;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numAngles() const noexcept -> Int
+  {
+    return _num_angles;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numRays() const noexcept -> Int
+  {
+    return _num_rays;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numSegments() const noexcept -> int64_t
+  {
+    return _num_segments;
+  }
+
+  // The rays of the ia-th angle are [getFirstRay(ia), getFirstRay(ia + 1)).
+  PURE [[nodiscard]] constexpr auto
+  getFirstRay(Int ia) const noexcept -> Int
+  {
+    ASSERT(0 <= ia);
+    ASSERT(ia <= _num_angles);
+    return _ray_offsets[ia];
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  numSegments(Int iray) const noexcept -> Int
+  {
+    ASSERT(0 <= iray);
+    ASSERT(iray < _num_rays);
+    return static_cast<Int>(_segment_offsets[iray + 1] - _segment_offsets[iray]);
+  }
+
+  PURE [[nodiscard]] auto
+  getParams(Int ia) const noexcept -> ModularRayParams<Float>;
+
+  // Decode the segments of the iray-th ray into fsr_ids and lengths, each of
+  // size >= numSegments(iray). Return the number of segments. Report an error
+  // and return 0 if the FSR IDs of the ray are corrupt.
+  auto
+  getRay(Int iray, Int * fsr_ids, Float * lengths) const noexcept -> Int;
+};
+
+} // namespace um2::mpact
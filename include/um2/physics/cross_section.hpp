@@ -1,8 +1,12 @@
 #pragma once
 
-#include <um2/math/matrix.hpp>
+#include <um2/math/banded_matrix.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/stdlib/assert.hpp>
 #include <um2/stdlib/vector.hpp>
 
+#include <initializer_list> // std::initializer_list
+
 //======================================================================
 // CROSS SECTION
 //======================================================================
@@ -15,38 +19,146 @@
 namespace um2
 {
 
-class XSec
+//======================================================================
+// GROUP VALUES
+//======================================================================
+// A non-owning view of the values of one reaction in each group.
+// T is Float or Float const. Assigning a list copies the values into the
+// viewed memory, so xs.a() = {...} works as it would for a Vector.
+
+template <class T>
+class GroupValues
 {
+  T * _data = nullptr;
+  Int _size = 0;
+
+public:
+  constexpr GroupValues(T * data, Int size) noexcept
+      : _data(data),
+        _size(size)
+  {
+  }
+
+  // Assignment would rebind the view instead of copying the values.
+  constexpr GroupValues(GroupValues const &) noexcept = default;
+  constexpr GroupValues(GroupValues &&) noexcept = default;
+  auto
+  operator=(GroupValues const &) -> GroupValues & = delete;
+  auto
+  operator=(GroupValues &&) -> GroupValues & = delete;
+  constexpr ~GroupValues() noexcept = default;
+
+  constexpr auto
+  operator=(std::initializer_list<Float> values) noexcept -> GroupValues &
+  {
+    ASSERT(static_cast<Int>(values.size()) == _size);
+    Int i = 0;
+    for (auto const v : values) {
+      _data[i++] = v;
+    }
+    return *this;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  size() const noexcept -> Int
+  {
+    return _size;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  empty() const noexcept -> bool
+  {
+    return _size == 0;
+  }
 
+  PURE [[nodiscard]] constexpr auto
+  data() const noexcept -> T *
+  {
+    return _data;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  begin() const noexcept -> T *
+  {
+    return _data;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  end() const noexcept -> T *
+  {
+    return _data + _size;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  cbegin() const noexcept -> T const *
+  {
+    return _data;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  cend() const noexcept -> T const *
+  {
+    return _data + _size;
+  }
+
+  PURE [[nodiscard]] constexpr auto
+  operator[](Int i) const noexcept -> T &
+  {
+    ASSERT_ASSUME(0 <= i);
+    ASSERT(i < _size);
+    return _data[i];
+  }
+};
+
+class XSec
+{
+public:
+  // The per-group reactions (a, f, nuf, tr, s) are stored in one buffer of
+  // SIMD vectors of 64 bytes. Each reaction is padded to a whole number of
+  // vectors, so every reaction starts on a 64-byte boundary and the arithmetic
+  // below works on whole vectors. The padding is always zero.
+  static constexpr Int block_size = 64 / static_cast<Int>(sizeof(Float));
+  static constexpr Int num_reactions = 5;
+  using Block = Vec<block_size, Float>;
+
+private:
   bool _is_macroscopic = false;
   bool _is_fissile = false;
   Int _num_groups = 0;
-  Vector<Float> _a;   // Absorption cross section
-  Vector<Float> _f;   // Fission cross section
-  Vector<Float> _nuf; // nu * fission cross section
-  Vector<Float> _tr;  // Transport cross section
-  Vector<Float> _s;   // Total scattering cross section.
-                      // s(g) = sum_{g'=0}^{G-1} \sigma_{s}(g -> g')
-                      // This is the sum of column(g) of the scattering matrix.
-  Matrix<Float> _ss;  // Scattering matrix _ss(i, j) = \sigma_{s}(j -> i)
-                      // A multiplication with a flux vector will give
-                      // the scattering source. _ss * phi = q_s
+  Int _num_blocks = 0; // Blocks per reaction
+  Vector<Block> _data; // a, f, nuf, tr, s, each of size _num_blocks
+                       // a:   Absorption cross section
+                       // f:   Fission cross section
+                       // nuf: nu * fission cross section
+                       // tr:  Transport cross section
+                       // s:   Total scattering cross section.
+                       //      s(g) = sum_{g'=0}^{G-1} \sigma_{s}(g -> g')
+                       //      This is the sum of column(g) of the scattering
+                       //      matrix.
+  BandedMatrix<Float> _ss; // Scattering matrix _ss(i, j) = \sigma_{s}(j -> i)
+                           // A multiplication with a flux vector will give
+                           // the scattering source. _ss * phi = q_s
+                           // Only a band of source groups is stored for each
+                           // destination group, since most entries are zero.
+
+  PURE [[nodiscard]] auto
+  reaction(Int r) noexcept -> Float *;
+
+  PURE [[nodiscard]] auto
+  reaction(Int r) const noexcept -> Float const *;
 
 public:
   //======================================================================
   // Constructors
   //======================================================================
 
-  constexpr XSec() noexcept = default;
+  XSec() noexcept = default;
 
   explicit XSec(Int num_groups) noexcept
       : _num_groups(num_groups),
-        _a(num_groups, 0.0),
-        _f(num_groups, 0.0),
-        _nuf(num_groups, 0.0),
-        _tr(num_groups, 0.0),
-        _s(num_groups, 0.0),
-        _ss(num_groups, num_groups, 0.0)
+        _num_blocks((num_groups + block_size - 1) / block_size),
+        _data(num_reactions * _num_blocks, Block::zero()),
+        _ss(num_groups, num_groups)
   {
   }
 
@@ -69,69 +181,100 @@ public:
   PURE [[nodiscard]] constexpr auto
   isFissile() const noexcept -> bool;
 
-  PURE [[nodiscard]] constexpr auto
-  a() noexcept -> Vector<Float> &;
+  PURE [[nodiscard]] auto
+  a() noexcept -> GroupValues<Float>;
 
-  PURE [[nodiscard]] constexpr auto
-  a() const noexcept -> Vector<Float> const &;
+  PURE [[nodiscard]] auto
+  a() const noexcept -> GroupValues<Float const>;
 
-  PURE [[nodiscard]] constexpr auto
-  f() noexcept -> Vector<Float> &;
+  PURE [[nodiscard]] auto
+  f() noexcept -> GroupValues<Float>;
 
-  PURE [[nodiscard]] constexpr auto
-  f() const noexcept -> Vector<Float> const &;
+  PURE [[nodiscard]] auto
+  f() const noexcept -> GroupValues<Float const>;
 
-  PURE [[nodiscard]] constexpr auto
-  nuf() noexcept -> Vector<Float> &;
+  PURE [[nodiscard]] auto
+  nuf() noexcept -> GroupValues<Float>;
 
-  PURE [[nodiscard]] constexpr auto
-  nuf() const noexcept -> Vector<Float> const &;
+  PURE [[nodiscard]] auto
+  nuf() const noexcept -> GroupValues<Float const>;
 
-  PURE [[nodiscard]] constexpr auto
-  tr() noexcept -> Vector<Float> &;
+  PURE [[nodiscard]] auto
+  tr() noexcept -> GroupValues<Float>;
 
-  PURE [[nodiscard]] constexpr auto
-  tr() const noexcept -> Vector<Float> const &;
+  PURE [[nodiscard]] auto
+  tr() const noexcept -> GroupValues<Float const>;
 
-  PURE [[nodiscard]] constexpr auto
-  s() noexcept -> Vector<Float> &;
+  PURE [[nodiscard]] auto
+  s() noexcept -> GroupValues<Float>;
 
-  PURE [[nodiscard]] constexpr auto
-  s() const noexcept -> Vector<Float> const &;
+  PURE [[nodiscard]] auto
+  s() const noexcept -> GroupValues<Float const>;
 
   PURE [[nodiscard]] constexpr auto
-  ss() noexcept -> Matrix<Float> &;
+  ss() noexcept -> BandedMatrix<Float> &;
 
   PURE [[nodiscard]] constexpr auto
-  ss() const noexcept -> Matrix<Float> const &;
+  ss() const noexcept -> BandedMatrix<Float> const &;
 
   //======================================================================
   // Methods
   //======================================================================
 
-  PURE [[nodiscard]] constexpr auto
+  PURE [[nodiscard]] auto
   t(Int g) const noexcept -> Float
   {
     ASSERT(0 <= g);
     ASSERT(g < _num_groups);
-    return _a[g] + _s[g];
+    return a()[g] + s()[g];
   }
 
   void
   validate() const noexcept;
 
+  // The arithmetic below acts on every reaction and the scattering matrix,
+  // whose band is widened to hold the bands of the operands. The flags are
+  // left to the caller.
+
+  // this += a * x
+  void
+  axpy(Float a, XSec const & x) noexcept;
+
+  // this *= scalar
+  auto
+  operator*=(Float scalar) noexcept -> XSec &;
+
+  // this += a * (x0 + d * (x1 - x0)), the linear interpolation between x0
+  // and x1, scaled by a.
+  void
+  addLerp(Float a, Float d, XSec const & x0, XSec const & x1) noexcept;
+
+  // The scattering source q[g] = sum_{g'} \sigma_{s}(g' -> g) * phi[g']
+  void
+  scatteringSource(Float const * phi, Float * q) const noexcept;
+
   // Get the 1-group "average" cross section
   // Takes the arithmetic mean of the values in each group
   // NOTE: this is not a replacement for a one-group cross section, which
   // should perform a weighted sum which preserve the total reaction rate.
   PURE [[nodiscard]] auto
   collapseTo1GroupAvg() const noexcept -> XSec;
+
+  friend auto
+  weightedSum(Int n, XSec const * const * xsecs, Float const * weights) noexcept
+      -> XSec;
 }; // class XS
 
 //======================================================================
 // Free functions
 //======================================================================
 
+// sum_k weights[k] * xsecs[k] for k in [0, n), in one pass over the result.
+// The cross sections must have the same number of groups. The flags of the
+// result are false.
+[[nodiscard]] auto
+weightedSum(Int n, XSec const * const * xsecs, Float const * weights) noexcept -> XSec;
+
 PURE [[nodiscard]] auto
 getC5G7XSecs() noexcept -> Vector<XSec>;
 
@@ -169,74 +312,96 @@ XSec::isFissile() const noexcept -> bool
   return _is_fissile;
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::a() noexcept -> Vector<Float> &
+PURE [[nodiscard]] inline auto
+XSec::reaction(Int const r) noexcept -> Float *
 {
-  return _a;
+  ASSERT_ASSUME(0 <= r);
+  ASSERT(r < num_reactions);
+  if (_data.empty()) {
+    return nullptr;
+  }
+  return _data[r * _num_blocks].begin();
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::a() const noexcept -> Vector<Float> const &
+PURE [[nodiscard]] inline auto
+XSec::reaction(Int const r) const noexcept -> Float const *
 {
-  return _a;
+  ASSERT_ASSUME(0 <= r);
+  ASSERT(r < num_reactions);
+  if (_data.empty()) {
+    return nullptr;
+  }
+  return _data[r * _num_blocks].begin();
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::f() noexcept -> Vector<Float> &
+PURE [[nodiscard]] inline auto
+XSec::a() noexcept -> GroupValues<Float>
 {
-  return _f;
+  return {reaction(0), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::f() const noexcept -> Vector<Float> const &
+PURE [[nodiscard]] inline auto
+XSec::a() const noexcept -> GroupValues<Float const>
 {
-  return _f;
+  return {reaction(0), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::nuf() noexcept -> Vector<Float> &
+PURE [[nodiscard]] inline auto
+XSec::f() noexcept -> GroupValues<Float>
 {
-  return _nuf;
+  return {reaction(1), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::nuf() const noexcept -> Vector<Float> const &
+PURE [[nodiscard]] inline auto
+XSec::f() const noexcept -> GroupValues<Float const>
 {
-  return _nuf;
+  return {reaction(1), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::tr() noexcept -> Vector<Float> &
+PURE [[nodiscard]] inline auto
+XSec::nuf() noexcept -> GroupValues<Float>
 {
-  return _tr;
+  return {reaction(2), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::tr() const noexcept -> Vector<Float> const &
+PURE [[nodiscard]] inline auto
+XSec::nuf() const noexcept -> GroupValues<Float const>
 {
-  return _tr;
+  return {reaction(2), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::s() noexcept -> Vector<Float> &
+PURE [[nodiscard]] inline auto
+XSec::tr() noexcept -> GroupValues<Float>
 {
-  return _s;
+  return {reaction(3), _num_groups};
 }
 
-PURE [[nodiscard]] constexpr auto
-XSec::s() const noexcept -> Vector<Float> const &
+PURE [[nodiscard]] inline auto
+XSec::tr() const noexcept -> GroupValues<Float const>
+{
+  return {reaction(3), _num_groups};
+}
+
+PURE [[nodiscard]] inline auto
+XSec::s() noexcept -> GroupValues<Float>
+{
+  return {reaction(4), _num_groups};
+}
+
+PURE [[nodiscard]] inline auto
+XSec::s() const noexcept -> GroupValues<Float const>
 {
-  return _s;
+  return {reaction(4), _num_groups};
 }
 
 PURE [[nodiscard]] constexpr auto
-XSec::ss() noexcept -> Matrix<Float> &
+XSec::ss() noexcept -> BandedMatrix<Float> &
 {
   return _ss;
 }
 
 PURE [[nodiscard]] constexpr auto
-XSec::ss() const noexcept -> Matrix<Float> const &
+XSec::ss() const noexcept -> BandedMatrix<Float> const &
 {
   return _ss;
 }
@@ -10,6 +10,21 @@
 // The cross section library is collection of nuclides, each of which
 // have a microscopic XSec object. The nuclides are grouped by
 // temperature.
+//
+// Parsing an ASCII library takes seconds for the larger libraries. Hence,
+// when settings::xs::use_library_cache is true, the parsed library is saved
+// to a binary cache next to the library file (see xsLibraryCacheFilename),
+// and later constructions from the same file memory-map the cache instead.
+// The cache records the size and modification time of the library file it was
+// made from, the sizes of Int and Float, and a checksum of its contents. If
+// any of these do not match, the cache is ignored and rewritten.
+//
+// A model typically uses a few dozen of the hundreds of nuclides in a library.
+// A lazy library reads only the ZAID, mass, and temperatures of each nuclide
+// up front. The cross sections of a nuclide are read from the library file
+// the first time the nuclide is requested through getNuclide. Until then, the
+// nuclide in nuclides() has no cross sections and is not marked fissile. The
+// binary cache is not used by a lazy library.
 
 namespace um2
 {
@@ -26,17 +41,36 @@ class XSLibrary
 
   Vector<Float> _group_bounds; // Energy bounds. size = numGroups()
   Vector<Float> _chi;          // Fission spectrum. size = numGroups()
-  Vector<Nuclide> _nuclides;
+  // Mutable so that a lazy library can read nuclides in getNuclide.
+  mutable Vector<Nuclide> _nuclides;
+
+  // Open addressing hash table from ZAID to nuclide index. -1 is an empty
+  // slot. The size is a power of 2, at least twice the number of nuclides.
+  Vector<Int> _zaid_table;
+
+  // Lazy loading. _xs_offsets[i] is the offset of the cross section data of
+  // nuclide i in _filename. Empty if the library is not lazy.
+  String _filename;
+  Vector<int64_t> _xs_offsets;
+  mutable Vector<int8_t> _is_loaded;
+
+  void
+  rebuildZAIDTable();
+
+  // Read the cross sections of nuclide i if the library is lazy and they have
+  // not been read yet.
+  void
+  loadNuclide(Int i) const;
 
 public:
   //======================================================================
   // Constructors
   //======================================================================
 
-  constexpr XSLibrary() noexcept = default;
+  XSLibrary() noexcept = default;
 
   // NOLINTNEXTLINE(google-explicit-constructor)
-  XSLibrary(String const & filename);
+  XSLibrary(String const & filename, bool lazy = false);
 
   //======================================================================
   // Accessors
@@ -88,8 +122,40 @@ public:
   // Methods
   //===========================================================================
 
+  PURE [[nodiscard]] constexpr auto
+  isLazy() const noexcept -> bool
+  {
+    return !_xs_offsets.empty();
+  }
+
+  // Return the index of the nuclide in nuclides(), or -1 if the library does not
+  // contain the nuclide.
   PURE [[nodiscard]] auto
+  getNuclideIndex(Int zaid) const noexcept -> Int;
+
+  // Return the nuclide, reading its cross sections first if the library is lazy.
+  [[nodiscard]] auto
   getNuclide(Int zaid) const noexcept -> Nuclide const &;
+
+  // Write the library to a binary cache, recording the library file it was
+  // read from. Returns false if the cache could not be written.
+  auto
+  writeCache(String const & cache_filename, String const & source_filename) const
+      -> bool;
+
+  // Read the library from a binary cache. Returns false, leaving the library
+  // unchanged, if the cache does not exist or is out of date with respect to
+  // the library file.
+  auto
+  readCache(String const & cache_filename, String const & source_filename) -> bool;
 };
 
+//======================================================================
+// Free functions
+//======================================================================
+
+// The binary cache of the library file: the filename with ".um2cache" appended.
+PURE auto
+xsLibraryCacheFilename(String const & filename) -> String;
+
 } // namespace um2
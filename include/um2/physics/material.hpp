@@ -203,4 +203,9 @@ public:
 PURE auto
 getC5G7Materials() noexcept -> Vector<Material>;
 
+// Populate the cross sections of many materials at once, in parallel. Each
+// material is evaluated at its own temperature, as in Material::populateXSec.
+void
+populateXSec(Vector<Material> & materials, XSLibrary const & xsec_lib) noexcept;
+
 } // namespace um2
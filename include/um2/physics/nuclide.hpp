@@ -107,9 +107,15 @@ public:
   void
   validate() const noexcept;
 
+  // Interpolate the cross sections to the temperature, linearly in the sqrt
+  // of temperature. Temperatures outside the range of the data are clamped.
   PURE [[nodiscard]] auto
   interpXS(Float temperature) const noexcept -> XSec;
 
+  // xs += scale * interpXS(temperature), without the temporary XSec.
+  void
+  addInterpXS(Float temperature, Float scale, XSec & xs) const noexcept;
+
 }; // class Nuclide
 
 //======================================================================
@@ -60,6 +60,10 @@ void
 um2MPACTNumLattices(void * model, Int * n);
 void
 um2MPACTNumAssemblies(void * model, Int * n);
+void
+um2MPACTNumCoarseCellsTotal(void * model, Int * n);
+void
+um2MPACTNumFineCellsTotal(void * model, Int * n);
 
 // NumCells
 //------------------------------------------------------------------------------
@@ -122,6 +126,23 @@ um2MPACTRTMWidth(void * model, Int rtm_id, Float * width);
 void
 um2MPACTRTMHeight(void * model, Int rtm_id, Float * height);
 
+// Point location
+//------------------------------------------------------------------------------
+void
+um2MPACTFindFSR(void * model, Float x, Float y, Float z, Int * fsr_id);
+
+void
+um2MPACTFindFSRs(void * model, Int n, Float const * xyz, Int * fsr_ids);
+
+// Global fine cell (FSR) indices
+// An invalid FSR ID or instance is reported and the outputs are set to -1.
+//------------------------------------------------------------------------------
+void
+um2MPACTFSRCoarseCell(void * model, Int fsr_id, Int * cc_id, Int * face_id);
+
+void
+um2MPACTCoarseCellInstanceFSROffset(void * model, Int instance, Int * fsr_offset);
+
 // Heights
 //-----------------------------------------------------------------------------
 void
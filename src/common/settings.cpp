@@ -28,6 +28,16 @@ namespace um2::settings::xs
 {
 String library_path = defaults::LIBRARY_PATH;
 String library_name = defaults::LIBRARY_NAME;
+bool use_library_cache = defaults::use_library_cache;
 } // namespace um2::settings::xs
 
+//==============================================================================
+// MESH
+//==============================================================================
+
+namespace um2::settings::mesh
+{
+SpaceFillingCurve space_filling_curve = defaults::space_filling_curve;
+} // namespace um2::settings::mesh
+
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
@@ -1,13 +1,16 @@
 #include <um2/config.hpp>
 #include <um2/mesh/element_types.hpp>
 #include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mesh/packed_face_vertex_mesh.hpp>
 #include <um2/mesh/polytope_soup.hpp>
 
 #include <um2/common/logger.hpp>
 #include <um2/common/permutation.hpp>
-#include <um2/geometry/morton_sort_points.hpp>
+#include <um2/geometry/space_filling_curve_sort.hpp>
 #include <um2/geometry/point.hpp>
 #include <um2/math/vec.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/algorithm/min.hpp>
 #include <um2/stdlib/assert.hpp>
 #include <um2/stdlib/math/abs.hpp>
 #include <um2/stdlib/utility/pair.hpp>
@@ -68,23 +71,29 @@ FaceVertexMesh<P, N>::FaceVertexMesh(PolytopeSoup const & soup, bool validate)
   }
 
   // -- Vertices --
-  // Ensure each of the vertices has approximately the same z
+  // Drop z, then ensure each of the vertices has approximately the same z
+  auto const & soup_vertices = soup.vertices();
   _v.resize(num_vertices);
-  Float const z = soup.getVertex(0)[2];
   for (Int i = 0; i < num_vertices; ++i) {
-    auto const & p = soup.getVertex(i);
-    _v[i][0] = p[0];
-    _v[i][1] = p[1];
-    if (um2::abs(p[2] - z) > epsDistance<Float>()) {
-      LOG_WARN(
-          "Constructing a FaceVertexMesh from a PolytopeSoup with non-planar vertices");
-      break;
-    }
+    _v[i][0] = soup_vertices[i][0];
+    _v[i][1] = soup_vertices[i][1];
+  }
+  Float const z = soup_vertices[0][2];
+  Float z_min = z;
+  Float z_max = z;
+  for (Int i = 0; i < num_vertices; ++i) {
+    z_min = um2::min(z_min, soup_vertices[i][2]);
+    z_max = um2::max(z_max, soup_vertices[i][2]);
+  }
+  if (z_max - z_min > epsDistance<Float>()) {
+    LOG_WARN("Constructing a FaceVertexMesh from a PolytopeSoup with non-planar vertices");
   }
 
   // -- Face/Vertex connectivity --
+  // The soup is homogeneous, so the connectivity is N vertex IDs per face.
   _fv.resize(num_faces);
   auto const & soup_conn = soup.elementConnectivity();
+  ASSERT(soup_conn.size() == N * num_faces);
   for (Int i = 0; i < num_faces; ++i) {
     for (Int j = 0; j < N; ++j) {
       _fv[i][j] = soup_conn[i * N + j];
@@ -95,77 +104,115 @@ FaceVertexMesh<P, N>::FaceVertexMesh(PolytopeSoup const & soup, bool validate)
   }
 }
 
+template <Int P, Int N>
+FaceVertexMesh<P, N>::FaceVertexMesh(PolytopeSoup && soup, bool validate)
+    : FaceVertexMesh(static_cast<PolytopeSoup const &>(soup), validate)
+{
+  // Release the memory of the soup as soon as the mesh is made.
+  soup = PolytopeSoup();
+}
+
 //==============================================================================
 // Modifiers
 //==============================================================================
 
 template <Int P, Int N>
-void
-FaceVertexMesh<P, N>::mortonSort() noexcept
+auto
+FaceVertexMesh<P, N>::spaceFillingCurveSort(SpaceFillingCurve const curve) noexcept
+    -> Vector<Int>
 {
-  LOG_DEBUG("Sorting vertices and faces using morton encoding");
+  LOG_DEBUG("Sorting vertices and faces along a space-filling curve");
   // If the mesh had vertex-face connectivity, need to invalidate it, then
   // recompute it.
   bool const had_vf = _has_vf;
-  mortonSortVertices();
-  mortonSortFaces();
-  _is_morton_ordered = true;
+  bool const had_ff = _has_ff;
+  bool const had_bvh = _has_bvh;
+  bool const had_edge_cache = _has_edge_cache;
+  spaceFillingCurveSortVertices(curve);
+  Vector<Int> perm = spaceFillingCurveSortFaces(curve);
+  _is_curve_ordered = true;
   if (had_vf) {
     populateVF();
   }
+  if (had_ff) {
+    populateFF();
+  }
+  if (had_bvh) {
+    populateBVH();
+  }
+  if constexpr (P == 2) {
+    if (had_edge_cache) {
+      populateEdgeCache();
+    }
+  }
+  return perm;
 }
 
 template <Int P, Int N>
-void
-FaceVertexMesh<P, N>::mortonSortFaces() noexcept
+auto
+FaceVertexMesh<P, N>::spaceFillingCurveSortFaces(SpaceFillingCurve const curve) noexcept
+    -> Vector<Int>
 {
-  // Invalidate vertex-face connectivity.
+  // Invalidate the connectivity, the bounding volume hierarchy, and the edge cache.
   _has_vf = false;
+  _has_ff = false;
+  _has_bvh = false;
+  _has_edge_cache = false;
 
-  // Sort the centroid of each face using the morton encoding.
+  // Sort the centroid of each face along the curve.
   Int const num_faces = numFaces();
   Vector<Point2F> centroids(num_faces);
-  for (Int i = 0; i < num_faces; ++i) {
-    centroids[i] = getFace(i).centroid();
-  }
-  // We need to scale the centroids to the unit cube before we can apply
-  // the morton encoding. Therefore we need to find the bounding box of
-  // all faces.
+  faceCentroids(centroids.data());
+  // We need to scale the centroids to the unit square before we can encode
+  // them. Therefore we need to find the bounding box of all faces.
   auto const aabb = boundingBox();
   Vec2F const inv_scale = 1 / aabb.extents();
 
-  // Get the permutation vector which sorts the centroids according to the morton
-  // encoding.
+  // Get the permutation vector which sorts the centroids along the curve.
   Vector<Int> perm(num_faces);
-  mortonSortPermutation(centroids.begin(), centroids.end(), perm.begin(), inv_scale);
+  spaceFillingCurveSortPermutation(curve, centroids.cbegin(), centroids.cend(),
+                                   perm.begin(), aabb.minima(), inv_scale);
 
-  // Sort the faces according to the permutation vector.
-  applyPermutation(_fv.begin(), _fv.end(), perm.cbegin());
+  // Sort the faces according to the permutation vector. Gathering into a new
+  // vector is a single pass, unlike applying the permutation in-place.
+  Vector<FaceConn> sorted_fv(num_faces);
+  for (Int i = 0; i < num_faces; ++i) {
+    sorted_fv[i] = _fv[perm[i]];
+  }
+  _fv = um2::move(sorted_fv);
+  return perm;
 }
 
 template <Int P, Int N>
 void
-FaceVertexMesh<P, N>::mortonSortVertices() noexcept
+FaceVertexMesh<P, N>::spaceFillingCurveSortVertices(SpaceFillingCurve const curve) noexcept
 {
-  // Invalidate vertex-face connectivity
+  // Invalidate the connectivity, the bounding volume hierarchy, and the edge cache.
   _has_vf = false;
+  _has_ff = false;
+  _has_bvh = false;
+  _has_edge_cache = false;
 
-  // We need to scale the vertices to the unit cube before we can apply
-  // the morton encoding.
+  // We need to scale the vertices to the unit square before we can encode them.
   auto const aabb = boundingBox();
   Vec2F const inv_scale = 1 / aabb.extents();
 
-  // Get the permutation vector which sorts the vertices according to the morton
-  // encoding. We also need the inverse permutation to ensure that the face-vertex
+  // Get the permutation vector which sorts the vertices along the curve. We
+  // also need the inverse permutation to ensure that the face-vertex
   // connectivity is maintained.
   Int const num_verts = numVertices();
   Vector<Int> perm(num_verts);
   Vector<Int> inv_perm(num_verts);
-  mortonSortPermutation(_v.cbegin(), _v.cend(), perm.begin(), inv_scale);
+  spaceFillingCurveSortPermutation(curve, _v.cbegin(), _v.cend(), perm.begin(),
+                                   aabb.minima(), inv_scale);
   invertPermutation(perm.cbegin(), perm.cend(), inv_perm.begin());
 
   // Sort the vertices according to the permutation vector.
-  applyPermutation(_v.begin(), _v.end(), perm.cbegin());
+  Vector<Vertex> sorted_v(num_verts);
+  for (Int i = 0; i < num_verts; ++i) {
+    sorted_v[i] = _v[perm[i]];
+  }
+  _v = um2::move(sorted_v);
 
   // Map the old vertex indices to the new vertex indices.
   for (auto & face : _fv) {
@@ -175,6 +222,48 @@ FaceVertexMesh<P, N>::mortonSortVertices() noexcept
   }
 }
 
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::mortonSort() noexcept
+{
+  spaceFillingCurveSort(SpaceFillingCurve::Morton);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::mortonSortFaces() noexcept
+{
+  spaceFillingCurveSortFaces(SpaceFillingCurve::Morton);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::mortonSortVertices() noexcept
+{
+  spaceFillingCurveSortVertices(SpaceFillingCurve::Morton);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::hilbertSort() noexcept
+{
+  spaceFillingCurveSort(SpaceFillingCurve::Hilbert);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::hilbertSortFaces() noexcept
+{
+  spaceFillingCurveSortFaces(SpaceFillingCurve::Hilbert);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::hilbertSortVertices() noexcept
+{
+  spaceFillingCurveSortVertices(SpaceFillingCurve::Hilbert);
+}
+
 template <Int P, Int N>
 void
 FaceVertexMesh<P, N>::populateVF() noexcept
@@ -216,31 +305,433 @@ FaceVertexMesh<P, N>::populateVF() noexcept
   _has_vf = true;
 }
 
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::populateFF() noexcept
+{
+  if (!_has_vf) {
+    populateVF();
+  }
+  Int const num_faces = numFaces();
+  Int constexpr num_edges = polygonNumEdges<P, N>();
+
+  // Edge (v0, v1) of face i is shared with the face containing edge (v1, v0).
+  // That face must be in the vertex-face list of v0, so the search is linear in
+  // the number of faces for bounded vertex valence.
+  _ff.resize(num_faces * num_edges);
+  _boundary_edges.clear();
+  for (Int iface = 0; iface < num_faces; ++iface) {
+    for (Int iedge = 0; iedge < num_edges; ++iedge) {
+      auto const edge_conn = getEdgeConn(iface, iedge);
+      Vec2I adj(-1, -1);
+      Int const v0 = edge_conn[0];
+      Int const v1 = edge_conn[1];
+      for (Int i = _vf_offsets[v0]; i < _vf_offsets[v0 + 1] && adj[0] == -1; ++i) {
+        Int const jface = _vf[i];
+        if (jface == iface) {
+          continue;
+        }
+        for (Int jedge = 0; jedge < num_edges; ++jedge) {
+          auto const other_conn = getEdgeConn(jface, jedge);
+          if (other_conn[0] == v1 && other_conn[1] == v0) {
+            adj = Vec2I(jface, jedge);
+            break;
+          }
+        }
+      }
+      _ff[iface * num_edges + iedge] = adj;
+      if (adj[0] == -1) {
+        _boundary_edges.emplace_back(iface, iedge);
+      }
+    }
+  }
+  _has_ff = true;
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::populateBVH(Int const leaf_size) noexcept
+{
+  ASSERT(leaf_size > 0);
+  if (!_is_curve_ordered) {
+    LOG_DEBUG("Building a BVH over faces which are not sorted along a curve");
+  }
+  Int const num_faces = numFaces();
+
+  // Find the smallest depth such that each leaf holds at most leaf_size faces.
+  _bvh_depth = 0;
+  while (leaf_size * (static_cast<int64_t>(1) << _bvh_depth) < num_faces) {
+    ++_bvh_depth;
+  }
+  Int const first_leaf = (1 << _bvh_depth) - 1;
+  Int const num_nodes = 2 * first_leaf + 1;
+
+  // Split the face range of each node in half between its children.
+  Vector<Vec2I> ranges(num_nodes);
+  ranges[0] = Vec2I(0, num_faces);
+  for (Int i = 0; i < first_leaf; ++i) {
+    Int const first = ranges[i][0];
+    Int const last = ranges[i][1];
+    Int const mid = first + (last - first) / 2;
+    ranges[2 * i + 1] = Vec2I(first, mid);
+    ranges[2 * i + 2] = Vec2I(mid, last);
+  }
+
+  // Bound the faces in each leaf. The boxes are padded by epsDistance so that
+  // grazing intersections found by the brute-force search are not culled.
+  Vector<AxisAlignedBox2F> face_boxes(num_faces);
+  PackedFaceVertexMesh<P, N>(*this).faceBoundingBoxes(face_boxes.data());
+  _bvh.resize(num_nodes);
+  Point2F const pad(epsDistance<Float>(), epsDistance<Float>());
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = first_leaf; i < num_nodes; ++i) {
+    auto box = AxisAlignedBox2F::empty();
+    for (Int iface = ranges[i][0]; iface < ranges[i][1]; ++iface) {
+      box += face_boxes[iface];
+    }
+    _bvh[i] = AxisAlignedBox2F(box.minima() - pad, box.maxima() + pad);
+  }
+
+  // Bound the children of each interior node, from the bottom up.
+  for (Int i = first_leaf - 1; i >= 0; --i) {
+    _bvh[i] = _bvh[2 * i + 1] + _bvh[2 * i + 2];
+  }
+  _has_bvh = true;
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::populateEdgeCache() noexcept
+  requires(P == 2)
+{
+  Int constexpr num_edges = polygonNumEdges<P, N>();
+  Int const num_faces = numFaces();
+  _edge_cache.resize(num_faces * num_edges);
+  // As with the BVH, pad the boxes so that grazing intersections are not culled.
+  Point2F const pad(epsDistance<Float>(), epsDistance<Float>());
+  for (Int iface = 0; iface < num_faces; ++iface) {
+    for (Int iedge = 0; iedge < num_edges; ++iedge) {
+      auto const edge = getEdge(iface, iedge);
+      auto & cache = _edge_cache[iface * num_edges + iedge];
+      cache.is_straight = isStraight(edge);
+      if (cache.is_straight) {
+        cache.coeffs = Vec<3, Vec2F>(edge[0], edge[1], Vec2F::zero());
+      } else {
+        cache.coeffs = edge.getPolyCoeffs();
+      }
+      auto const box = edge.boundingBox();
+      cache.box = AxisAlignedBox2F(box.minima() - pad, box.maxima() + pad);
+    }
+  }
+  _has_edge_cache = true;
+}
+
 //==============================================================================
 // Methods
 //==============================================================================
 
+template <Int P, Int N>
+auto
+FaceVertexMesh<P, N>::intersectWalk(Ray2F const ray, Float * coords,
+                                    Int * RESTRICT offsets,
+                                    Int * RESTRICT faces) const noexcept -> Vec2I
+{
+  ASSERT(_has_ff);
+  Int constexpr num_edges = polygonNumEdges<P, N>();
+  Float constexpr eps = epsDistance<Float>();
+  auto const inv_dir = ray.inverseDirection();
+  Float buffer[2] = {};
+
+  // Find the closest intersection of the ray with an edge of the face, beyond
+  // r_min. Return the local edge index, or -1 if there is no such edge.
+  auto const exit_edge = [&](Int const iface, Float const r_min, Float & r_exit) {
+    Int iexit = -1;
+    r_exit = infDistance<Float>();
+    for (Int iedge = 0; iedge < num_edges; ++iedge) {
+      Int const hits = intersectEdge(iface, iedge, ray, inv_dir, buffer);
+      for (Int i = 0; i < hits; ++i) {
+        if (r_min < buffer[i] && buffer[i] < r_exit) {
+          r_exit = buffer[i];
+          iexit = iedge;
+        }
+      }
+    }
+    return iexit;
+  };
+
+  // If the ray passes through a vertex, the face across the exit edge may only
+  // be touched by the ray. Find the face sharing a vertex with iface which the
+  // ray enters at r, or -1 if the ray leaves the mesh at r.
+  auto const face_at_vertex = [&](Int const iface, Float const r) {
+    Int inext = -1;
+    Float r_next = infDistance<Float>();
+    for (Int j = 0; j < N; ++j) {
+      Int const vid = _fv[iface][j];
+      for (Int i = _vf_offsets[vid]; i < _vf_offsets[vid + 1]; ++i) {
+        Int const jface = _vf[i];
+        if (jface == iface) {
+          continue;
+        }
+        Float r_exit = 0;
+        bool enters = false;
+        for (Int iedge = 0; iedge < num_edges; ++iedge) {
+          Int const hits = intersectEdge(jface, iedge, ray, inv_dir, buffer);
+          for (Int k = 0; k < hits; ++k) {
+            enters = enters || um2::abs(buffer[k] - r) < eps;
+          }
+        }
+        if (enters && exit_edge(jface, r + eps, r_exit) != -1 && r_exit < r_next) {
+          r_next = r_exit;
+          inext = jface;
+        }
+      }
+    }
+    return inext;
+  };
+
+  *offsets++ = 0;
+  Int total_hits = 0;
+  Int num_faces = 0;
+  Float r_min = -eps;
+  while (true) {
+    // Enter the mesh through the closest boundary edge beyond r_min.
+    Int iface = -1;
+    Float r = infDistance<Float>();
+    for (auto const & boundary_edge : _boundary_edges) {
+      Int const hits =
+          intersectEdge(boundary_edge[0], boundary_edge[1], ray, inv_dir, buffer);
+      for (Int i = 0; i < hits; ++i) {
+        if (r_min < buffer[i] && buffer[i] < r) {
+          r = buffer[i];
+          iface = boundary_edge[0];
+        }
+      }
+    }
+    if (iface == -1) {
+      break;
+    }
+
+    // Walk through the mesh until the ray exits through a boundary edge.
+    while (iface != -1) {
+      Float r_exit = 0;
+      Int const iedge = exit_edge(iface, r + eps, r_exit);
+      if (iedge == -1) {
+        iface = face_at_vertex(iface, r);
+        continue;
+      }
+      coords[total_hits] = r;
+      coords[total_hits + 1] = r_exit;
+      total_hits += 2;
+      ++num_faces;
+      *offsets++ = total_hits;
+      *faces++ = iface;
+      r = r_exit;
+      iface = _ff[iface * num_edges + iedge][0];
+    }
+    r_min = r + eps;
+  }
+  return {total_hits, num_faces};
+}
+
+namespace
+{
+
+Int constexpr ray_packet_size = 32 / static_cast<Int>(sizeof(Float));
+
+// Whether the n rays have exactly the same direction, so that they can be
+// intersected as a packet with the same result as one at a time.
+PURE auto
+sameDirection(Ray2F const * rays, Int const n) noexcept -> bool
+{
+  auto const d = rays[0].direction();
+  for (Int i = 1; i < n; ++i) {
+    auto const di = rays[i].direction();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+    // NOLINTNEXTLINE(clang-diagnostic-float-equal)
+    if (di[0] != d[0] || di[1] != d[1]) {
+      return false;
+    }
+#pragma GCC diagnostic pop
+  }
+  return true;
+}
+
+} // namespace
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::intersect(Vector<Ray2F> const & rays,
+                                RayMeshIntersections & out) const noexcept
+{
+  Int const num_rays = rays.size();
+  Int const num_faces = numFaces();
+  // A linear edge may write a coordinate even if it is missed, and a quadratic
+  // edge may be intersected twice.
+  Int const max_hits = (P * N + 1) * num_faces;
+
+#if UM2_USE_OPENMP
+  Int const num_threads = static_cast<Int>(omp_get_max_threads());
+#else
+  Int const num_threads = 1;
+#endif
+  // Linear meshes intersect rays with a common direction in packets, which
+  // fill a 256-bit vector register.
+  Int constexpr packet_size = P == 1 ? ray_packet_size : 1;
+  // Use several blocks per thread, since the cost of each ray varies. Blocks
+  // start on a packet boundary.
+  Int const num_packets = (num_rays + packet_size - 1) / packet_size;
+  Int const num_blocks = um2::max(um2::min(num_packets, 4 * num_threads), 1);
+  Vector<RayMeshIntersections> blocks(num_blocks);
+
+#if UM2_USE_OPENMP
+#  pragma omp parallel num_threads(num_threads)
+#endif
+  {
+    // Per-thread buffers, with room for a packet of rays in linear meshes.
+    Int const face_stride = num_faces + 1;
+    Vector<Float> coords(packet_size * max_hits);
+    Vector<Int> offsets(packet_size * face_stride);
+    Vector<Int> faces(packet_size * face_stride);
+    Vec2I hits_faces[packet_size];
+    Vector<Float> sorted_coords(um2::max(max_hits, num_faces));
+    Vector<Int> sorted_offsets(num_faces + 1);
+    Vector<Int> sorted_faces(num_faces);
+    Vector<Int> perm(num_faces);
+
+#if UM2_USE_OPENMP
+#  pragma omp for schedule(dynamic, 1)
+#endif
+    for (Int ib = 0; ib < num_blocks; ++ib) {
+      auto & block = blocks[ib];
+      Int const first = um2::min(packet_size * ((ib * num_packets) / num_blocks), num_rays);
+      Int const last =
+          um2::min(packet_size * (((ib + 1) * num_packets) / num_blocks), num_rays);
+      block.ray_offsets.reserve(last - first + 1);
+      block.ray_offsets.emplace_back(0);
+      block.coord_offsets.emplace_back(0);
+      for (Int iray = first; iray < last;) {
+        // Intersect a packet of rays if the next packet_size rays share a
+        // direction. Otherwise, intersect a single ray.
+        Int num_packet = 1;
+        if constexpr (P == 1) {
+          if (iray + packet_size <= last &&
+              sameDirection(rays.data() + iray, packet_size)) {
+            RayPacket2<packet_size, Float> const packet(rays.data() + iray);
+            intersect(packet, coords.data(), max_hits, offsets.data(), faces.data(),
+                      face_stride, hits_faces);
+            num_packet = packet_size;
+          }
+        }
+        if (num_packet == 1) {
+          hits_faces[0] =
+              intersect(rays[iray], coords.data(), offsets.data(), faces.data());
+        }
+        for (Int k = 0; k < num_packet; ++k) {
+          sortRayMeshIntersections(coords.data() + k * max_hits,
+                                   offsets.data() + k * face_stride,
+                                   faces.data() + k * face_stride, sorted_coords.data(),
+                                   sorted_offsets.data(), sorted_faces.data(),
+                                   perm.data(), hits_faces[k]);
+          Int const coord_offset = block.coords.size();
+          for (Int i = 0; i < hits_faces[k][1]; ++i) {
+            block.faces.emplace_back(sorted_faces[i]);
+            block.coord_offsets.emplace_back(coord_offset + sorted_offsets[i + 1]);
+          }
+          for (Int i = 0; i < hits_faces[k][0]; ++i) {
+            block.coords.emplace_back(sorted_coords[i]);
+          }
+          block.ray_offsets.emplace_back(block.faces.size());
+        }
+        iray += num_packet;
+      }
+    }
+  }
+
+  // Concatenate the blocks in ray order.
+  Int total_faces = 0;
+  Int total_coords = 0;
+  for (auto const & block : blocks) {
+    total_faces += block.faces.size();
+    total_coords += block.coords.size();
+  }
+  out.ray_offsets.resize(num_rays + 1);
+  out.coord_offsets.resize(total_faces + 1);
+  out.faces.resize(total_faces);
+  out.coords.resize(total_coords);
+  out.ray_offsets[0] = 0;
+  out.coord_offsets[0] = 0;
+  Int iray = 0;
+  Int face_offset = 0;
+  Int coord_offset = 0;
+  for (auto const & block : blocks) {
+    for (Int i = 1; i < block.ray_offsets.size(); ++i) {
+      out.ray_offsets[++iray] = face_offset + block.ray_offsets[i];
+    }
+    for (Int i = 0; i < block.faces.size(); ++i) {
+      out.faces[face_offset + i] = block.faces[i];
+      out.coord_offsets[face_offset + i + 1] = coord_offset + block.coord_offsets[i + 1];
+    }
+    for (Int i = 0; i < block.coords.size(); ++i) {
+      out.coords[coord_offset + i] = block.coords[i];
+    }
+    face_offset += block.faces.size();
+    coord_offset += block.coords.size();
+  }
+  ASSERT(iray == num_rays);
+}
+
+//==============================================================================
+// Bulk face properties
+//==============================================================================
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::faceAreas(Float * const areas) const noexcept
+{
+  PackedFaceVertexMesh<P, N>(*this).faceAreas(areas);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::faceCentroids(Point2F * const centroids) const noexcept
+{
+  PackedFaceVertexMesh<P, N>(*this).faceCentroids(centroids);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::faceBoundingBoxes(AxisAlignedBox2F * const boxes) const noexcept
+{
+  PackedFaceVertexMesh<P, N>(*this).faceBoundingBoxes(boxes);
+}
+
+template <Int P, Int N>
+void
+FaceVertexMesh<P, N>::faceMeanChordLengths(Float * const mcls) const noexcept
+{
+  PackedFaceVertexMesh<P, N>(*this).faceMeanChordLengths(mcls);
+}
+
 template <Int P, Int N>
 FaceVertexMesh<P, N>::operator PolytopeSoup() const noexcept
 {
   PolytopeSoup soup;
 
   // Vertices
-  soup.reserveMoreVertices(numVertices());
-  for (Int i = 0; i < numVertices(); ++i) {
-    soup.addVertex(_v[i][0], _v[i][1]);
-  }
+  soup.addVertices(_v);
 
   // Faces
-  VTKElemType const elem_type = getVTKElemType<P, N>();
-  Vector<Int> conn(N);
-  soup.reserveMoreElements(elem_type, numFaces());
-  for (Int i = 0; i < numFaces(); ++i) {
+  Int const num_faces = numFaces();
+  Vector<Int> conn(N * num_faces);
+  for (Int i = 0; i < num_faces; ++i) {
     for (Int j = 0; j < N; ++j) {
-      conn[j] = _fv[i][j];
+      conn[i * N + j] = _fv[i][j];
     }
-    soup.addElement(elem_type, conn);
   }
+  soup.addElements(getVTKElemType<P, N>(), conn);
   return soup;
 }
 
@@ -251,11 +742,19 @@ template <Int P, Int N>
 void
 checkCCWFaces(FaceVertexMesh<P, N> & mesh)
 {
-  // Check that the vertices are in counter-clockwise order.
+  // Check that the vertices are in counter-clockwise order. The faces are
+  // checked in parallel, then flipped serially, since flipFace modifies the mesh.
   Int const num_faces = mesh.numFaces();
+  Vector<int8_t> is_ccw(num_faces);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = 0; i < num_faces; ++i) {
+    is_ccw[i] = mesh.getFace(i).isCCW() ? 1 : 0;
+  }
   bool faces_flipped = false;
   for (Int i = 0; i < num_faces; ++i) {
-    if (!mesh.getFace(i).isCCW()) {
+    if (is_ccw[i] == 0) {
       mesh.flipFace(i);
       faces_flipped = true;
     }
@@ -265,161 +764,171 @@ checkCCWFaces(FaceVertexMesh<P, N> & mesh)
   }
 }
 
+//==============================================================================
+// EdgeTable
+//==============================================================================
+// An open-addressing hash table of the edges of a mesh, which counts the number
+// of times each edge occurs in each orientation. An edge is keyed by its
+// connectivity with the two linear vertex indices in ascending order.
+
+template <Int P>
+class EdgeTable
+{
+public:
+  using EdgeConn = Vec<P + 1, Int>;
+
+  struct Entry {
+    EdgeConn key;    // key[0] < key[1], or key[0] == -1 if the slot is empty
+    Int num_fwd = 0; // occurrences as (key[0], key[1])
+    Int num_rev = 0; // occurrences as (key[1], key[0])
+  };
+
+private:
+  Vector<Entry> _entries;
+  uint64_t _mask = 0;
+  Int _shift = 0;
+
+public:
+  // Reserve at least twice as many slots as edges, so that the load factor
+  // is at most 1/2 and probe sequences stay short.
+  explicit EdgeTable(Int const max_edges) noexcept
+  {
+    Int capacity = 16;
+    _shift = 60;
+    while (capacity < 2 * max_edges) {
+      capacity *= 2;
+      --_shift;
+    }
+    _entries.resize(capacity);
+    for (auto & entry : _entries) {
+      entry.key[0] = -1;
+    }
+    _mask = static_cast<uint64_t>(capacity) - 1;
+  }
+
+  // Count an occurrence of the edge in the given orientation.
+  void
+  insert(EdgeConn edge) noexcept
+  {
+    ASSERT(edge[0] != edge[1]);
+    bool const reversed = edge[0] > edge[1];
+    if (reversed) {
+      um2::swap(edge[0], edge[1]);
+    }
+    // Fibonacci hashing of the two vertex indices.
+    uint64_t const key = (static_cast<uint64_t>(edge[0]) << 32U) |
+                         static_cast<uint64_t>(static_cast<uint32_t>(edge[1]));
+    uint64_t slot = (key * 0x9E3779B97F4A7C15ULL) >> static_cast<uint64_t>(_shift);
+    while (true) {
+      Entry & entry = _entries[static_cast<Int>(slot)];
+      if (entry.key[0] == -1) {
+        entry.key = edge;
+      }
+      if (entry.key == edge) {
+        if (reversed) {
+          ++entry.num_rev;
+        } else {
+          ++entry.num_fwd;
+        }
+        return;
+      }
+      slot = (slot + 1) & _mask;
+    }
+  }
+
+  PURE [[nodiscard]] auto
+  entries() const noexcept -> Vector<Entry> const &
+  {
+    return _entries;
+  }
+};
+
 template <Int P, Int N>
 void
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 checkManifoldWatertight(FaceVertexMesh<P, N> const & mesh)
 {
-  // Ensure that the mesh doesn't have any holes or self-intersections.
+  // Ensure that the mesh doesn't have any holes or overlapping faces.
   // Algorithm:
-  //  1. For each face, get the edges as represented by the vertex indices.
-  //  2. Sort the edges by the smallest vertex index (for quadratic edges, use the
-  //      linear vertex index).
-  //  3. Count the number of times each edge/orientation occurs.
+  //  1. Insert the edges of each face into a hash table, counting the number of
+  //     times each edge occurs in each orientation.
   //    - If edge (i, j) occurs more than once, then the mesh has overlapping faces.
-  //    - If edge (i, j) and edge (j, i) occue exactly once, then the edge is an
+  //    - If edge (i, j) and edge (j, i) occur exactly once, then the edge is an
   //        interior edge.
   //    - If edge (i, j) occurs exactly once, then the edge is a boundary edge.
-  //  4. Get the boundary edges.
-  //    - If the mesh does not have any holes, then the number of boundary edges should
-  //      by able to form a single closed loop.
-  //    - Determine the number of closed loops.
-
-  using EdgeConn = typename FaceVertexMesh<P, N>::EdgeConn;
+  //  2. Map the start vertex of each boundary edge to its end vertex.
+  //    - If two boundary edges share a start or end vertex, then the mesh has a
+  //      hole on its boundary.
+  //  3. Follow the map from any boundary edge. If the mesh does not have any
+  //     holes, we return to the start after visiting every boundary edge.
+  //
+  // Each step is linear in the number of edges.
 
   Int const num_faces = mesh.numFaces();
+  if (num_faces == 0) {
+    return;
+  }
   Int constexpr edges_per_face = polygonNumEdges<P, N>();
-  Int const total_num_edges = num_faces * edges_per_face;
 
   // 1
   //---------------------------------------------------------------------------
-  // (Edge conn, orientation) pairs. +1 if ordered, -1 if reversed.
-  Vector<Pair<EdgeConn, Int>> edge_conns(total_num_edges);
+  EdgeTable<P> table(num_faces * edges_per_face);
   for (Int iface = 0; iface < num_faces; ++iface) {
     for (Int iedge = 0; iedge < edges_per_face; ++iedge) {
-      auto & edge_conn = edge_conns[iface * edges_per_face + iedge];
-      edge_conn.first = mesh.getEdgeConn(iface, iedge);
-      ASSERT(edge_conn.first[0] != edge_conn.first[1]);
-      // Ensure that the first vertex index is less than the second.
-      if (edge_conn.first[0] > edge_conn.first[1]) {
-        um2::swap(edge_conn.first[0], edge_conn.first[1]);
-        edge_conn.second = -1;
-      } else {
-        edge_conn.second = 1;
-      }
+      table.insert(mesh.getEdgeConn(iface, iedge));
     }
   }
 
   // 2
   //---------------------------------------------------------------------------
-  std::sort(edge_conns.begin(), edge_conns.end());
-  // edge_conns is now sorted by edge, then orientation.
-
-  // 3
-  //---------------------------------------------------------------------------
-  // We expect num_unique_edges >= total_num_edges / 2, approaching equality
-  // as the ratio of boundary edges / interior edges approaches 0.
-  Vector<EdgeConn> unique_edges;
-  Vector<Vec2I> edge_counts;
-  unique_edges.reserve(total_num_edges / 2);
-  edge_counts.reserve(total_num_edges / 2);
-
-  // push back the first edge and count
-  if (edge_conns[0].second == 1) {
-    edge_counts.emplace_back(0, 1);
-    unique_edges.emplace_back(edge_conns[0].first);
-  } else {
-    edge_counts.emplace_back(1, 0);
-    // We want the natural ordering of the edge
-    unique_edges.emplace_back(edge_conns[0].first);
-    auto & edge = unique_edges.back();
-    um2::swap(edge[0], edge[1]);
-  }
-
-  for (Int i = 1; i < total_num_edges; ++i) {
-    auto const & prev_edge_conn = edge_conns[i - 1];
-    auto const & edge_conn = edge_conns[i];
-    // If this edge is the same as the previous edge, increment the count.
-    if (prev_edge_conn.first == edge_conn.first) {
-      auto & edge_counts_back = edge_counts.back();
-      // Increment the orientation count.
-      if (edge_conn.second == 1) {
-        ++edge_counts_back[1];
-      } else {
-        ++edge_counts_back[0];
-      }
-    } else {
-      // Otherwise, emplace back the edge.
-      if (edge_conn.second == 1) {
-        edge_counts.emplace_back(0, 1);
-        unique_edges.emplace_back(edge_conn.first);
-      } else {
-        edge_counts.emplace_back(1, 0);
-        unique_edges.emplace_back(edge_conn.first);
-        auto & edge = unique_edges.back();
-        um2::swap(edge[0], edge[1]);
-      }
+  Int const num_vertices = mesh.numVertices();
+  Vector<Int> next(num_vertices, -1);    // next[i] = j if (i, j) is a boundary edge
+  Vector<int8_t> has_prev(num_vertices, 0); // 1 if (k, i) is a boundary edge
+  Int num_boundary_edges = 0;
+  Int start_idx = -1;
+  for (auto const & entry : table.entries()) {
+    if (entry.key[0] == -1) {
+      continue;
     }
-  }
-
-  // 4
-  //---------------------------------------------------------------------------
-
-  //- If edge (i, j) occurs more than once, then the mesh has overlapping faces.
-  //- If edge (i, j) and edge (j, i) occue exactly once, then the edge is an
-  //    interior edge.
-  //- If edge (i, j) occurs exactly once, then the edge is a boundary edge.
-  Vector<EdgeConn> boundary_edges;
-  for (Int i = 0; i < edge_counts.size(); ++i) {
-    auto const & edge_count = edge_counts[i];
-    Int const sum = edge_count[0] + edge_count[1];
-    if (sum > 2) {
+    if (entry.num_fwd > 1 || entry.num_rev > 1) {
       LOG_ERROR("Mesh has overlapping faces");
       return;
     }
-    if (sum == 1) {
-      // Ensure that the first and second vertex indices are unique.
-      // Otherwise, the mesh has a hole.
-      auto const & edge = unique_edges[i];
-      for (auto const & bedge : boundary_edges) {
-        if (edge[0] == bedge[0] || edge[1] == bedge[1]) {
-          LOG_ERROR("Mesh has a hole on its boundary");
-          return;
-        }
+    if (entry.num_fwd + entry.num_rev == 1) {
+      // The natural ordering of the edge
+      Int const v0 = entry.num_fwd == 1 ? entry.key[0] : entry.key[1];
+      Int const v1 = entry.num_fwd == 1 ? entry.key[1] : entry.key[0];
+      if (next[v0] != -1 || has_prev[v1] == 1) {
+        LOG_ERROR("Mesh has a hole on its boundary");
+        return;
       }
-      boundary_edges.emplace_back(edge);
+      next[v0] = v1;
+      has_prev[v1] = 1;
+      start_idx = v0;
+      ++num_boundary_edges;
     }
   }
+  if (num_boundary_edges == 0) {
+    LOG_ERROR("Mesh has no boundary");
+    return;
+  }
 
-  // We expect the number of boundary edges to be relatively small compared to the
-  // total number of edges. Hence, we can afford to use a simple O(n^2) algorithm.
+  // 3
+  //---------------------------------------------------------------------------
   Int ctr = 0; // The number of edges in the boundary loop.
-  Int const start_idx = boundary_edges[0][0];
-  auto edge = boundary_edges[0];
-  while (true) {
-    // Find the edge that has the same start index as the current edge's end index.
-    bool edge_found = false;
-    for (auto const & bedge : boundary_edges) {
-      if (edge[1] == bedge[0]) {
-        edge = bedge;
-        ++ctr;
-        edge_found = true;
-        break;
-      }
-    }
+  Int v = start_idx;
+  do {
     // If the edge does not exist, there is a boundary edge missing.
-    if (!edge_found) {
+    if (next[v] == -1) {
       LOG_ERROR("Mesh has a hanging boundary edge");
       return;
     }
-    // If we're back at the start, we have a closed loop.
-    if (edge[0] == start_idx) {
-      break;
-    }
-  }
+    v = next[v];
+    ++ctr;
+  } while (v != start_idx);
   // If the number of edges in the boundary loop is not equal to the number of
   // boundary edges, then the mesh has multiple boundary loops.
-  if (ctr != boundary_edges.size()) {
+  if (ctr != num_boundary_edges) {
     LOG_ERROR("Mesh has a hole in its interior");
     return;
   }
@@ -427,77 +936,131 @@ checkManifoldWatertight(FaceVertexMesh<P, N> const & mesh)
 
 template <Int N>
 void
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
 checkSelfIntersections(FaceVertexMesh<2, N> & mesh)
 {
+  // Repair self-intersecting faces with a worklist. Fixing a face perturbs one
+  // of its vertices, which can only affect the faces sharing that vertex, so
+  // only those faces are checked again.
 #if WRITE_SELF_INTERSECTING_MESH
   static Int num_intersections = 0;
 #endif
   Int const num_faces = mesh.numFaces();
+
+  // Find the self-intersecting faces. The faces are independent, so they are
+  // checked in parallel.
+  Vector<int8_t> queued(num_faces);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int iface = 0; iface < num_faces; ++iface) {
+    Point2F local_buffer[2 * N];
+    queued[iface] = mesh.getFace(iface).hasSelfIntersection(local_buffer) ? 1 : 0;
+  }
+  Vector<Int> worklist;
+  for (Int iface = num_faces - 1; iface >= 0; --iface) {
+    if (queued[iface] == 1) [[unlikely]] {
+      worklist.emplace_back(iface);
+    }
+  }
+  if (worklist.empty()) {
+    return;
+  }
+
+  // The faces sharing each vertex
+  mesh.populateVF();
+  auto const & vf_offsets = mesh.vertexFaceOffsets();
+  auto const & vf = mesh.vertexFaceConn();
+
+  // The bounding box of the mesh is the union of the face bounding boxes.
+  // Hence, after perturbing a vertex, the box is unchanged if the perturbed
+  // faces were strictly inside it before and are still inside it after.
+  // Otherwise, fall back to recomputing the box.
+  auto const aabb_before = mesh.boundingBox();
+  auto const strictly_inside = [&aabb_before](AxisAlignedBox2F const & box) -> bool {
+    for (Int d = 0; d < 2; ++d) {
+      if (box.minima(d) <= aabb_before.minima(d) + epsDistance<Float>() ||
+          aabb_before.maxima(d) - epsDistance<Float>() <= box.maxima(d)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
   Point2F buffer[2 * N];
-  bool check_again = true;
-  while (check_again) {
-    check_again = false;
-    for (Int iface = 0; iface < num_faces; ++iface) {
-      if (mesh.getFace(iface).hasSelfIntersection(buffer)) [[unlikely]] {
+  while (!worklist.empty()) {
+    Int const iface = worklist.back();
+    worklist.pop_back();
+    queued[iface] = 0;
+    if (!mesh.getFace(iface).hasSelfIntersection(buffer)) {
+      continue;
+    }
 #if WRITE_SELF_INTERSECTING_MESH
-        // If there is a self-intersection, first write the mesh to a file.
-        ++num_intersections;
-        Vector<Int> ids(num_faces, 0);
-        um2::iota(ids.begin(), ids.end(), 0);
-        Vector<Float> data(num_faces, 0);
-        data[iface] = 1;
-        {
-          PolytopeSoup soup = mesh;
-          soup.addElset("self_intersecting_face", ids, data);
-          um2::String const filename =
-              String("self_intersecting_mesh") + String(num_intersections) + ".xdmf";
-          soup.write(filename);
-          LOG_WARN("Mesh has self-intersecting face at index: ", iface,
-                   ". Mesh written to ", filename);
-        }
+    // If there is a self-intersection, first write the mesh to a file.
+    ++num_intersections;
+    Vector<Int> ids(num_faces, 0);
+    um2::iota(ids.begin(), ids.end(), 0);
+    Vector<Float> data(num_faces, 0);
+    data[iface] = 1;
+    {
+      PolytopeSoup soup = mesh;
+      soup.addElset("self_intersecting_face", ids, data);
+      um2::String const filename =
+          String("self_intersecting_mesh") + String(num_intersections) + ".xdmf";
+      soup.write(filename);
+      LOG_WARN("Mesh has self-intersecting face at index: ", iface,
+               ". Mesh written to ", filename);
+    }
 #endif
 
-        // Attempt to fix the self-intersection.
-        //-----------------------------------------------------------------------
-        // Get the bounding box of the mesh to ensure we don't modify the
-        // boundary
-        auto const aabb_before = mesh.boundingBox();
-        auto face = mesh.getFace(iface);
-        Int vid = -1; // vertex id in the face that was perturbed
-        bool const fixed = fixSelfIntersection(face, buffer, vid);
-        if (!fixed) {
-          LOG_ERROR("Self-intersection could not be fixed");
-          return;
-        }
+    // Attempt to fix the self-intersection.
+    //-------------------------------------------------------------------------
+    auto face = mesh.getFace(iface);
+    Int vid = -1; // vertex id in the face that was perturbed
+    bool const fixed = fixSelfIntersection(face, buffer, vid);
+    if (!fixed) {
+      LOG_ERROR("Self-intersection could not be fixed");
+      return;
+    }
 
-        // Perturb the vertex by the returned amount
-        //-----------------------------------------------------------------------
-        // Get the vertex id in the mesh
-        vid = mesh.getFaceConn(iface)[vid];
-        mesh.vertices()[vid] += buffer[0];
-        LOG_WARN("Self-intersection fixed");
+    // Perturb the vertex by the returned amount
+    //-------------------------------------------------------------------------
+    // Get the vertex id in the mesh
+    vid = mesh.getFaceConn(iface)[vid];
+    bool box_unchanged = true;
+    for (Int i = vf_offsets[vid]; i < vf_offsets[vid + 1]; ++i) {
+      box_unchanged = box_unchanged && strictly_inside(mesh.getFace(vf[i]).boundingBox());
+    }
+    mesh.vertices()[vid] += buffer[0];
+    LOG_WARN("Self-intersection fixed");
 
 #if WRITE_SELF_INTERSECTING_MESH
-        // Write the fixed mesh to a file.
-        {
-          PolytopeSoup soup = mesh;
-          soup.addElset("self_intersecting_face", ids, data);
-          um2::String const filename = String("self_intersecting_mesh") +
-                                       String(num_intersections) + "_fixed.xdmf";
-          soup.write(filename);
-        }
+    // Write the fixed mesh to a file.
+    {
+      PolytopeSoup soup = mesh;
+      soup.addElset("self_intersecting_face", ids, data);
+      um2::String const filename =
+          String("self_intersecting_mesh") + String(num_intersections) + "_fixed.xdmf";
+      soup.write(filename);
+    }
 #endif
 
-        // Check that the bounding box of the mesh has not changed.
-        if (!aabb_before.isApprox(mesh.boundingBox())) {
-          LOG_ERROR("Self-intersection fixed, but bounding box changed");
-          return;
-        }
+    // Check that the bounding box of the mesh has not changed.
+    for (Int i = vf_offsets[vid]; i < vf_offsets[vid + 1]; ++i) {
+      box_unchanged = box_unchanged && strictly_inside(mesh.getFace(vf[i]).boundingBox());
+    }
+    if (!box_unchanged && !aabb_before.isApprox(mesh.boundingBox())) {
+      LOG_ERROR("Self-intersection fixed, but bounding box changed");
+      return;
+    }
 
-        // We were able to fix the intersection, but we may have introduced new
-        // self-intersections. We will have to check again.
-        check_again = true;
-        break;
+    // We were able to fix the intersection, but we may have introduced new
+    // self-intersections in the faces sharing the vertex.
+    for (Int i = vf_offsets[vid]; i < vf_offsets[vid + 1]; ++i) {
+      Int const jface = vf[i];
+      if (queued[jface] == 0) {
+        queued[jface] = 1;
+        worklist.emplace_back(jface);
       }
     }
   }
@@ -522,6 +1085,11 @@ FaceVertexMesh<P, N>::validate()
   if constexpr (P == 2) {
     checkSelfIntersections(*this);
   }
+
+  // The checks above may reorder face vertices or move vertices, so any
+  // derived geometry must be rebuilt.
+  _has_bvh = false;
+  _has_edge_cache = false;
 }
 
 //==============================================================================
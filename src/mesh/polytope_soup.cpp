@@ -7,6 +7,7 @@
 #include <um2/mesh/element_types.hpp>
 #include <um2/mesh/polytope_soup.hpp>
 #include <um2/stdlib/algorithm/copy.hpp>
+#include <um2/stdlib/algorithm/fill.hpp>
 #include <um2/stdlib/algorithm/is_sorted.hpp>
 #include <um2/stdlib/assert.hpp>
 #include <um2/stdlib/math/abs.hpp>
@@ -39,6 +40,71 @@
 namespace um2
 {
 
+//==============================================================================
+// Elset name hash table
+//==============================================================================
+
+namespace
+{
+
+// FNV-1a hash of the characters of the name
+PURE auto
+hashElsetName(String const & name) noexcept -> uint64_t
+{
+  uint64_t h = 0xCBF29CE484222325ULL;
+  char const * const chars = name.data();
+  for (Int i = 0; i < name.size(); ++i) {
+    h = (h ^ static_cast<uint64_t>(static_cast<unsigned char>(chars[i]))) *
+        0x100000001B3ULL;
+  }
+  return h;
+}
+
+} // namespace
+
+void
+PolytopeSoup::insertIntoElsetTable(Int const i)
+{
+  ASSERT(2 * _elset_names.size() <= _elset_table.size());
+  auto const mask = static_cast<uint64_t>(_elset_table.size()) - 1;
+  uint64_t slot = hashElsetName(_elset_names[i]) & mask;
+  while (_elset_table[static_cast<Int>(slot)] != -1) {
+    slot = (slot + 1) & mask;
+  }
+  _elset_table[static_cast<Int>(slot)] = i;
+}
+
+void
+PolytopeSoup::rebuildElsetTable()
+{
+  Int capacity = 16;
+  while (capacity < 2 * _elset_names.size()) {
+    capacity *= 2;
+  }
+  _elset_table.resize(capacity);
+  um2::fill(_elset_table.begin(), _elset_table.end(), -1);
+  for (Int i = 0; i < _elset_names.size(); ++i) {
+    insertIntoElsetTable(i);
+  }
+}
+
+PURE auto
+PolytopeSoup::getElsetIndex(String const & name) const noexcept -> Int
+{
+  if (_elset_table.empty()) {
+    return -1;
+  }
+  auto const mask = static_cast<uint64_t>(_elset_table.size()) - 1;
+  uint64_t slot = hashElsetName(name) & mask;
+  while (true) {
+    Int const i = _elset_table[static_cast<Int>(slot)];
+    if (i == -1 || _elset_names[i] == name) {
+      return i;
+    }
+    slot = (slot + 1) & mask;
+  }
+}
+
 //==============================================================================
 // Constructors
 //==============================================================================
@@ -82,21 +148,19 @@ PolytopeSoup::getElset(Int const i, String & name, Vector<Int> & ids,
 void
 PolytopeSoup::getElset(String const & name, Vector<Int> & ids, Vector<Float> & data) const
 {
-  for (auto const & elset_name : _elset_names) {
-    if (elset_name == name) {
-      auto const i = static_cast<Int>(&elset_name - _elset_names.data());
-      auto const istart = _elset_offsets[i];
-      auto const iend = _elset_offsets[i + 1];
-      auto const n = iend - istart;
-      ids.resize(n);
-      um2::copy(_elset_ids.cbegin() + istart, _elset_ids.cbegin() + iend, ids.begin());
-      if (!_elset_data[i].empty()) {
-        data = _elset_data[i];
-      }
-      return;
-    }
+  Int const i = getElsetIndex(name);
+  if (i == -1) {
+    LOG_WARN("Elset ", name, " not found.");
+    return;
+  }
+  auto const istart = _elset_offsets[i];
+  auto const iend = _elset_offsets[i + 1];
+  auto const n = iend - istart;
+  ids.resize(n);
+  um2::copy(_elset_ids.cbegin() + istart, _elset_ids.cbegin() + iend, ids.begin());
+  if (!_elset_data[i].empty()) {
+    data = _elset_data[i];
   }
-  LOG_WARN("Elset ", name, " not found.");
 }
 
 //==============================================================================
@@ -117,6 +181,28 @@ PolytopeSoup::addVertex(Point3F const & p) -> Int
   return _vertices.size() - 1;
 }
 
+auto
+PolytopeSoup::addVertices(Vector<Point2F> const & vertices) -> Int
+{
+  Int const first = _vertices.size();
+  _vertices.resize(first + vertices.size());
+  for (Int i = 0; i < vertices.size(); ++i) {
+    _vertices[first + i][0] = vertices[i][0];
+    _vertices[first + i][1] = vertices[i][1];
+    _vertices[first + i][2] = 0;
+  }
+  return first;
+}
+
+auto
+PolytopeSoup::addVertices(Vector<Point3F> const & vertices) -> Int
+{
+  Int const first = _vertices.size();
+  _vertices.resize(first + vertices.size());
+  um2::copy(vertices.cbegin(), vertices.cend(), _vertices.begin() + first);
+  return first;
+}
+
 auto
 PolytopeSoup::addElement(VTKElemType const type, Vector<Int> const & conn) -> Int
 {
@@ -132,17 +218,52 @@ PolytopeSoup::addElement(VTKElemType const type, Vector<Int> const & conn) -> In
   return _element_types.size() - 1;
 }
 
+auto
+PolytopeSoup::addElements(VTKElemType const type, Vector<Int> const & conn) -> Int
+{
+  Int const verts_per_elem = verticesPerElem(type);
+  if (conn.size() % verts_per_elem != 0) {
+    LOG_ERROR("Connectivity size is not a multiple of the number of vertices per "
+              "element.");
+    return -1;
+  }
+  Int const num_elems = conn.size() / verts_per_elem;
+  Int const first = _element_types.size();
+  if (_element_offsets.empty()) {
+    _element_offsets.emplace_back(0);
+  }
+
+  // Types
+  _element_types.resize(first + num_elems);
+  um2::fill(_element_types.begin() + first, _element_types.end(), type);
+
+  // Offsets
+  Int const conn_first = _element_offsets.back();
+  _element_offsets.resize(first + num_elems + 1);
+  for (Int i = 1; i <= num_elems; ++i) {
+    _element_offsets[first + i] = conn_first + i * verts_per_elem;
+  }
+
+  // Connectivity
+#if UM2_ENABLE_ASSERTS
+  for (auto const & id : conn) {
+    ASSERT(id < _vertices.size());
+  }
+#endif
+  _element_conn.resize(conn_first + conn.size());
+  um2::copy(conn.cbegin(), conn.cend(), _element_conn.begin() + conn_first);
+  return first;
+}
+
 auto
 PolytopeSoup::addElset(String const & name, Vector<Int> const & ids,
                        Vector<Float> data) -> Int
 {
   LOG_DEBUG("Adding elset: ", name);
 
-  for (auto const & this_name : _elset_names) {
-    if (this_name == name) {
-      LOG_ERROR("Elset ", name, " already exists.");
-      return -1;
-    }
+  if (getElsetIndex(name) != -1) {
+    LOG_ERROR("Elset ", name, " already exists.");
+    return -1;
   }
 
   Int const num_ids = ids.size();
@@ -173,7 +294,13 @@ PolytopeSoup::addElset(String const & name, Vector<Int> const & ids,
   }
 #endif
   _elset_data.emplace_back(um2::move(data));
-  return _elset_names.size() - 1;
+  Int const elset_index = _elset_names.size() - 1;
+  if (_elset_table.size() < 2 * _elset_names.size()) {
+    rebuildElsetTable();
+  } else {
+    insertIntoElsetTable(elset_index);
+  }
+  return elset_index;
 }
 
 void
@@ -251,6 +378,7 @@ PolytopeSoup::sortElsets()
   _elset_offsets = um2::move(elset_offsets);
   _elset_ids = um2::move(elset_ids);
   _elset_data = um2::move(elset_data);
+  rebuildElsetTable();
 }
 
 auto
@@ -299,14 +427,7 @@ PolytopeSoup::operator+=(PolytopeSoup const & other) noexcept -> PolytopeSoup &
   ASSERT(um2::is_sorted(_elset_names.cbegin(), _elset_names.cend()));
   ASSERT(um2::is_sorted(other._elset_names.cbegin(), other._elset_names.cend()));
   for (auto const & name : other._elset_names) {
-    bool name_exists = false;
-    for (auto const & this_name : _elset_names) {
-      if (name == this_name) {
-        name_exists = true;
-        break;
-      }
-    }
-    if (!name_exists) {
+    if (getElsetIndex(name) == -1) {
       new_elset_names.emplace_back(name);
     }
   }
@@ -362,6 +483,7 @@ PolytopeSoup::operator+=(PolytopeSoup const & other) noexcept -> PolytopeSoup &
   _elset_offsets = um2::move(new_elset_offsets);
   _elset_ids = um2::move(new_elset_ids);
   _elset_data = um2::move(new_elset_data);
+  rebuildElsetTable();
   return *this;
 }
 
@@ -445,16 +567,8 @@ PolytopeSoup::getSubset(String const & elset_name, PolytopeSoup & subset) const
   LOG_DEBUG("Extracting subset: ", elset_name);
 
   // Find the elset with the given name.
-  Int elset_index = 0;
-  bool found = false;
-  for (Int i = 0; i < _elset_names.size(); ++i) {
-    if (_elset_names[i] == elset_name) {
-      elset_index = i;
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
+  Int const elset_index = getElsetIndex(elset_name);
+  if (elset_index == -1) {
     LOG_ERROR("getSubset: Elset '", elset_name, "' not found");
     return;
   }
@@ -482,7 +596,7 @@ PolytopeSoup::getSubset(String const & elset_name, PolytopeSoup & subset) const
     auto const element_len = element_end - element_start;
     subset_element_conn_len += element_len;
     auto const element_type = _element_types[element_id];
-    found = false;
+    bool found = false;
     for (auto & type_count : subset_elem_type_counts) {
       auto const type = type_count.first;
       if (type == element_type) {
@@ -612,6 +726,167 @@ PolytopeSoup::getSubset(String const & elset_name, PolytopeSoup & subset) const
   delete[] intersection;
 }
 
+//==============================================================================
+// partitionByElsetPrefix
+//==============================================================================
+
+void
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+PolytopeSoup::partitionByElsetPrefix(String const & prefix, Vector<String> & names,
+                                     Vector<PolytopeSoup> & subsets) const
+{
+  LOG_DEBUG("Partitioning by elset prefix: ", prefix);
+
+  // Find the elsets with the prefix, which define the partition.
+  Int const num_elsets = _elset_names.size();
+  Vector<Int> part_elsets;
+  for (Int i = 0; i < num_elsets; ++i) {
+    if (_elset_names[i].starts_with(prefix)) {
+      part_elsets.emplace_back(i);
+    }
+  }
+  Int const num_parts = part_elsets.size();
+  names.resize(num_parts);
+  subsets.clear();
+  subsets.resize(num_parts);
+
+  // Map each element to its part and its ID within the part.
+  Int const num_elements = numElements();
+  Vector<Int> elem_part(num_elements, -1);
+  Vector<Int> elem_local_id(num_elements);
+  for (Int k = 0; k < num_parts; ++k) {
+    Int const ielset = part_elsets[k];
+    names[k] = _elset_names[ielset];
+    auto const * const ids_begin = _elset_ids.cbegin() + _elset_offsets[ielset];
+    auto const * const ids_end = _elset_ids.cbegin() + _elset_offsets[ielset + 1];
+    if (!um2::is_sorted(ids_begin, ids_end)) {
+      LOG_ERROR("partitionByElsetPrefix: Elset IDs are not sorted. Use sortElsets() "
+                "to correct this.");
+      return;
+    }
+    for (auto const * it = ids_begin; it != ids_end; ++it) {
+      if (elem_part[*it] != -1) {
+        LOG_ERROR("partitionByElsetPrefix: Element ", *it, " is in both ",
+                  names[elem_part[*it]], " and ", names[k]);
+        return;
+      }
+      elem_part[*it] = k;
+      elem_local_id[*it] = static_cast<Int>(it - ids_begin);
+    }
+  }
+
+  // Bucket the members of every other elset by part. Since the elsets are
+  // visited in order and the element IDs of each elset are sorted, each bucket
+  // holds the intersecting elsets in order, each with sorted local IDs.
+  struct ElsetMember {
+    Int elset;    // index of the elset in this soup
+    Int local_id; // element ID in the subset
+    Int index;    // index of the element in the elset, for the elset data
+  };
+  Vector<Int> bucket_offsets(num_parts + 1, 0);
+  for (Int i = 0; i < num_elsets; ++i) {
+    if (_elset_names[i].starts_with(prefix)) {
+      continue;
+    }
+    for (Int j = _elset_offsets[i]; j < _elset_offsets[i + 1]; ++j) {
+      Int const k = elem_part[_elset_ids[j]];
+      if (k != -1) {
+        ++bucket_offsets[k + 1];
+      }
+    }
+  }
+  for (Int k = 0; k < num_parts; ++k) {
+    bucket_offsets[k + 1] += bucket_offsets[k];
+  }
+  Vector<ElsetMember> members(bucket_offsets[num_parts]);
+  {
+    Vector<Int> pos(bucket_offsets.cbegin(), bucket_offsets.cend() - 1);
+    for (Int i = 0; i < num_elsets; ++i) {
+      if (_elset_names[i].starts_with(prefix)) {
+        continue;
+      }
+      for (Int j = _elset_offsets[i]; j < _elset_offsets[i + 1]; ++j) {
+        Int const elem = _elset_ids[j];
+        Int const k = elem_part[elem];
+        if (k != -1) {
+          members[pos[k]++] = {i, elem_local_id[elem], j - _elset_offsets[i]};
+        }
+      }
+    }
+  }
+
+  // Build each subset independently.
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (Int k = 0; k < num_parts; ++k) {
+    PolytopeSoup & subset = subsets[k];
+    Int const ielset = part_elsets[k];
+    Int const * const element_ids = _elset_ids.cbegin() + _elset_offsets[ielset];
+    Int const subset_num_elements = _elset_offsets[ielset + 1] - _elset_offsets[ielset];
+
+    // The unique vertices of the subset, in ascending order of vertex ID
+    Vector<Int> vertex_ids;
+    for (Int i = 0; i < subset_num_elements; ++i) {
+      Int const element_id = element_ids[i];
+      for (Int j = _element_offsets[element_id]; j < _element_offsets[element_id + 1];
+           ++j) {
+        vertex_ids.emplace_back(_element_conn[j]);
+      }
+    }
+    Int const subset_conn_len = vertex_ids.size();
+    std::sort(vertex_ids.begin(), vertex_ids.end());
+    auto const * const last = std::unique(vertex_ids.begin(), vertex_ids.end());
+    auto const num_unique_verts = static_cast<Int>(last - vertex_ids.cbegin());
+    subset._vertices.resize(num_unique_verts);
+    for (Int i = 0; i < num_unique_verts; ++i) {
+      subset._vertices[i] = _vertices[vertex_ids[i]];
+    }
+
+    // The elements, with the vertex IDs remapped
+    subset._element_types.resize(subset_num_elements);
+    subset._element_offsets.resize(subset_num_elements + 1);
+    subset._element_conn.resize(subset_conn_len);
+    subset._element_offsets[0] = 0;
+    Int ctr = 0;
+    for (Int i = 0; i < subset_num_elements; ++i) {
+      Int const element_id = element_ids[i];
+      subset._element_types[i] = _element_types[element_id];
+      for (Int j = _element_offsets[element_id]; j < _element_offsets[element_id + 1];
+           ++j) {
+        auto const * const it =
+            std::lower_bound(vertex_ids.cbegin(), last, _element_conn[j]);
+        ASSERT(*it == _element_conn[j]);
+        subset._element_conn[ctr++] = static_cast<Int>(it - vertex_ids.cbegin());
+      }
+      subset._element_offsets[i + 1] = ctr;
+    }
+
+    // The intersections with the other elsets
+    Int const members_end = bucket_offsets[k + 1];
+    subset._elset_ids.resize(members_end - bucket_offsets[k]);
+    subset._elset_offsets.emplace_back(0);
+    for (Int m = bucket_offsets[k]; m < members_end;) {
+      Int const ielset_other = members[m].elset;
+      subset._elset_names.emplace_back(_elset_names[ielset_other]);
+      Vector<Float> data;
+      Vector<Float> const & other_data = _elset_data[ielset_other];
+      for (; m < members_end && members[m].elset == ielset_other; ++m) {
+        subset._elset_ids[m - bucket_offsets[k]] = members[m].local_id;
+        if (!other_data.empty()) {
+          data.emplace_back(other_data[members[m].index]);
+        }
+      }
+      subset._elset_offsets.emplace_back(m - bucket_offsets[k]);
+      subset._elset_data.emplace_back(um2::move(data));
+    }
+    if (subset._elset_names.empty()) {
+      subset._elset_offsets.clear();
+    }
+    subset.rebuildElsetTable();
+  }
+}
+
 //==============================================================================-
 // IO for ABAQUS files.
 //==============================================================================
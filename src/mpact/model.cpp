@@ -9,6 +9,7 @@
 #include <um2/math/vec.hpp>
 #include <um2/mesh/element_types.hpp>
 #include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mesh/packed_face_vertex_mesh.hpp>
 #include <um2/mesh/polytope_soup.hpp>
 #include <um2/mesh/rectilinear_grid.hpp>
 #include <um2/mesh/rectilinear_partition.hpp>
@@ -88,6 +89,53 @@ flattenLattice(Vector<Vector<T>> const & ids, Vector<U> & flat_ids)
 
 } // namespace
 
+//=============================================================================
+// getMeshFaceAreas, getMeshMeanChordLengths
+//=============================================================================
+// The area or mean chord length of each face of each mesh. A model has many
+// small meshes, so the loop is parallel over the meshes and the per-face
+// kernels on the packed faces are serial.
+
+namespace
+{
+
+template <Int P, Int N>
+auto
+getMeshFaceAreas(Vector<FaceVertexMesh<P, N>> const & meshes) -> Vector<Vector<Float>>
+{
+  Int const num_meshes = meshes.size();
+  Vector<Vector<Float>> areas;
+  areas.resize(num_meshes);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (Int i = 0; i < num_meshes; ++i) {
+    areas[i].resize(meshes[i].numFaces());
+    PackedFaceVertexMesh<P, N>(meshes[i]).faceAreas(areas[i].data());
+  }
+  return areas;
+}
+
+template <Int P, Int N>
+auto
+getMeshMeanChordLengths(Vector<FaceVertexMesh<P, N>> const & meshes)
+    -> Vector<Vector<Float>>
+{
+  Int const num_meshes = meshes.size();
+  Vector<Vector<Float>> mcls;
+  mcls.resize(num_meshes);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (Int i = 0; i < num_meshes; ++i) {
+    mcls[i].resize(meshes[i].numFaces());
+    PackedFaceVertexMesh<P, N>(meshes[i]).faceMeanChordLengths(mcls[i].data());
+  }
+  return mcls;
+}
+
+} // namespace
+
 //=============================================================================
 // Constructors
 //=============================================================================
@@ -113,6 +161,112 @@ Model::clear() noexcept
   _quads.clear();
   _tri6s.clear();
   _quad8s.clear();
+
+  invalidateInstanceTable();
+}
+
+//=============================================================================
+// coarseCellInstances
+//=============================================================================
+
+void
+Model::invalidateInstanceTable() noexcept
+{
+  _instance_table.instances.clear();
+  _instance_table.core_fsr_offsets.clear();
+  _instance_table.assembly_fsr_offsets.clear();
+  _instance_table.lattice_fsr_offsets.clear();
+  _instance_table.rtm_fsr_offsets.clear();
+  _has_instance_table = false;
+}
+
+auto
+Model::instanceTable() const -> InstanceTable const &
+{
+  if (_has_instance_table) {
+    return _instance_table;
+  }
+  // Flatten the hierarchy, computing the prefix sum of the number of faces.
+  // The offsets of the children of each parent relative to the parent are the
+  // same for every instance of the parent, so they are simply overwritten.
+  auto & instances = _instance_table.instances;
+  auto & core_offsets = _instance_table.core_fsr_offsets;
+  auto & asy_offsets = _instance_table.assembly_fsr_offsets;
+  auto & lat_offsets = _instance_table.lattice_fsr_offsets;
+  auto & rtm_offsets = _instance_table.rtm_fsr_offsets;
+  instances.clear();
+  Int const num_asy = _core.children().size();
+  core_offsets.resize(num_asy);
+  asy_offsets.resize(_assemblies.size());
+  lat_offsets.resize(_lattices.size());
+  rtm_offsets.resize(_rtms.size());
+  Int num_fsrs = 0;
+  for (Int iasy = 0; iasy < num_asy; ++iasy) {
+    Int const asy_id = _core.children()[iasy];
+    auto const & assembly = _assemblies[asy_id];
+    Int const num_lat = assembly.children().size();
+    Int const asy_first = num_fsrs;
+    core_offsets[iasy] = asy_first;
+    asy_offsets[asy_id].resize(num_lat);
+    for (Int ilat = 0; ilat < num_lat; ++ilat) {
+      Int const lat_id = assembly.children()[ilat];
+      auto const & lattice = _lattices[lat_id];
+      Int const num_rtm = lattice.children().size();
+      Int const lat_first = num_fsrs;
+      asy_offsets[asy_id][ilat] = lat_first - asy_first;
+      lat_offsets[lat_id].resize(num_rtm);
+      for (Int irtm = 0; irtm < num_rtm; ++irtm) {
+        Int const rtm_id = lattice.children()[irtm];
+        auto const & rtm = _rtms[rtm_id];
+        Int const num_cc = rtm.children().size();
+        Int const rtm_first = num_fsrs;
+        lat_offsets[lat_id][irtm] = rtm_first - lat_first;
+        rtm_offsets[rtm_id].resize(num_cc);
+        for (Int icc = 0; icc < num_cc; ++icc) {
+          Int const cc_id = rtm.children()[icc];
+          instances.push_back({iasy, ilat, irtm, icc, cc_id, num_fsrs});
+          rtm_offsets[rtm_id][icc] = instances.back().fsr_offset - rtm_first;
+          num_fsrs += _coarse_cells[cc_id].numFaces();
+        }
+      }
+    }
+  }
+  _has_instance_table = true;
+  return _instance_table;
+}
+
+auto
+Model::coarseCellInstances() const -> Vector<CoarseCellInstance> const &
+{
+  return instanceTable().instances;
+}
+
+auto
+Model::getFSRLocation(Int const fsr) const -> Pair<Int, Int>
+{
+  auto const & instances = instanceTable().instances;
+  ASSERT(0 <= fsr);
+  ASSERT(fsr < numFineCellsTotal());
+  // The instance is the last one whose first fine cell is not after fsr.
+  // Instances without faces share the offset of the next instance, so they are
+  // skipped.
+  auto const it = std::upper_bound(
+      instances.cbegin(), instances.cend(), fsr,
+      [](Int const f, CoarseCellInstance const & inst) { return f < inst.fsr_offset; });
+  ASSERT(it != instances.cbegin());
+  Int const instance = static_cast<Int>(it - instances.cbegin()) - 1;
+  return {instance, fsr - instances[instance].fsr_offset};
+}
+
+auto
+Model::getFSRIndex(Int const instance, Int const face) const -> Int
+{
+  auto const & instances = instanceTable().instances;
+  ASSERT(0 <= instance);
+  ASSERT(instance < instances.size());
+  ASSERT(0 <= face);
+  ASSERT(face < _coarse_cells[instances[instance].cc_id].numFaces());
+  return instances[instance].fsr_offset + face;
 }
 
 //=============================================================================
@@ -1062,6 +1216,7 @@ auto
 Model::addCore(Vector<Vector<Int>> const & asy_ids) -> Int
 {
   LOG_DEBUG("Adding core");
+  invalidateInstanceTable();
   // Ensure it is not already made
   if (!_core.children().empty()) {
     logger::error("The core has already been made");
@@ -1159,24 +1314,128 @@ Model::addCoarseGrid(Vec2F const xy_extents, Vec2I const xy_num_cells)
 // importCoarseCellMeshes
 //=============================================================================
 
+namespace
+{
+
+// Hash the connectivity and the vertices of a mesh, with each coordinate
+// rounded to a multiple of tol. Meshes with the same connectivity whose
+// vertices differ by less than tol almost always hash equally. They hash
+// differently only if a coordinate straddles a rounding boundary, in which
+// case a duplicate is merely missed.
+template <Int P, Int N>
+PURE auto
+hashMesh(FaceVertexMesh<P, N> const & mesh, Float const tol) -> uint64_t
+{
+  // FNV-1a over 64-bit words
+  uint64_t h = 0xCBF29CE484222325ULL;
+  auto const mix = [&h](uint64_t const word) { h = (h ^ word) * 0x100000001B3ULL; };
+  mix(static_cast<uint64_t>(mesh.numVertices()));
+  mix(static_cast<uint64_t>(mesh.numFaces()));
+  for (auto const & conn : mesh.faceVertexConn()) {
+    for (Int i = 0; i < N; ++i) {
+      mix(static_cast<uint64_t>(conn[i]));
+    }
+  }
+  for (auto const & v : mesh.vertices()) {
+    for (Int i = 0; i < 2; ++i) {
+      auto const q = static_cast<int64_t>(um2::floor(v[i] / tol + castIfNot<Float>(0.5)));
+      mix(static_cast<uint64_t>(q));
+    }
+  }
+  return h;
+}
+
+// Two meshes are congruent if they have the same connectivity and each pair of
+// corresponding vertices is within tol.
+template <Int P, Int N>
+PURE auto
+isCongruent(FaceVertexMesh<P, N> const & a, FaceVertexMesh<P, N> const & b,
+            Float const tol) -> bool
+{
+  if (a.numVertices() != b.numVertices() || a.numFaces() != b.numFaces()) {
+    return false;
+  }
+  for (Int i = 0; i < a.numFaces(); ++i) {
+    if (a.faceVertexConn()[i] != b.faceVertexConn()[i]) {
+      return false;
+    }
+  }
+  Float const tol2 = tol * tol;
+  for (Int i = 0; i < a.numVertices(); ++i) {
+    if (a.getVertex(i).squaredDistanceTo(b.getVertex(i)) > tol2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// If the last mesh is congruent to an earlier one, remove it and return the ID of
+// the earlier mesh. Otherwise, record its hash and return its ID. hashes holds the
+// hash of each mesh but the last, or is empty, in which case it is filled first.
+template <Int P, Int N>
+auto
+deduplicateLastMesh(Vector<FaceVertexMesh<P, N>> & meshes, Vector<uint64_t> & hashes)
+    -> Int
+{
+  auto constexpr tol = epsDistance<Float>();
+  Int const last = meshes.size() - 1;
+  if (hashes.size() != last) {
+    hashes.resize(last);
+    for (Int i = 0; i < last; ++i) {
+      hashes[i] = hashMesh(meshes[i], tol);
+    }
+  }
+  uint64_t const h = hashMesh(meshes[last], tol);
+  for (Int i = 0; i < last; ++i) {
+    if (hashes[i] == h && isCongruent(meshes[i], meshes[last], tol)) {
+      meshes.pop_back();
+      return i;
+    }
+  }
+  hashes.push_back(h);
+  return last;
+}
+
+} // namespace
+
 void
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 Model::importCoarseCellMeshes(String const & filename)
 {
   LOG_INFO("Importing coarse cells from ", filename);
   ASSERT(!_materials.empty());
+  // The number of faces of each coarse cell changes
+  invalidateInstanceTable();
 
-  PolytopeSoup const soup(filename);
+  // Split the soup into the mesh of each coarse cell in one pass
+  Vector<String> cc_names;
+  Vector<PolytopeSoup> cc_meshes;
+  {
+    PolytopeSoup const soup(filename);
+    soup.partitionByElsetPrefix("Coarse_Cell_", cc_names, cc_meshes);
+  }
 
   String cc_name("Coarse_Cell_00000");
 
+  // Hashes of the meshes, used to share a single mesh between coarse cells with
+  // congruent meshes, such as repeated pin types.
+  Vector<uint64_t> tri_hashes;
+  Vector<uint64_t> quad_hashes;
+  Vector<uint64_t> tri6_hashes;
+  Vector<uint64_t> quad8_hashes;
+  Int num_duplicates = 0;
+
   // For each coarse cell
   Int const num_coarse_cells = numCoarseCells();
   for (Int icc = 0; icc < num_coarse_cells; ++icc) {
 
-    // Get the mesh for the coarse cell
-    PolytopeSoup cc_mesh;
-    soup.getSubset(cc_name, cc_mesh);
+    // Get the mesh for the coarse cell. The elsets are sorted by name, so the
+    // coarse cells are in order.
+    if (cc_meshes.size() <= icc || cc_names[icc] != cc_name) {
+      logger::error("Mesh for ", cc_name, " not found");
+      return;
+    }
+    PolytopeSoup & cc_mesh = cc_meshes[icc];
     incrementASCIINumber(cc_name);
 
     // Get the mesh type and material IDs
@@ -1231,25 +1490,25 @@ Model::importCoarseCellMeshes(String const & filename)
     switch (mesh_type) {
     case MeshType::Tri:
       cc.mesh_id = _tris.size();
-      _tris.emplace_back(cc_mesh);
+      _tris.emplace_back(um2::move(cc_mesh));
       bb = _tris.back().boundingBox();
       vertices = _tris.back().vertices().data();
       break;
     case MeshType::Quad:
       cc.mesh_id = _quads.size();
-      _quads.emplace_back(cc_mesh);
+      _quads.emplace_back(um2::move(cc_mesh));
       bb = _quads.back().boundingBox();
       vertices = _quads.back().vertices().data();
       break;
     case MeshType::QuadraticTri:
       cc.mesh_id = _tri6s.size();
-      _tri6s.emplace_back(cc_mesh);
+      _tri6s.emplace_back(um2::move(cc_mesh));
       bb = _tri6s.back().boundingBox();
       vertices = _tri6s.back().vertices().data();
       break;
     case MeshType::QuadraticQuad:
       cc.mesh_id = _quad8s.size();
-      _quad8s.emplace_back(cc_mesh);
+      _quad8s.emplace_back(um2::move(cc_mesh));
       bb = _quad8s.back().boundingBox();
       vertices = _quad8s.back().vertices().data();
       break;
@@ -1267,9 +1526,121 @@ Model::importCoarseCellMeshes(String const & filename)
     Point2F const dxdy = bb.maxima() - bb.minima();
     ASSERT(dxdy.isApprox(cc.xy_extents));
 #endif
+
+    // Share the mesh of an earlier coarse cell if they are congruent
+    Int const new_mesh_id = cc.mesh_id;
+    switch (mesh_type) {
+    case MeshType::Tri:
+      cc.mesh_id = deduplicateLastMesh(_tris, tri_hashes);
+      break;
+    case MeshType::Quad:
+      cc.mesh_id = deduplicateLastMesh(_quads, quad_hashes);
+      break;
+    case MeshType::QuadraticTri:
+      cc.mesh_id = deduplicateLastMesh(_tri6s, tri6_hashes);
+      break;
+    case MeshType::QuadraticQuad:
+      cc.mesh_id = deduplicateLastMesh(_quad8s, quad8_hashes);
+      break;
+    default:
+      break;
+    }
+    if (cc.mesh_id != new_mesh_id) {
+      LOG_DEBUG("Coarse cell ", icc, " shares mesh ", cc.mesh_id);
+      ++num_duplicates;
+    }
+  }
+  if (num_duplicates > 0) {
+    LOG_INFO("Shared ", num_duplicates, " duplicate coarse cell meshes");
   }
+  populateMeshBVHs();
+  populateMeshEdgeCaches();
 } // importCoarseCellMeshes
 
+//=============================================================================
+// spaceFillingCurveSort
+//=============================================================================
+
+namespace
+{
+
+template <Int P, Int N>
+void
+spaceFillingCurveSortMeshes(Vector<FaceVertexMesh<P, N>> & meshes,
+                            Vector<Model::CoarseCell> & coarse_cells,
+                            MeshType const mesh_type, SpaceFillingCurve const curve)
+{
+  // A mesh may be shared by multiple coarse cells with different materials.
+  Int const num_meshes = meshes.size();
+  Vector<Vector<Int>> mesh_ccs;
+  mesh_ccs.resize(num_meshes);
+  for (Int icc = 0; icc < coarse_cells.size(); ++icc) {
+    if (coarse_cells[icc].mesh_type == mesh_type) {
+      mesh_ccs[coarse_cells[icc].mesh_id].emplace_back(icc);
+    }
+  }
+  for (Int imesh = 0; imesh < num_meshes; ++imesh) {
+    Vector<Int> const perm = meshes[imesh].spaceFillingCurveSort(curve);
+    for (auto const icc : mesh_ccs[imesh]) {
+      auto & cc = coarse_cells[icc];
+      ASSERT(cc.material_ids.size() == perm.size());
+      Vector<MatID> sorted_ids(perm.size());
+      for (Int i = 0; i < perm.size(); ++i) {
+        sorted_ids[i] = cc.material_ids[perm[i]];
+      }
+      cc.material_ids = um2::move(sorted_ids);
+    }
+  }
+}
+
+} // namespace
+
+void
+Model::spaceFillingCurveSort(SpaceFillingCurve const curve) noexcept
+{
+  LOG_INFO("Sorting coarse cell meshes along a space-filling curve");
+  spaceFillingCurveSortMeshes(_tris, _coarse_cells, MeshType::Tri, curve);
+  spaceFillingCurveSortMeshes(_quads, _coarse_cells, MeshType::Quad, curve);
+  spaceFillingCurveSortMeshes(_tri6s, _coarse_cells, MeshType::QuadraticTri, curve);
+  spaceFillingCurveSortMeshes(_quad8s, _coarse_cells, MeshType::QuadraticQuad, curve);
+}
+
+//=============================================================================
+// populateMeshBVHs
+//=============================================================================
+
+void
+Model::populateMeshBVHs() noexcept
+{
+  for (auto & mesh : _tris) {
+    mesh.populateBVH();
+  }
+  for (auto & mesh : _quads) {
+    mesh.populateBVH();
+  }
+  for (auto & mesh : _tri6s) {
+    mesh.populateBVH();
+  }
+  for (auto & mesh : _quad8s) {
+    mesh.populateBVH();
+  }
+}
+
+//=============================================================================
+// populateMeshEdgeCaches
+//=============================================================================
+
+void
+Model::populateMeshEdgeCaches() noexcept
+{
+  for (auto & mesh : _tri6s) {
+    mesh.populateEdgeCache();
+  }
+  for (auto & mesh : _quad8s) {
+    mesh.populateEdgeCache();
+  }
+}
+
 //=============================================================================
 // operator PolytopeSoup
 //=============================================================================
@@ -1294,6 +1665,13 @@ Model::operator PolytopeSoup() const noexcept
     one_group_xs[imat] = xs.t(0);
   }
 
+  // Compute the mean chord lengths of each mesh once, rather than for every
+  // instance of the coarse cells which use the mesh.
+  auto const tri_mcls = getMeshMeanChordLengths(_tris);
+  auto const quad_mcls = getMeshMeanChordLengths(_quads);
+  auto const tri6_mcls = getMeshMeanChordLengths(_tri6s);
+  auto const quad8_mcls = getMeshMeanChordLengths(_quad8s);
+
   // Allocate counters for each assembly, lattice, etc.
   Vector<Int> asy_found(_assemblies.size(), -1);
   Vector<Int> lat_found(_lattices.size(), -1);
@@ -1425,36 +1803,28 @@ Model::operator PolytopeSoup() const noexcept
                 MeshType const mesh_type = coarse_cell.mesh_type;
                 Int const mesh_id = coarse_cell.mesh_id;
 
-                Vector<Float> mcls(coarse_cell.numFaces());
+                Vector<Float> mcls;
 
                 switch (mesh_type) {
                 case MeshType::Tri:
                   LOG_DEBUG("Mesh type: Tri");
                   cell_soup = _tris[mesh_id];
-                  for (Int i = 0; i < mcls.size(); ++i) {
-                    mcls[i] = _tris[mesh_id].getFace(i).meanChordLength();
-                  }
+                  mcls = tri_mcls[mesh_id];
                   break;
                 case MeshType::Quad:
                   LOG_DEBUG("Mesh type: Quad");
                   cell_soup = _quads[mesh_id];
-                  for (Int i = 0; i < mcls.size(); ++i) {
-                    mcls[i] = _quads[mesh_id].getFace(i).meanChordLength();
-                  }
+                  mcls = quad_mcls[mesh_id];
                   break;
                 case MeshType::QuadraticTri:
                   LOG_DEBUG("Mesh type: QuadraticTri");
                   cell_soup = _tri6s[mesh_id];
-                  for (Int i = 0; i < mcls.size(); ++i) {
-                    mcls[i] = _tri6s[mesh_id].getFace(i).meanChordLength();
-                  }
+                  mcls = tri6_mcls[mesh_id];
                   break;
                 case MeshType::QuadraticQuad:
                   LOG_DEBUG("Mesh type: QuadraticQuad");
                   cell_soup = _quad8s[mesh_id];
-                  for (Int i = 0; i < mcls.size(); ++i) {
-                    mcls[i] = _quad8s[mesh_id].getFace(i).meanChordLength();
-                  }
+                  mcls = quad8_mcls[mesh_id];
                   break;
                 default:
                   logger::error("Unsupported mesh type");
@@ -1565,6 +1935,18 @@ writeXDMFFile(String const & filepath, Model const & model,
     }
   }
 
+  // The mean chord lengths of each mesh, if requested
+  Vector<Vector<Float>> tri_mcls;
+  Vector<Vector<Float>> quad_mcls;
+  Vector<Vector<Float>> tri6_mcls;
+  Vector<Vector<Float>> quad8_mcls;
+  if (write_knudsen_data) {
+    tri_mcls = getMeshMeanChordLengths(tris);
+    quad_mcls = getMeshMeanChordLengths(quads);
+    tri6_mcls = getMeshMeanChordLengths(tri6s);
+    quad8_mcls = getMeshMeanChordLengths(quad8s);
+  }
+
   // Store a PolytopeSoup for each CoarseCell
   Vector<PolytopeSoup> coarse_cell_soups(coarse_cells.size());
   {
@@ -1580,45 +1962,33 @@ writeXDMFFile(String const & filepath, Model const & model,
       MeshType const mesh_type = coarse_cell.mesh_type;
       Int const mesh_id = coarse_cell.mesh_id;
 
-      if (write_knudsen_data) {
-        mcls.resize(coarse_cell.numFaces());
-      }
-
       switch (mesh_type) {
       case MeshType::Tri:
         LOG_DEBUG("Mesh type: Tri");
         cell_soup = tris[mesh_id];
         if (write_knudsen_data) {
-          for (Int i = 0; i < mcls.size(); ++i) {
-            mcls[i] = tris[mesh_id].getFace(i).meanChordLength();
-          }
+          mcls = tri_mcls[mesh_id];
         }
         break;
       case MeshType::Quad:
         LOG_DEBUG("Mesh type: Quad");
         cell_soup = quads[mesh_id];
         if (write_knudsen_data) {
-          for (Int i = 0; i < mcls.size(); ++i) {
-            mcls[i] = quads[mesh_id].getFace(i).meanChordLength();
-          }
+          mcls = quad_mcls[mesh_id];
         }
         break;
       case MeshType::QuadraticTri:
         LOG_DEBUG("Mesh type: QuadraticTri");
         cell_soup = tri6s[mesh_id];
         if (write_knudsen_data) {
-          for (Int i = 0; i < mcls.size(); ++i) {
-            mcls[i] = tri6s[mesh_id].getFace(i).meanChordLength();
-          }
+          mcls = tri6_mcls[mesh_id];
         }
         break;
       case MeshType::QuadraticQuad:
         LOG_DEBUG("Mesh type: QuadraticQuad");
         cell_soup = quad8s[mesh_id];
         if (write_knudsen_data) {
-          for (Int i = 0; i < mcls.size(); ++i) {
-            mcls[i] = quad8s[mesh_id].getFace(i).meanChordLength();
-          }
+          mcls = quad8_mcls[mesh_id];
         }
         break;
       default:
@@ -2073,6 +2443,36 @@ writeMaterialVolumes(String const & filename, Model const & model)
   auto const & tri6s = model.tri6Meshes();
   auto const & quad8s = model.quad8Meshes();
 
+  // The face areas of each mesh, computed once rather than for every
+  // instance of the coarse cells which use the mesh.
+  auto const tri_areas = getMeshFaceAreas(tris);
+  auto const quad_areas = getMeshFaceAreas(quads);
+  auto const tri6_areas = getMeshFaceAreas(tri6s);
+  auto const quad8_areas = getMeshFaceAreas(quad8s);
+  Int const num_coarse_cells = coarse_cells.size();
+  Vector<Vector<Float> const *> cc_areas;
+  cc_areas.resize(num_coarse_cells);
+  for (Int icc = 0; icc < num_coarse_cells; ++icc) {
+    auto const & cc = coarse_cells[icc];
+    switch (cc.mesh_type) {
+    case MeshType::Tri:
+      cc_areas[icc] = &tri_areas[cc.mesh_id];
+      break;
+    case MeshType::Quad:
+      cc_areas[icc] = &quad_areas[cc.mesh_id];
+      break;
+    case MeshType::QuadraticTri:
+      cc_areas[icc] = &tri6_areas[cc.mesh_id];
+      break;
+    case MeshType::QuadraticQuad:
+      cc_areas[icc] = &quad8_areas[cc.mesh_id];
+      break;
+    default:
+      logger::error("Unsupported mesh type");
+      return;
+    }
+  }
+
   Int const nmats = materials.size();
   Vector<Vector<Float>> volumes(nmats);
   // For each assembly in the core
@@ -2091,51 +2491,13 @@ writeMaterialVolumes(String const & filename, Model const & model)
       for (auto const & rtm_id : lattices[lat_id].children()) {
         // For each coarse cell in the RTM
         for (auto const & cc_id : rtms[rtm_id].children()) {
-          // Get the coarse cell
           auto const & cc = coarse_cells[cc_id];
-          // Based on the mesh type, find the area of each face
-          // NOLINTBEGIN(bugprone-signed-char-misuse,cert-str34-c)
-          switch (cc.mesh_type) {
-          case MeshType::Tri: {
-            auto const & mesh = tris[cc.mesh_id];
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              auto const mat_id = static_cast<Int>(cc.material_ids[i]);
-              volumes[mat_id].emplace_back(mesh.getFace(i).area() * dz);
-            }
-            break;
-          }
-          case MeshType::Quad: {
-            auto const & mesh = quads[cc.mesh_id];
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              auto const mat_id = static_cast<Int>(cc.material_ids[i]);
-              volumes[mat_id].emplace_back(mesh.getFace(i).area() * dz);
-            }
-            break;
-          }
-          case MeshType::QuadraticTri: {
-            auto const & mesh = tri6s[cc.mesh_id];
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              auto const mat_id = static_cast<Int>(cc.material_ids[i]);
-              volumes[mat_id].emplace_back(mesh.getFace(i).area() * dz);
-            }
-            break;
-          }
-          case MeshType::QuadraticQuad: {
-            auto const & mesh = quad8s[cc.mesh_id];
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              auto const mat_id = static_cast<Int>(cc.material_ids[i]);
-              volumes[mat_id].emplace_back(mesh.getFace(i).area() * dz);
-            }
-            break;
-          }
-          default:
-            logger::error("Unsupported mesh type");
+          auto const & areas = *cc_areas[cc_id];
+          for (Int i = 0; i < areas.size(); ++i) {
+            // NOLINTNEXTLINE(bugprone-signed-char-misuse,cert-str34-c)
+            auto const mat_id = static_cast<Int>(cc.material_ids[i]);
+            volumes[mat_id].emplace_back(areas[i] * dz);
           }
-          // NOLINTEND(bugprone-signed-char-misuse,cert-str34-c)
         }
       }
     }
@@ -2966,6 +3328,8 @@ Model::read(String const & filename)
 {
   if (filename.ends_with(".xdmf")) {
     readXDMFFile(filename, *this);
+    populateMeshBVHs();
+    populateMeshEdgeCaches();
   } else {
     logger::error("Unsupported file format.");
   }
@@ -3080,14 +3444,18 @@ computeCellHomogenizedXSec(FaceVertexMesh<P, N> const & fvm,
   Vector<Float> areas(materials.size(), zero);
 
   Int const num_faces = fvm.numFaces();
+  Vector<Float> face_areas(num_faces);
+  PackedFaceVertexMesh<P, N>(fvm).faceAreas(face_areas.data());
   for (Int iface = 0; iface < num_faces; ++iface) {
-    auto const a_i = fvm.getFace(iface).area();
     auto const mat_id = material_ids[iface];
-    areas[static_cast<Int>(mat_id)] += a_i;
+    areas[static_cast<Int>(mat_id)] += face_areas[iface];
   }
 
-  XSec result(num_groups);
-  // For each material with non-zero area, reduce into result
+  // Reduce the materials with non-zero area into the area-weighted average
+  auto const total_area = um2::sum(areas.cbegin(), areas.cend());
+  auto const inv_total_area = 1 / total_area;
+  Vector<XSec const *> xsecs;
+  Vector<Float> weights;
   for (Int imat = 0; imat < materials.size(); ++imat) {
     // Want exact comparison to zero
 #pragma GCC diagnostic push
@@ -3096,35 +3464,14 @@ computeCellHomogenizedXSec(FaceVertexMesh<P, N> const & fvm,
       continue;
     }
 #pragma GCC diagnostic pop
-    auto const & xsec = materials[imat].xsec();
-    // a, f, nuf, tr, s, ss
-    for (Int ig = 0; ig < num_groups; ++ig) {
-      result.a()[ig] += areas[imat] * xsec.a()[ig];
-      result.f()[ig] += areas[imat] * xsec.f()[ig];
-      result.nuf()[ig] += areas[imat] * xsec.nuf()[ig];
-      result.tr()[ig] += areas[imat] * xsec.tr()[ig];
-      result.s()[ig] += areas[imat] * xsec.s()[ig];
-      for (Int jg = 0; jg < num_groups; ++jg) {
-        result.ss()(jg, ig) += areas[imat] * xsec.ss()(jg, ig);
-      }
-    }
+    xsecs.emplace_back(&materials[imat].xsec());
+    weights.emplace_back(areas[imat] * inv_total_area);
   }
-
-  // Normalize by the total area
-  auto const total_area = um2::sum(areas.cbegin(), areas.cend());
-  auto const inv_total_area = 1 / total_area;
+  XSec result = weightedSum(xsecs.size(), xsecs.data(), weights.data());
   for (Int ig = 0; ig < num_groups; ++ig) {
-    result.a()[ig] *= inv_total_area;
-    result.f()[ig] *= inv_total_area;
     if (result.f()[ig] > 0) {
       result.isFissile() = true;
     }
-    result.nuf()[ig] *= inv_total_area;
-    result.tr()[ig] *= inv_total_area;
-    result.s()[ig] *= inv_total_area;
-    for (Int jg = 0; jg < num_groups; ++jg) {
-      result.ss()(jg, ig) *= inv_total_area;
-    }
   }
 
   result.isMacro() = true;
@@ -3172,77 +3519,173 @@ Model::getCoarseCellHomogenizedXSec(Int cc_id) const -> XSec
   return {};
 } // getCoarseCellHomogenizedXSec
 
-PURE auto
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto
 Model::getMeanChordLengths() const -> Vector<Float>
 {
-  Int total_num_cells = 0;
-  for (auto const & asy_id : _core.children()) {
-    for (auto const & lat_id : _assemblies[asy_id].children()) {
-      for (auto const & rtm_id : _lattices[lat_id].children()) {
-        for (auto const & cc_id : _rtms[rtm_id].children()) {
-          total_num_cells += _coarse_cells[cc_id].numFaces();
-        }
-      }
+  // Compute the mean chord lengths of each mesh once, then copy them into
+  // every instance of the coarse cells which use the mesh.
+  auto const tri_mcls = getMeshMeanChordLengths(_tris);
+  auto const quad_mcls = getMeshMeanChordLengths(_quads);
+  auto const tri6_mcls = getMeshMeanChordLengths(_tri6s);
+  auto const quad8_mcls = getMeshMeanChordLengths(_quad8s);
+
+  auto const & instances = coarseCellInstances();
+  Vector<Float> result(numFineCellsTotal(), 0);
+  Int const num_instances = instances.size();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = 0; i < num_instances; ++i) {
+    auto const & cc = _coarse_cells[instances[i].cc_id];
+    Vector<Float> const * mcls = nullptr;
+    switch (cc.mesh_type) {
+    case MeshType::Tri:
+      mcls = &tri_mcls[cc.mesh_id];
+      break;
+    case MeshType::Quad:
+      mcls = &quad_mcls[cc.mesh_id];
+      break;
+    case MeshType::QuadraticTri:
+      mcls = &tri6_mcls[cc.mesh_id];
+      break;
+    case MeshType::QuadraticQuad:
+      mcls = &quad8_mcls[cc.mesh_id];
+      break;
+    default:
+      logger::error("Unsupported mesh type");
+      continue;
     }
-  }
-  Vector<Float> result(total_num_cells, 0);
-  Int ctr = 0;
-  for (auto const & asy_id : _core.children()) {
-    for (auto const & lat_id : _assemblies[asy_id].children()) {
-      for (auto const & rtm_id : _lattices[lat_id].children()) {
-        for (auto const & cc_id : _rtms[rtm_id].children()) {
-          // Get the coarse cell
-          auto const & cc = _coarse_cells[cc_id];
-
-          // Call the appropriate function based on the mesh type
-          switch (cc.mesh_type) {
-          case MeshType::Tri: {
-            auto const & mesh = getTriMesh(cc.mesh_id);
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              result[ctr + i] = mesh.getFace(i).meanChordLength();
-            }
-            ctr += num_faces;
-            break;
-          }
-          case MeshType::Quad: {
-            auto const & mesh = getQuadMesh(cc.mesh_id);
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              result[ctr + i] = mesh.getFace(i).meanChordLength();
-            }
-            ctr += num_faces;
-            break;
-          }
-          case MeshType::QuadraticTri: {
-            auto const & mesh = getTri6Mesh(cc.mesh_id);
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              result[ctr + i] = mesh.getFace(i).meanChordLength();
-            }
-            ctr += num_faces;
-            break;
-          }
-          case MeshType::QuadraticQuad: {
-            auto const & mesh = getQuad8Mesh(cc.mesh_id);
-            Int const num_faces = mesh.numFaces();
-            for (Int i = 0; i < num_faces; ++i) {
-              result[ctr + i] = mesh.getFace(i).meanChordLength();
-            }
-            ctr += num_faces;
-            break;
-          }
-          default:
-            logger::error("Unsupported mesh type");
-          }
-        }
-      }
+    Int const offset = instances[i].fsr_offset;
+    Int const num_faces = mcls->size();
+    for (Int j = 0; j < num_faces; ++j) {
+      result[offset + j] = (*mcls)[j];
     }
   }
   return result;
 } // getMeanChordLengths
 
+//==============================================================================
+// findFSR
+//==============================================================================
+
+namespace
+{
+
+PURE auto
+coarseCellFaceContaining(Model const & model, Model::CoarseCell const & cc,
+                         Point2F const p) -> Int
+{
+  switch (cc.mesh_type) {
+  case MeshType::Tri:
+    return model.getTriMesh(cc.mesh_id).faceContaining(p);
+  case MeshType::Quad:
+    return model.getQuadMesh(cc.mesh_id).faceContaining(p);
+  case MeshType::QuadraticTri:
+    return model.getTri6Mesh(cc.mesh_id).faceContaining(p);
+  case MeshType::QuadraticQuad:
+    return model.getQuad8Mesh(cc.mesh_id).faceContaining(p);
+  default:
+    logger::error("Unsupported mesh type");
+    return -1;
+  }
+}
+
+// Return the flat index of the cell of the 2D grid containing p, or -1. p is
+// then made relative to the lower left corner of the cell.
+template <class Grid>
+auto
+descend(Grid const & grid, Point2F & p) -> Int
+{
+  auto const index = grid.getCellIndexContaining(p);
+  if (index[0] == -1 || index[1] == -1) {
+    return -1;
+  }
+  p -= grid.getBox(index[0], index[1]).minima();
+  return index[1] * grid.numCells(0) + index[0];
+}
+
+template <Int D>
+auto
+findFSRs(Model const & model, Vector<Point<D, Float>> const & points) -> Vector<Int>
+{
+  // Build the instance table before the parallel region
+  [[maybe_unused]] auto const & instances = model.coarseCellInstances();
+  Vector<Int> result(points.size());
+  Int const num_points = points.size();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Int i = 0; i < num_points; ++i) {
+    result[i] = model.findFSR(points[i]);
+  }
+  return result;
+}
+
+} // namespace
+
+auto
+Model::locateFSR(Point2F xy, Float const z, bool const use_z) const -> Int
+{
+  Int const iasy = descend(_core.grid(), xy);
+  if (iasy == -1) {
+    return -1;
+  }
+  Int const asy_id = _core.children()[iasy];
+  auto const & assembly = _assemblies[asy_id];
+  Int ilat = 0;
+  if (use_z) {
+    ilat = assembly.grid().getCellIndexContaining(Point1<Float>(z))[0];
+    if (ilat == -1) {
+      return -1;
+    }
+  }
+  Int const lat_id = assembly.children()[ilat];
+  auto const & lattice = _lattices[lat_id];
+  Int const irtm = descend(lattice.grid(), xy);
+  if (irtm == -1) {
+    return -1;
+  }
+  Int const rtm_id = lattice.children()[irtm];
+  auto const & rtm = _rtms[rtm_id];
+  Int const icc = descend(rtm.grid(), xy);
+  if (icc == -1) {
+    return -1;
+  }
+  Int const face_id =
+      coarseCellFaceContaining(*this, _coarse_cells[rtm.children()[icc]], xy);
+  if (face_id == -1) {
+    return -1;
+  }
+  auto const & table = instanceTable();
+  return table.core_fsr_offsets[iasy] + table.assembly_fsr_offsets[asy_id][ilat] +
+         table.lattice_fsr_offsets[lat_id][irtm] + table.rtm_fsr_offsets[rtm_id][icc] +
+         face_id;
+}
+
+auto
+Model::findFSR(Point2F const p) const -> Int
+{
+  return locateFSR(p, 0, false);
+}
+
+auto
+Model::findFSR(Point3F const p) const -> Int
+{
+  return locateFSR(Point2F(p[0], p[1]), p[2], true);
+}
+
+auto
+Model::findFSRs(Vector<Point2F> const & points) const -> Vector<Int>
+{
+  return um2::mpact::findFSRs(*this, points);
+}
+
+auto
+Model::findFSRs(Vector<Point3F> const & points) const -> Vector<Int>
+{
+  return um2::mpact::findFSRs(*this, points);
+}
+
 //==============================================================================
 // writeCMFDInfo
 //==============================================================================
@@ -7,6 +7,7 @@
 #include <um2/math/stats.hpp>
 #include <um2/mesh/element_types.hpp>
 #include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mesh/packed_face_vertex_mesh.hpp>
 #include <um2/mesh/polytope_soup.hpp>
 #include <um2/mpact/powers.hpp>
 #include <um2/stdlib/algorithm/copy.hpp>
@@ -93,13 +94,13 @@ getPowers(PolytopeSoup const & soup) -> Vector<Pair<Float, Point2F>>
   Int const num_faces = fvm.numFaces();
   Vector<Int> nonzero_power_ids;
   nonzero_power_ids.reserve(num_faces);
-  // We allocate AABBs for each face, but only populate the ones that have
-  // non-zero power. This makes indexing easier.
+  // We compute AABBs for each face, but only use the ones that have non-zero
+  // power. This makes indexing easier.
   Vector<AxisAlignedBox2F> face_aabbs(num_faces);
+  PackedFaceVertexMesh<P, N>(fvm).faceBoundingBoxes(face_aabbs.data());
   for (Int i = 0; i < num_faces; ++i) {
     if (power_data[i] > 0) {
       nonzero_power_ids.emplace_back(i);
-      face_aabbs[i] = fvm.getFace(i).boundingBox();
       // Scale the box up by 1% to avoid floating point issues
       // with AABB intersection tests later on
       auto constexpr scale = castIfNot<Float>(1.01);
@@ -0,0 +1,405 @@
+#include <um2/common/logger.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/modular_rays.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/element_types.hpp>
+#include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mpact/model.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/algorithm/min.hpp>
+#include <um2/stdlib/utility/pair.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <algorithm> // sort
+
+namespace um2::mpact
+{
+
+namespace
+{
+
+// The maximum number of intersections of a ray with a single face, plus room for
+// the coordinate written by a missed linear edge.
+Int constexpr max_hits_per_face = 9;
+
+// Buffers for the intersection of a ray with a coarse cell mesh.
+struct IntersectionBuffers {
+  Vector<Float> coords;
+  Vector<Int> offsets;
+  Vector<Int> faces;
+  Vector<Pair<Float, Int>> hits; // (ray coordinate, face)
+  Vector<Int> clusters;          // index of the first hit in each cluster
+
+  explicit IntersectionBuffers(Int max_faces)
+      : coords(max_hits_per_face * max_faces),
+        offsets(max_faces + 1),
+        faces(max_faces)
+  {
+    hits.reserve(max_hits_per_face * max_faces);
+    clusters.reserve(max_hits_per_face * max_faces);
+  }
+};
+
+// Intersect the ray with the mesh and append the segments, ordered along the ray.
+// The ray is in the coordinate system of the mesh.
+//
+// Pairing the intersections of each face is not robust: a ray passing through a
+// vertex may hit both edges at the vertex or, due to floating point error,
+// neither of them. Instead, the intersections of all faces are sorted and merged
+// into clusters of coincident points. The ray between two consecutive clusters
+// lies in the face common to both clusters. If there is no unique common face,
+// the face containing the midpoint is used.
+template <Int P, Int N>
+void
+traceCoarseCell(FaceVertexMesh<P, N> const & mesh, Ray2F const ray, Int const fsr_offset,
+                IntersectionBuffers & buf, Vector<Int> & fsr_ids, Vector<Float> & lengths)
+{
+  Float constexpr eps = epsDistance<Float>();
+  auto const hits_faces =
+      mesh.intersect(ray, buf.coords.data(), buf.offsets.data(), buf.faces.data());
+  auto & hits = buf.hits;
+  hits.clear();
+  for (Int i = 0; i < hits_faces[1]; ++i) {
+    for (Int j = buf.offsets[i]; j < buf.offsets[i + 1]; ++j) {
+      hits.emplace_back(buf.coords[j], buf.faces[i]);
+    }
+  }
+  if (hits.empty()) {
+    return;
+  }
+  std::sort(hits.begin(), hits.end());
+
+  // Merge coincident intersections.
+  auto & clusters = buf.clusters;
+  clusters.clear();
+  clusters.emplace_back(0);
+  for (Int i = 1; i < hits.size(); ++i) {
+    if (hits[i].first - hits[clusters.back()].first > eps) {
+      clusters.emplace_back(i);
+    }
+  }
+  clusters.emplace_back(hits.size());
+
+  Int const num_intervals = clusters.size() - 2;
+  for (Int ic = 0; ic < num_intervals; ++ic) {
+    Int const a_begin = clusters[ic];
+    Int const b_begin = clusters[ic + 1];
+    Int const b_end = clusters[ic + 2];
+    Float const r0 = hits[a_begin].first;
+    Float const r1 = hits[b_begin].first;
+
+    // Find the face common to both clusters.
+    Int face = -1;
+    Int num_common = 0;
+    for (Int i = a_begin; i < b_begin; ++i) {
+      for (Int j = b_begin; j < b_end; ++j) {
+        if (hits[i].second == hits[j].second && hits[i].second != face) {
+          face = hits[i].second;
+          ++num_common;
+        }
+      }
+    }
+    if (num_common != 1) {
+      face = -1;
+      auto const midpoint = ray((r0 + r1) / 2);
+      for (Int i = a_begin; i < b_end && face == -1; ++i) {
+        if (mesh.getFace(hits[i].second).contains(midpoint)) {
+          face = hits[i].second;
+        }
+      }
+      if (face == -1) {
+        continue;
+      }
+    }
+
+    // Extend the previous segment if the ray is still in the same face.
+    Int const fsr_id = fsr_offset + face;
+    if (ic > 0 && !fsr_ids.empty() && fsr_ids.back() == fsr_id) {
+      lengths.back() += r1 - r0;
+    } else {
+      fsr_ids.emplace_back(fsr_id);
+      lengths.emplace_back(r1 - r0);
+    }
+  }
+}
+
+// Trace the ray through each coarse cell of the RTM.
+// cc_fsr_offsets[i] is the FSR index of the first face of the i-th coarse cell,
+// local to the RTM. tri6s and quad8s are the quadratic meshes of the model.
+void
+traceRTM(Model const & model, Model::RTM const & rtm, Ray2F const ray,
+         Vector<Int> const & cc_fsr_offsets, Vector<Tri6FVM> const & tri6s,
+         Vector<Quad8FVM> const & quad8s, IntersectionBuffers & buf,
+         Vector<Pair<Float, Int>> & cc_order, SegmentTemplate & segments)
+{
+  // Find the coarse cells crossed by the ray and sort them by entry distance.
+  auto const & grid = rtm.grid();
+  Int const nx = grid.numCells(0);
+  Int const ny = grid.numCells(1);
+  auto const inv_dir = ray.inverseDirection();
+  cc_order.clear();
+  for (Int j = 0; j < ny; ++j) {
+    for (Int i = 0; i < nx; ++i) {
+      auto const r = grid.getBox(i, j).intersect(ray, inv_dir);
+      if (r[1] - r[0] > epsDistance<Float>()) {
+        cc_order.emplace_back(r[0], i + nx * j);
+      }
+    }
+  }
+  std::sort(cc_order.begin(), cc_order.end());
+
+  for (auto const & r_icc : cc_order) {
+    Int const icc = r_icc.second;
+    auto const & cc = model.getCoarseCell(rtm.children()[icc]);
+    // Move the ray into the coordinate system of the coarse cell.
+    auto const cc_min = grid.getBox(icc % nx, icc / nx).minima();
+    Ray2F const cc_ray(ray.origin() - cc_min, ray.direction());
+    Int const fsr_offset = cc_fsr_offsets[icc];
+    switch (cc.mesh_type) {
+    case MeshType::Tri:
+      traceCoarseCell(model.getTriMesh(cc.mesh_id), cc_ray, fsr_offset, buf,
+                      segments.fsr_ids, segments.lengths);
+      break;
+    case MeshType::Quad:
+      traceCoarseCell(model.getQuadMesh(cc.mesh_id), cc_ray, fsr_offset, buf,
+                      segments.fsr_ids, segments.lengths);
+      break;
+    case MeshType::QuadraticTri:
+      traceCoarseCell(tri6s[cc.mesh_id], cc_ray, fsr_offset, buf, segments.fsr_ids,
+                      segments.lengths);
+      break;
+    case MeshType::QuadraticQuad:
+      traceCoarseCell(quad8s[cc.mesh_id], cc_ray, fsr_offset, buf, segments.fsr_ids,
+                      segments.lengths);
+      break;
+    default:
+      logger::error("Unsupported mesh type");
+    }
+  }
+}
+
+} // namespace
+
+//==============================================================================
+// getSegmentTemplates
+//==============================================================================
+
+auto
+getSegmentTemplates(Model const & model, Vector<Float> const & angles,
+                    Float const spacing) -> SegmentTemplates
+{
+  LOG_INFO("Tracing modular rays for ", angles.size(), " angles with spacing ",
+           spacing);
+  SegmentTemplates templates;
+  if (model.numRTMs() == 0) {
+    logger::error("Model has no RTMs");
+    return templates;
+  }
+  if (spacing <= 0) {
+    logger::error("Ray spacing must be positive");
+    return templates;
+  }
+
+  // Every RTM must have the same width and height for the rays to be cyclic.
+  auto const rtm_box = model.getRTM(0).grid().boundingBox();
+  for (auto const & rtm : model.rtms()) {
+    if (!rtm.grid().boundingBox().isApprox(rtm_box)) {
+      logger::error("RTMs must all have the same width and height");
+      return templates;
+    }
+  }
+
+  // Create the modular rays for each angle.
+  Int const num_angles = angles.size();
+  templates.params.resize(num_angles);
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    Float const a = angles[ia];
+    if (a <= 0 || pi<Float> <= a) {
+      logger::error("Azimuthal angles must be in (0, π)");
+      return templates;
+    }
+    templates.params[ia] = ModularRayParams<Float>(a, spacing, rtm_box);
+  }
+
+  // The unique RTM and global FSR offset of each RTM in the core, in the global
+  // order, and the FSR offset of each coarse cell local to its RTM. Both are
+  // taken from the coarse cell instances, which define the global FSR order.
+  // The offsets local to an RTM are the same for every instance of the RTM.
+  auto const & instances = model.coarseCellInstances();
+  Int const num_rtms = model.numRTMsTotal();
+  templates.rtm_ids.reserve(num_rtms);
+  templates.fsr_offsets.reserve(num_rtms);
+  Vector<Int> rtm_counts(model.numRTMs(), 0); // number of instances of each RTM
+  Vector<Vector<Int>> cc_fsr_offsets(model.numRTMs());
+  Int rtm_first = 0;
+  for (auto const & instance : instances) {
+    Int const asy_id = model.core().children()[instance.assembly];
+    Int const lat_id = model.getAssembly(asy_id).children()[instance.lattice];
+    Int const rtm_id = model.getLattice(lat_id).children()[instance.rtm];
+    if (instance.coarse_cell == 0) {
+      rtm_first = instance.fsr_offset;
+      templates.rtm_ids.emplace_back(rtm_id);
+      templates.fsr_offsets.emplace_back(rtm_first);
+      ++rtm_counts[rtm_id];
+      cc_fsr_offsets[rtm_id].resize(model.getRTM(rtm_id).children().size());
+    }
+    cc_fsr_offsets[rtm_id][instance.coarse_cell] = instance.fsr_offset - rtm_first;
+  }
+
+  // Find the largest mesh to size the buffers.
+  Int max_faces = 0;
+  for (auto const & cc : model.coarseCells()) {
+    max_faces = um2::max(max_faces, cc.numFaces());
+  }
+
+  // Each quadratic mesh is intersected by many rays. Their edge caches are
+  // populated by the model (see Model::populateMeshEdgeCaches).
+  auto const & tri6s = model.tri6Meshes();
+  auto const & quad8s = model.quad8Meshes();
+
+  // Trace each modular ray of each angle through each unique RTM which is
+  // used in the core. The rays of each (RTM, angle) pair are split into
+  // contiguous blocks, which are traced in parallel with per-thread buffers.
+  // The blocks are then concatenated in ray order, so the templates are
+  // identical to those traced serially.
+#if UM2_USE_OPENMP
+  Int const num_threads = static_cast<Int>(omp_get_max_threads());
+#else
+  Int const num_threads = 1;
+#endif
+  Vector<Vec3I> work; // (template index, first ray, last ray)
+  for (Int rtm_id = 0; rtm_id < model.numRTMs(); ++rtm_id) {
+    if (rtm_counts[rtm_id] == 0) {
+      continue;
+    }
+    for (Int ia = 0; ia < num_angles; ++ia) {
+      Int const num_rays = templates.params[ia].getTotalNumRays();
+      Int const num_blocks = um2::min(num_rays, 4 * num_threads);
+      for (Int ib = 0; ib < num_blocks; ++ib) {
+        work.emplace_back(rtm_id * num_angles + ia, (ib * num_rays) / num_blocks,
+                          ((ib + 1) * num_rays) / num_blocks);
+      }
+    }
+  }
+  Int const num_work = work.size();
+  Vector<SegmentTemplate> blocks(num_work);
+
+#if UM2_USE_OPENMP
+#  pragma omp parallel num_threads(num_threads)
+#endif
+  {
+    IntersectionBuffers buf(max_faces);
+    Vector<Pair<Float, Int>> cc_order;
+#if UM2_USE_OPENMP
+#  pragma omp for schedule(dynamic, 1)
+#endif
+    for (Int iw = 0; iw < num_work; ++iw) {
+      Int const rtm_id = work[iw][0] / num_angles;
+      Int const ia = work[iw][0] % num_angles;
+      auto const & params = templates.params[ia];
+      auto & block = blocks[iw];
+      block.segment_offsets.reserve(work[iw][2] - work[iw][1] + 1);
+      block.segment_offsets.emplace_back(0);
+      for (Int iray = work[iw][1]; iray < work[iw][2]; ++iray) {
+        traceRTM(model, model.getRTM(rtm_id), params.getRay(iray),
+                 cc_fsr_offsets[rtm_id], tri6s, quad8s, buf, cc_order, block);
+        block.segment_offsets.emplace_back(block.fsr_ids.size());
+      }
+    }
+  }
+
+  // Concatenate the blocks of each template in ray order.
+  templates.templates.resize(model.numRTMs() * num_angles);
+  for (Int iw = 0; iw < num_work; ++iw) {
+    auto & segments = templates.templates[work[iw][0]];
+    auto const & block = blocks[iw];
+    if (segments.segment_offsets.empty()) {
+      segments.segment_offsets.emplace_back(0);
+    }
+    Int const seg_offset = segments.fsr_ids.size();
+    for (Int i = 1; i < block.segment_offsets.size(); ++i) {
+      segments.segment_offsets.emplace_back(seg_offset + block.segment_offsets[i]);
+    }
+    for (Int i = 0; i < block.numSegments(); ++i) {
+      segments.fsr_ids.emplace_back(block.fsr_ids[i]);
+      segments.lengths.emplace_back(block.lengths[i]);
+    }
+  }
+  return templates;
+}
+
+//==============================================================================
+// stitchSegmentTemplates
+//==============================================================================
+
+auto
+stitchSegmentTemplates(SegmentTemplates const & templates) -> ModularRaySegments
+{
+  ModularRaySegments segments;
+  segments.params = templates.params;
+  Int const num_angles = templates.numAngles();
+  Int const num_rtms = templates.numRTMs();
+
+  // Compute the first ray and segment of each (angle, RTM) pair, so the
+  // templates can be copied independently.
+  Int const num_pairs = num_angles * num_rtms;
+  Vector<Int> ray_starts(num_pairs + 1);
+  Vector<Int> seg_starts(num_pairs + 1);
+  ray_starts[0] = 0;
+  seg_starts[0] = 0;
+  segments.ray_offsets.resize(num_angles + 1);
+  segments.ray_offsets[0] = 0;
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    for (Int irtm = 0; irtm < num_rtms; ++irtm) {
+      Int const ip = ia * num_rtms + irtm;
+      auto const & t = templates.getTemplate(templates.rtm_ids[irtm], ia);
+      ray_starts[ip + 1] = ray_starts[ip] + t.numRays();
+      seg_starts[ip + 1] = seg_starts[ip] + t.numSegments();
+    }
+    segments.ray_offsets[ia + 1] = ray_starts[(ia + 1) * num_rtms];
+  }
+  Int const num_rays = ray_starts[num_pairs];
+  Int const num_segments = seg_starts[num_pairs];
+  segments.segment_offsets.resize(num_rays + 1);
+  segments.fsr_ids.resize(num_segments);
+  segments.lengths.resize(num_segments);
+  segments.segment_offsets[0] = 0;
+
+  // Copy each template, adding the FSR offset of the RTM.
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for (Int ip = 0; ip < num_pairs; ++ip) {
+    Int const ia = ip / num_rtms;
+    Int const irtm = ip % num_rtms;
+    auto const & t = templates.getTemplate(templates.rtm_ids[irtm], ia);
+    Int const fsr_offset = templates.fsr_offsets[irtm];
+    Int const iray = ray_starts[ip];
+    Int const iseg = seg_starts[ip];
+    for (Int i = 0; i < t.numRays(); ++i) {
+      segments.segment_offsets[iray + i + 1] = iseg + t.segment_offsets[i + 1];
+    }
+    for (Int i = 0; i < t.numSegments(); ++i) {
+      segments.fsr_ids[iseg + i] = fsr_offset + t.fsr_ids[i];
+      segments.lengths[iseg + i] = t.lengths[i];
+    }
+  }
+  return segments;
+}
+
+//==============================================================================
+// traceModularRays
+//==============================================================================
+
+auto
+traceModularRays(Model const & model, Vector<Float> const & angles,
+                 Float const spacing) -> ModularRaySegments
+{
+  return stitchSegmentTemplates(getSegmentTemplates(model, angles, spacing));
+}
+
+} // namespace um2::mpact
@@ -0,0 +1,603 @@
+#include <um2/common/logger.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/modular_rays.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/mpact/segment_file.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/string.hpp>
+#include <um2/stdlib/utility/move.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <bit>      // bit_cast
+#include <cmath>    // isfinite, ldexp, lround
+#include <cstdint>  // int32_t, int64_t, uint16_t, uint32_t, uint64_t, INT32_MAX
+#include <cstring>  // memcmp, memcpy
+#include <fstream>  // ofstream
+#include <string>   // string
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+namespace um2::mpact
+{
+
+namespace
+{
+
+char constexpr segment_file_magic[8] = {'U', 'M', '2', 'S', 'E', 'G', 'S', '\0'};
+int32_t constexpr segment_file_version = 1;
+
+struct SegmentFileHeader {
+  char magic[8];
+  int32_t version;
+  int32_t length_format;
+  int32_t num_angles;
+  int32_t num_rays;
+  int64_t num_segments;
+  double length_scale; // Quantized16 only
+  // Byte offsets of each section from the start of the file
+  int64_t params_offset;
+  int64_t ray_offsets_offset;
+  int64_t segment_offsets_offset;
+  int64_t fsr_offsets_offset;
+  int64_t fsr_data_offset;
+  int64_t lengths_offset;
+  int64_t file_size;
+};
+
+struct SegmentFileParams {
+  double box[4]; // xmin, ymin, xmax, ymax
+  double spacing[2];
+  double direction[2];
+  int32_t num_rays[2];
+};
+
+static_assert(sizeof(SegmentFileHeader) % 8 == 0);
+static_assert(sizeof(SegmentFileParams) % 8 == 0);
+
+CONST constexpr auto
+alignTo8(int64_t n) noexcept -> int64_t
+{
+  return (n + 7) & ~static_cast<int64_t>(7);
+}
+
+//==============================================================================
+// Variable-length integers
+//==============================================================================
+// Zigzag encoding maps small signed deltas to small unsigned integers, which
+// are then written 7 bits at a time, least significant group first. The high
+// bit of each byte is set if more bytes follow.
+
+void
+writeVarint(int64_t const value, Vector<unsigned char> & out)
+{
+  auto z = (static_cast<uint64_t>(value) << 1U) ^ static_cast<uint64_t>(value >> 63);
+  while (z >= 0x80U) {
+    out.emplace_back(static_cast<unsigned char>(z | 0x80U));
+    z >>= 7U;
+  }
+  out.emplace_back(static_cast<unsigned char>(z));
+}
+
+// Read a variable-length integer from [p, end) into value and advance p.
+// Return false if the integer is cut off by end or is too long.
+auto
+readVarint(unsigned char const *& p, unsigned char const * const end,
+           int64_t & value) noexcept -> bool
+{
+  uint64_t z = 0;
+  for (uint32_t shift = 0; p != end && shift < 64; shift += 7) {
+    uint32_t const byte = *p;
+    ++p;
+    z |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0) {
+      value = static_cast<int64_t>(z >> 1U) ^ -static_cast<int64_t>(z & 1U);
+      return true;
+    }
+  }
+  return false;
+}
+
+//==============================================================================
+// Half precision
+//==============================================================================
+// IEEE 754 binary16, round to nearest even.
+
+CONST auto
+floatToHalf(float const f) noexcept -> uint16_t
+{
+  auto x = std::bit_cast<uint32_t>(f);
+  auto const sign = static_cast<uint16_t>((x >> 16U) & 0x8000U);
+  x &= 0x7FFFFFFFU;
+  if (x >= 0x7F800000U) { // Inf or NaN
+    return static_cast<uint16_t>(sign | (x > 0x7F800000U ? 0x7E00U : 0x7C00U));
+  }
+  if (x >= 0x477FF000U) { // Rounds to >= 65520 -> Inf
+    return static_cast<uint16_t>(sign | 0x7C00U);
+  }
+  if (x < 0x38800000U) { // Subnormal half
+    if (x < 0x33000000U) {
+      return sign;
+    }
+    uint32_t const e = x >> 23U;
+    uint32_t const m = (x & 0x7FFFFFU) | 0x800000U;
+    uint32_t const shift = 126U - e;
+    uint32_t h = m >> shift;
+    uint32_t const rem = m & ((1U << shift) - 1U);
+    uint32_t const halfway = 1U << (shift - 1U);
+    if (rem > halfway || (rem == halfway && (h & 1U) != 0)) {
+      ++h;
+    }
+    return static_cast<uint16_t>(sign | h);
+  }
+  uint32_t h = (x - 0x38000000U) >> 13U;
+  uint32_t const rem = x & 0x1FFFU;
+  if (rem > 0x1000U || (rem == 0x1000U && (h & 1U) != 0)) {
+    ++h;
+  }
+  return static_cast<uint16_t>(sign | h);
+}
+
+CONST auto
+halfToFloat(uint16_t const h) noexcept -> float
+{
+  uint32_t const sign = static_cast<uint32_t>(h & 0x8000U) << 16U;
+  uint32_t const e = (h >> 10U) & 0x1FU;
+  uint32_t const m = h & 0x3FFU;
+  if (e == 0) {
+    auto const f = static_cast<float>(std::ldexp(static_cast<double>(m), -24));
+    return sign != 0 ? -f : f;
+  }
+  if (e == 31) {
+    return std::bit_cast<float>(sign | 0x7F800000U | (m << 13U));
+  }
+  return std::bit_cast<float>(sign | ((e + 112U) << 23U) | (m << 13U));
+}
+
+//==============================================================================
+// Validation
+//==============================================================================
+// The header and offset tables of a file that is read must describe exactly
+// the layout that writeSegmentFile produces, so that every section, and every
+// ray within a section, is inside the file. Return a description of the first
+// problem found, or nullptr.
+
+PURE auto
+checkLayout(SegmentFileHeader const & h, unsigned char const * const base,
+            int64_t const size) noexcept -> char const *
+{
+  if (h.length_format < static_cast<int32_t>(SegmentLengthFormat::Float32) ||
+      h.length_format > static_cast<int32_t>(SegmentLengthFormat::Quantized16)) {
+    return "invalid length format";
+  }
+  if (h.num_angles < 0 || h.num_rays < 0 || h.num_segments < 0 ||
+      h.num_segments > size) {
+    return "invalid number of angles, rays, or segments";
+  }
+  auto const format = static_cast<SegmentLengthFormat>(h.length_format);
+  if (format == SegmentLengthFormat::Quantized16 &&
+      !(std::isfinite(h.length_scale) && h.length_scale > 0)) {
+    return "invalid length scale";
+  }
+
+  // The offset tables
+  auto const params_size = static_cast<int64_t>(h.num_angles) *
+                           static_cast<int64_t>(sizeof(SegmentFileParams));
+  auto const ray_offsets_size =
+      (static_cast<int64_t>(h.num_angles) + 1) * static_cast<int64_t>(sizeof(int32_t));
+  auto const offsets_size =
+      (static_cast<int64_t>(h.num_rays) + 1) * static_cast<int64_t>(sizeof(int64_t));
+  if (h.params_offset != static_cast<int64_t>(sizeof(SegmentFileHeader)) ||
+      h.ray_offsets_offset != alignTo8(h.params_offset + params_size) ||
+      h.segment_offsets_offset != alignTo8(h.ray_offsets_offset + ray_offsets_size) ||
+      h.fsr_offsets_offset != alignTo8(h.segment_offsets_offset + offsets_size) ||
+      h.fsr_data_offset != alignTo8(h.fsr_offsets_offset + offsets_size) ||
+      h.fsr_data_offset > size) {
+    return "invalid section offsets";
+  }
+  auto const * const ray_offsets =
+      reinterpret_cast<int32_t const *>(base + h.ray_offsets_offset);
+  auto const * const segment_offsets =
+      reinterpret_cast<int64_t const *>(base + h.segment_offsets_offset);
+  auto const * const fsr_offsets =
+      reinterpret_cast<int64_t const *>(base + h.fsr_offsets_offset);
+  if (ray_offsets[0] != 0 || ray_offsets[h.num_angles] != h.num_rays) {
+    return "invalid ray offsets";
+  }
+  for (int32_t ia = 0; ia < h.num_angles; ++ia) {
+    if (ray_offsets[ia + 1] < ray_offsets[ia]) {
+      return "invalid ray offsets";
+    }
+  }
+  if (segment_offsets[0] != 0 || segment_offsets[h.num_rays] != h.num_segments ||
+      fsr_offsets[0] != 0 || fsr_offsets[h.num_rays] > size) {
+    return "invalid segment offsets";
+  }
+  for (int32_t i = 0; i < h.num_rays; ++i) {
+    int64_t const n = segment_offsets[i + 1] - segment_offsets[i];
+    // Each FSR ID takes at least one byte
+    if (n < 0 || n > INT32_MAX || fsr_offsets[i + 1] - fsr_offsets[i] < n) {
+      return "invalid segment offsets";
+    }
+  }
+
+  // The lengths
+  int64_t const length_bytes = format == SegmentLengthFormat::Float32
+                                   ? static_cast<int64_t>(sizeof(float))
+                                   : static_cast<int64_t>(sizeof(uint16_t));
+  if (h.lengths_offset != alignTo8(h.fsr_data_offset + fsr_offsets[h.num_rays]) ||
+      h.file_size != alignTo8(h.lengths_offset + h.num_segments * length_bytes)) {
+    return "invalid section offsets";
+  }
+  return nullptr;
+}
+
+void
+writeSection(std::ofstream & file, void const * data, int64_t const size,
+             int64_t & pos)
+{
+  file.write(static_cast<char const *>(data), static_cast<std::streamsize>(size));
+  pos += size;
+  char constexpr pad[8] = {};
+  int64_t const aligned = alignTo8(pos);
+  file.write(pad, static_cast<std::streamsize>(aligned - pos));
+  pos = aligned;
+}
+
+} // namespace
+
+//==============================================================================
+// writeSegmentFile
+//==============================================================================
+
+void
+writeSegmentFile(String const & filename, ModularRaySegments const & segments,
+                 SegmentLengthFormat const format)
+{
+  LOG_INFO("Writing segment file: ", filename);
+  Int const num_angles = segments.numAngles();
+  Int const num_rays = segments.numRays();
+  Int const num_segments = segments.numSegments();
+  ASSERT(segments.ray_offsets.size() == num_angles + 1);
+  ASSERT(segments.lengths.size() == num_segments);
+
+  // Parameters
+  Vector<SegmentFileParams> params(num_angles);
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    auto const & p = segments.params[ia];
+    auto const box = p.getBox();
+    auto const spacing = p.getSpacing();
+    auto const direction = p.getDirection();
+    auto & out = params[ia];
+    out.box[0] = static_cast<double>(box.minima(0));
+    out.box[1] = static_cast<double>(box.minima(1));
+    out.box[2] = static_cast<double>(box.maxima(0));
+    out.box[3] = static_cast<double>(box.maxima(1));
+    out.spacing[0] = static_cast<double>(spacing[0]);
+    out.spacing[1] = static_cast<double>(spacing[1]);
+    out.direction[0] = static_cast<double>(direction[0]);
+    out.direction[1] = static_cast<double>(direction[1]);
+    out.num_rays[0] = static_cast<int32_t>(p.getNumXRays());
+    out.num_rays[1] = static_cast<int32_t>(p.getNumYRays());
+  }
+
+  // Offsets
+  Vector<int32_t> ray_offsets(num_angles + 1);
+  for (Int ia = 0; ia <= num_angles; ++ia) {
+    ray_offsets[ia] = static_cast<int32_t>(segments.ray_offsets[ia]);
+  }
+  Vector<int64_t> segment_offsets(num_rays + 1);
+  for (Int i = 0; i <= num_rays; ++i) {
+    segment_offsets[i] = static_cast<int64_t>(segments.segment_offsets[i]);
+  }
+
+  // Delta-encoded FSR IDs
+  Vector<int64_t> fsr_offsets(num_rays + 1);
+  Vector<unsigned char> fsr_data;
+  fsr_data.reserve(num_segments);
+  for (Int i = 0; i < num_rays; ++i) {
+    fsr_offsets[i] = static_cast<int64_t>(fsr_data.size());
+    int64_t prev = 0;
+    for (Int j = segments.segment_offsets[i]; j < segments.segment_offsets[i + 1]; ++j) {
+      auto const id = static_cast<int64_t>(segments.fsr_ids[j]);
+      writeVarint(id - prev, fsr_data);
+      prev = id;
+    }
+  }
+  fsr_offsets[num_rays] = static_cast<int64_t>(fsr_data.size());
+
+  // Lengths
+  double length_scale = 0;
+  Vector<float> lengths32;
+  Vector<uint16_t> lengths16;
+  switch (format) {
+  case SegmentLengthFormat::Float32:
+    lengths32.resize(num_segments);
+    for (Int j = 0; j < num_segments; ++j) {
+      lengths32[j] = static_cast<float>(segments.lengths[j]);
+    }
+    break;
+  case SegmentLengthFormat::Float16:
+    lengths16.resize(num_segments);
+    for (Int j = 0; j < num_segments; ++j) {
+      lengths16[j] = floatToHalf(static_cast<float>(segments.lengths[j]));
+    }
+    break;
+  case SegmentLengthFormat::Quantized16: {
+    double max_length = 0;
+    for (auto const l : segments.lengths) {
+      max_length = um2::max(max_length, static_cast<double>(l));
+    }
+    length_scale = max_length > 0 ? max_length / 65535.0 : 1.0;
+    lengths16.resize(num_segments);
+    for (Int j = 0; j < num_segments; ++j) {
+      auto const q = std::lround(static_cast<double>(segments.lengths[j]) / length_scale);
+      lengths16[j] = static_cast<uint16_t>(q);
+    }
+    break;
+  }
+  default:
+    logger::error("Invalid segment length format");
+    return;
+  }
+
+  // Header
+  SegmentFileHeader header = {};
+  std::memcpy(header.magic, segment_file_magic, sizeof(header.magic));
+  header.version = segment_file_version;
+  header.length_format = static_cast<int32_t>(format);
+  header.num_angles = static_cast<int32_t>(num_angles);
+  header.num_rays = static_cast<int32_t>(num_rays);
+  header.num_segments = static_cast<int64_t>(num_segments);
+  header.length_scale = length_scale;
+  auto const params_size =
+      static_cast<int64_t>(num_angles) * static_cast<int64_t>(sizeof(SegmentFileParams));
+  auto const ray_offsets_size =
+      static_cast<int64_t>(num_angles + 1) * static_cast<int64_t>(sizeof(int32_t));
+  auto const offsets_size =
+      static_cast<int64_t>(num_rays + 1) * static_cast<int64_t>(sizeof(int64_t));
+  auto const fsr_data_size = static_cast<int64_t>(fsr_data.size());
+  int64_t const lengths_size =
+      format == SegmentLengthFormat::Float32
+          ? static_cast<int64_t>(num_segments) * static_cast<int64_t>(sizeof(float))
+          : static_cast<int64_t>(num_segments) * static_cast<int64_t>(sizeof(uint16_t));
+  header.params_offset = static_cast<int64_t>(sizeof(SegmentFileHeader));
+  header.ray_offsets_offset = alignTo8(header.params_offset + params_size);
+  header.segment_offsets_offset = alignTo8(header.ray_offsets_offset + ray_offsets_size);
+  header.fsr_offsets_offset = alignTo8(header.segment_offsets_offset + offsets_size);
+  header.fsr_data_offset = alignTo8(header.fsr_offsets_offset + offsets_size);
+  header.lengths_offset = alignTo8(header.fsr_data_offset + fsr_data_size);
+  header.file_size = alignTo8(header.lengths_offset + lengths_size);
+
+  std::ofstream file(std::string(filename.data()), std::ios::binary);
+  if (!file.is_open()) {
+    logger::error("Could not open file ", filename);
+    return;
+  }
+  int64_t pos = 0;
+  writeSection(file, &header, sizeof(SegmentFileHeader), pos);
+  writeSection(file, params.data(), params_size, pos);
+  writeSection(file, ray_offsets.data(), ray_offsets_size, pos);
+  writeSection(file, segment_offsets.data(), offsets_size, pos);
+  writeSection(file, fsr_offsets.data(), offsets_size, pos);
+  writeSection(file, fsr_data.data(), fsr_data_size, pos);
+  if (format == SegmentLengthFormat::Float32) {
+    writeSection(file, lengths32.data(), lengths_size, pos);
+  } else {
+    writeSection(file, lengths16.data(), lengths_size, pos);
+  }
+  ASSERT(pos == header.file_size);
+  file.close();
+  // A failed write or close, e.g. on a full disk, leaves a truncated file.
+  if (!file.good()) {
+    logger::error("Could not write file ", filename);
+    return;
+  }
+  LOG_INFO("Wrote ", num_segments, " segments in ", pos, " bytes");
+}
+
+//==============================================================================
+// SegmentFile
+//==============================================================================
+
+SegmentFile::SegmentFile(String const & filename) { open(filename); }
+
+SegmentFile::SegmentFile(SegmentFile && other) noexcept { *this = um2::move(other); }
+
+auto
+SegmentFile::operator=(SegmentFile && other) noexcept -> SegmentFile &
+{
+  if (this != &other) {
+    close();
+    _map = other._map;
+    _map_size = other._map_size;
+    _format = other._format;
+    _num_angles = other._num_angles;
+    _num_rays = other._num_rays;
+    _num_segments = other._num_segments;
+    _length_scale = other._length_scale;
+    _params = other._params;
+    _ray_offsets = other._ray_offsets;
+    _segment_offsets = other._segment_offsets;
+    _fsr_offsets = other._fsr_offsets;
+    _fsr_data = other._fsr_data;
+    _lengths = other._lengths;
+    other._map = nullptr;
+    other.close();
+  }
+  return *this;
+}
+
+SegmentFile::~SegmentFile() noexcept { close(); }
+
+void
+SegmentFile::close() noexcept
+{
+  if (_map != nullptr) {
+    munmap(_map, _map_size);
+  }
+  _map = nullptr;
+  _map_size = 0;
+  _format = SegmentLengthFormat::Float32;
+  _num_angles = 0;
+  _num_rays = 0;
+  _num_segments = 0;
+  _length_scale = 0;
+  _params = nullptr;
+  _ray_offsets = nullptr;
+  _segment_offsets = nullptr;
+  _fsr_offsets = nullptr;
+  _fsr_data = nullptr;
+  _lengths = nullptr;
+}
+
+void
+SegmentFile::open(String const & filename)
+{
+  close();
+  LOG_INFO("Reading segment file: ", filename);
+  int const fd = ::open(filename.data(), O_RDONLY);
+  if (fd < 0) {
+    logger::error("Could not open file ", filename);
+    return;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 ||
+      st.st_size < static_cast<off_t>(sizeof(SegmentFileHeader))) {
+    ::close(fd);
+    logger::error("Invalid segment file ", filename);
+    return;
+  }
+  auto const size = static_cast<size_t>(st.st_size);
+  void * map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    logger::error("Could not memory-map file ", filename);
+    return;
+  }
+
+  auto const * const base = static_cast<unsigned char const *>(map);
+  SegmentFileHeader header = {};
+  std::memcpy(&header, base, sizeof(SegmentFileHeader));
+  if (std::memcmp(header.magic, segment_file_magic, sizeof(header.magic)) != 0) {
+    munmap(map, size);
+    logger::error("Not a segment file: ", filename);
+    return;
+  }
+  if (header.version != segment_file_version) {
+    munmap(map, size);
+    logger::error("Unsupported segment file version ", header.version);
+    return;
+  }
+  if (header.file_size != static_cast<int64_t>(size)) {
+    munmap(map, size);
+    logger::error("Truncated segment file ", filename);
+    return;
+  }
+  char const * const problem = checkLayout(header, base, static_cast<int64_t>(size));
+  if (problem != nullptr) {
+    munmap(map, size);
+    logger::error("Corrupt segment file ", filename, ": ", problem);
+    return;
+  }
+
+  _map = map;
+  _map_size = size;
+  _format = static_cast<SegmentLengthFormat>(header.length_format);
+  _num_angles = static_cast<Int>(header.num_angles);
+  _num_rays = static_cast<Int>(header.num_rays);
+  _num_segments = header.num_segments;
+  _length_scale = header.length_scale;
+  // Each section is 8-byte aligned and the map is page aligned.
+  _params = base + header.params_offset;
+  _ray_offsets = reinterpret_cast<int32_t const *>(base + header.ray_offsets_offset);
+  _segment_offsets =
+      reinterpret_cast<int64_t const *>(base + header.segment_offsets_offset);
+  _fsr_offsets = reinterpret_cast<int64_t const *>(base + header.fsr_offsets_offset);
+  _fsr_data = base + header.fsr_data_offset;
+  _lengths = base + header.lengths_offset;
+}
+
+PURE auto
+SegmentFile::getParams(Int const ia) const noexcept -> ModularRayParams<Float>
+{
+  ASSERT(0 <= ia);
+  ASSERT(ia < _num_angles);
+  SegmentFileParams p = {};
+  std::memcpy(&p, _params + static_cast<size_t>(ia) * sizeof(SegmentFileParams),
+              sizeof(SegmentFileParams));
+  AxisAlignedBox2<Float> const box(
+      Point2<Float>(static_cast<Float>(p.box[0]), static_cast<Float>(p.box[1])),
+      Point2<Float>(static_cast<Float>(p.box[2]), static_cast<Float>(p.box[3])));
+  Vec2I const num_rays(static_cast<Int>(p.num_rays[0]), static_cast<Int>(p.num_rays[1]));
+  Vec2<Float> const spacing(static_cast<Float>(p.spacing[0]),
+                            static_cast<Float>(p.spacing[1]));
+  Vec2<Float> const direction(static_cast<Float>(p.direction[0]),
+                              static_cast<Float>(p.direction[1]));
+  return {box, num_rays, spacing, direction};
+}
+
+auto
+SegmentFile::getRay(Int const iray, Int * fsr_ids, Float * lengths) const noexcept
+    -> Int
+{
+  ASSERT(0 <= iray);
+  ASSERT(iray < _num_rays);
+  int64_t const first = _segment_offsets[iray];
+  auto const n = static_cast<Int>(_segment_offsets[iray + 1] - first);
+
+  // FSR IDs
+  unsigned char const * p = _fsr_data + _fsr_offsets[iray];
+  unsigned char const * const end = _fsr_data + _fsr_offsets[iray + 1];
+  int64_t id = 0;
+  for (Int i = 0; i < n; ++i) {
+    int64_t delta = 0;
+    if (!readVarint(p, end, delta)) {
+      logger::error("Corrupt FSR IDs of ray ", iray, " in segment file");
+      return 0;
+    }
+    id += delta;
+    fsr_ids[i] = static_cast<Int>(id);
+  }
+  if (p != end) {
+    logger::error("Corrupt FSR IDs of ray ", iray, " in segment file");
+    return 0;
+  }
+
+  // Lengths
+  switch (_format) {
+  case SegmentLengthFormat::Float32: {
+    auto const * const l = static_cast<float const *>(_lengths) + first;
+    for (Int i = 0; i < n; ++i) {
+      lengths[i] = static_cast<Float>(l[i]);
+    }
+    break;
+  }
+  case SegmentLengthFormat::Float16: {
+    auto const * const l = static_cast<uint16_t const *>(_lengths) + first;
+    for (Int i = 0; i < n; ++i) {
+      lengths[i] = static_cast<Float>(halfToFloat(l[i]));
+    }
+    break;
+  }
+  case SegmentLengthFormat::Quantized16: {
+    auto const * const l = static_cast<uint16_t const *>(_lengths) + first;
+    for (Int i = 0; i < n; ++i) {
+      lengths[i] = static_cast<Float>(static_cast<double>(l[i]) * _length_scale);
+    }
+    break;
+  }
+  default:
+    // Unreachable, since open() checks the format
+    logger::error("Invalid segment length format");
+    return 0;
+  }
+  return n;
+}
+
+} // namespace um2::mpact
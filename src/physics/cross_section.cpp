@@ -5,6 +5,7 @@
 #include <um2/stdlib/vector.hpp>
 
 #include <um2/common/logger.hpp>
+#include <um2/math/matrix.hpp>
 #include <um2/math/stats.hpp>
 
 namespace um2
@@ -22,24 +23,9 @@ XSec::validate() const noexcept
     LOG_ERROR("Cross section has a non-positive number of groups");
   }
 
-  if (_a.size() != _num_groups) {
-    LOG_ERROR("Cross section has an incorrect number of absorption values");
-  }
-
-  if (_f.size() != _num_groups) {
-    LOG_ERROR("Cross section has an incorrect number of fission values");
-  }
-
-  if (_nuf.size() != _num_groups) {
-    LOG_ERROR("Cross section has an incorrect number of nu*fission values");
-  }
-
-  if (_tr.size() != _num_groups) {
-    LOG_ERROR("Cross section has an incorrect number of transport values");
-  }
-
-  if (_s.size() != _num_groups) {
-    LOG_ERROR("Cross section has an incorrect number of scattering values");
+  if (_num_blocks * block_size < _num_groups ||
+      _data.size() != num_reactions * _num_blocks) {
+    LOG_ERROR("Cross section has an incorrect number of values");
   }
 
   if (_ss.rows() != _num_groups || _ss.cols() != _num_groups) {
@@ -48,7 +34,7 @@ XSec::validate() const noexcept
 
   if (isMacro()) {
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const a = _a[i];
+      auto const a = this->a()[i];
       if (a < 0.0) {
         LOG_WARN("Cross section has a negative absorption cross section in group ", i,
                  " (", a, ")");
@@ -56,7 +42,7 @@ XSec::validate() const noexcept
     }
 
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const f = _f[i];
+      auto const f = this->f()[i];
       if (f < 0.0) {
         LOG_WARN("Cross section has a negative fission cross section in group ", i, " (",
                  f, ")");
@@ -68,7 +54,7 @@ XSec::validate() const noexcept
     }
 
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const nuf = _nuf[i];
+      auto const nuf = this->nuf()[i];
       if (nuf < 0.0) {
         LOG_WARN("Cross section has a negative nu*fission cross section in group ", i,
                  " (", nuf, ")");
@@ -80,7 +66,7 @@ XSec::validate() const noexcept
     }
 
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const tr = _tr[i];
+      auto const tr = this->tr()[i];
       if (tr < 0.0) {
         LOG_WARN("Cross section has a negative transport cross section in group ", i,
                  " (", tr, ")");
@@ -88,21 +74,25 @@ XSec::validate() const noexcept
     }
 
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const s = _s[i];
+      auto const s = this->s()[i];
       if (s < 0.0) {
         LOG_WARN("Cross section has a negative scattering cross section in group ", i,
                  " (", s, ")");
       }
     }
-    for (Int i = 0; i < _num_groups * _num_groups; ++i) {
-      if (_ss(i) < 0.0) {
-        LOG_WARN("Cross section has a negative scattering matrix value at index ", i,
-                 " (", _ss(i), ")");
+    for (Int i = 0; i < _num_groups; ++i) {
+      Float const * const row = _ss.rowData(i);
+      for (Int j = _ss.rowFirst(i); j < _ss.rowLast(i); ++j) {
+        auto const ss = row[j - _ss.rowFirst(i)];
+        if (ss < 0.0) {
+          LOG_WARN("Cross section has a negative scattering matrix value at (", i, ", ",
+                   j, ") (", ss, ")");
+        }
       }
     }
   } else {
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const f = _f[i];
+      auto const f = this->f()[i];
       if (f > 0.0 && !isFissile()) {
         LOG_ERROR("Cross section has a positive fission cross section in group ", i,
                   " but is not fissile");
@@ -110,7 +100,7 @@ XSec::validate() const noexcept
     }
 
     for (Int i = 0; i < _num_groups; ++i) {
-      auto const nuf = _nuf[i];
+      auto const nuf = this->nuf()[i];
       if (nuf > 0.0 && !isFissile()) {
         LOG_ERROR("Cross section has a positive nu*fission cross section in group ", i,
                   " but is not fissile");
@@ -126,20 +116,93 @@ XSec::collapseTo1GroupAvg() const noexcept -> XSec
   result.isMacro() = isMacro();
   result.isFissile() = isFissile();
   ASSERT(_num_groups > 0);
-  result.a()[0] = um2::mean(_a.cbegin(), _a.cend());
-  result.f()[0] = um2::mean(_f.cbegin(), _f.cend());
-  result.nuf()[0] = um2::mean(_nuf.cbegin(), _nuf.cend());
-  result.tr()[0] = um2::mean(_tr.cbegin(), _tr.cend());
-  result.s()[0] = um2::mean(_s.cbegin(), _s.cend());
-  result.ss()(0) = _num_groups * um2::mean(_ss.begin(), _ss.end());
+  result.a()[0] = um2::mean(a().cbegin(), a().cend());
+  result.f()[0] = um2::mean(f().cbegin(), f().cend());
+  result.nuf()[0] = um2::mean(nuf().cbegin(), nuf().cend());
+  result.tr()[0] = um2::mean(tr().cbegin(), tr().cend());
+  result.s()[0] = um2::mean(s().cbegin(), s().cend());
+  // The mean of all G^2 entries, most of which are zero and not stored
+  result.ss().set(0, 0, _ss.sum() / static_cast<Float>(_num_groups));
 #if UM2_ENABLE_ASSERTS
   auto constexpr eps = 1.0e-6;
-  ASSERT_NEAR(result.s()[0], result.ss()(0), eps);
+  ASSERT_NEAR(result.s()[0], result.ss()(0, 0), eps);
 #endif
   result.validate();
   return result;
 }
 
+void
+XSec::axpy(Float const a, XSec const & x) noexcept
+{
+  ASSERT(x._num_groups == _num_groups);
+  Block const * RESTRICT const xd = x._data.data();
+  Block * RESTRICT const yd = _data.data();
+  Int const n = _data.size();
+  for (Int i = 0; i < n; ++i) {
+    yd[i] += a * xd[i];
+  }
+  _ss.addScaled(a, x._ss);
+}
+
+auto
+XSec::operator*=(Float const scalar) noexcept -> XSec &
+{
+  for (auto & block : _data) {
+    block *= scalar;
+  }
+  _ss *= scalar;
+  return *this;
+}
+
+void
+XSec::addLerp(Float const a, Float const d, XSec const & x0, XSec const & x1) noexcept
+{
+  ASSERT(x0._num_groups == _num_groups);
+  ASSERT(x1._num_groups == _num_groups);
+  Block const * RESTRICT const x0d = x0._data.data();
+  Block const * RESTRICT const x1d = x1._data.data();
+  Block * RESTRICT const yd = _data.data();
+  Int const n = _data.size();
+  for (Int i = 0; i < n; ++i) {
+    yd[i] += a * (x0d[i] + d * (x1d[i] - x0d[i]));
+  }
+  _ss.addInterp(a, d, x0._ss, x1._ss);
+}
+
+void
+XSec::scatteringSource(Float const * phi, Float * q) const noexcept
+{
+  _ss.multiply(phi, q);
+}
+
+//==============================================================================
+// Free functions
+//==============================================================================
+
+auto
+weightedSum(Int const n, XSec const * const * xsecs, Float const * weights) noexcept
+    -> XSec
+{
+  ASSERT(n > 0);
+  Int const num_groups = xsecs[0]->numGroups();
+  XSec result(num_groups);
+  // Each block of the result is accumulated in a register and written once,
+  // instead of reading and writing the whole result once per input.
+  Int const num_blocks = result._data.size();
+  for (Int i = 0; i < num_blocks; ++i) {
+    auto acc = XSec::Block::zero();
+    for (Int k = 0; k < n; ++k) {
+      ASSERT(xsecs[k]->numGroups() == num_groups);
+      acc += weights[k] * xsecs[k]->_data[i];
+    }
+    result._data[i] = acc;
+  }
+  for (Int k = 0; k < n; ++k) {
+    result.ss().addScaled(weights[k], xsecs[k]->ss());
+  }
+  return result;
+}
+
 PURE [[nodiscard]] auto
 // NOLINTNEXTLINE(*cognitive*)
 getC5G7XSecs() noexcept -> Vector<XSec>
@@ -175,8 +238,9 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   //
   // Note: we store scattering matrices ss(to group, from group) in colume major order.
   // Hence, the 1D memory layout is equivalent to the 2D memory row-major layout in the
-  // table above.
+  // table above. The dense matrices are only used to build the banded ones.
   Int constexpr num_groups = 7;
+  Matrix<Float> ss(num_groups, num_groups);
   XSec uo2(num_groups);
   uo2.isMacro() = true;
   uo2.isFissile() = true;
@@ -193,7 +257,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
               3.11801e-01, 3.95168e-01, 5.64406e-01};
   // NOLINTEND(*use-std-numbers)
   // clang-format off
-  uo2.ss().asVector() = {
+  ss.asVector() = {
     1.27537e-01, 4.23780e-02, 9.43740e-06, 5.51630e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 3.24456e-01, 1.63140e-03, 3.14270e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 0.00000e+00, 4.50940e-01, 2.67920e-03, 0.00000e+00, 0.00000e+00, 0.00000e+00,
@@ -202,6 +266,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 1.29680e-03, 2.65802e-01, 1.68090e-02,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 8.54580e-03, 2.73080e-01};
   // clang-format on
+  uo2.ss() = BandedMatrix<Float>(ss);
   // Sum each column to get the total scattering cross section
   for (Int i = 0; i < num_groups; ++i) {
     // uo2.s()[i] = 0.0; should already be zero initialized
@@ -254,7 +319,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   mox43.tr() = {1.78731e-01, 3.30849e-01, 4.83772e-01, 5.66922e-01,
                 4.26227e-01, 6.78997e-01, 6.82852e-01};
   // clang-format off
-  mox43.ss().asVector() = {
+  ss.asVector() = {
     1.28876e-01, 4.14130e-02, 8.22900e-06, 5.04050e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 3.25452e-01, 1.63950e-03, 1.59820e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 0.00000e+00, 4.53188e-01, 2.61420e-03, 0.00000e+00, 0.00000e+00, 0.00000e+00,
@@ -263,6 +328,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 2.00510e-03, 2.52962e-01, 1.48500e-02,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 8.49480e-03, 2.65007e-01};
   // clang-format on
+  mox43.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       mox43.s()[i] += mox43.ss()(j, i);
@@ -313,7 +379,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   mox70.tr() = {1.81323e-01, 3.34368e-01, 4.93785e-01, 5.91216e-01,
                 4.74198e-01, 8.33601e-01, 8.53603e-01};
   // clang-format off
-  mox70.ss().asVector() = {
+  ss.asVector() = {
     1.30457e-01, 4.17920e-02, 8.51050e-06, 5.13290e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 3.28428e-01, 1.64360e-03, 2.20170e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 0.00000e+00, 4.58371e-01, 2.53310e-03, 0.00000e+00, 0.00000e+00, 0.00000e+00,
@@ -322,6 +388,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 2.27600e-03, 2.49751e-01, 1.31140e-02,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 8.86450e-03, 2.59529e-01};
   // clang-format on
+  mox70.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       mox70.s()[i] += mox70.ss()(j, i);
@@ -371,7 +438,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   mox87.tr() = {1.83045e-01, 3.36705e-01, 5.00507e-01, 6.06174e-01,
                 5.02754e-01, 9.21028e-01, 9.55231e-01};
   // clang-format off
-  mox87.ss().asVector() = {
+  ss.asVector() = {
     1.31504e-01, 4.20460e-02, 8.69720e-06, 5.19380e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 3.30403e-01, 1.64630e-03, 2.60060e-09, 0.00000e+00, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 0.00000e+00, 4.61792e-01, 2.47490e-03, 0.00000e+00, 0.00000e+00, 0.00000e+00,
@@ -380,6 +447,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 2.39160e-03, 2.47614e-01, 1.23220e-02,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 8.96810e-03, 2.56093e-01};
   // clang-format on
+  mox87.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       mox87.s()[i] += mox87.ss()(j, i);
@@ -430,7 +498,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   fc.tr() = {1.26032e-01, 2.93160e-01, 2.84250e-01, 2.81020e-01,
              3.34460e-01, 5.65640e-01, 1.17214e+00};
   // clang-format off
-  fc.ss().asVector() = {
+  ss.asVector() = {
     6.61659e-02, 5.90700e-02, 2.83340e-04, 1.46220e-06, 2.06420e-08, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 2.40377e-01, 5.24350e-02, 2.49900e-04, 1.92390e-05, 2.98750e-06, 4.21400e-07,
     0.00000e+00, 0.00000e+00, 1.83425e-01, 9.22880e-02, 6.93650e-03, 1.07900e-03, 2.05430e-04,
@@ -439,6 +507,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 9.17420e-04, 3.16774e-01, 2.38760e-01,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 4.97930e-02, 1.09910e+00};
   // clang-format on
+  fc.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       fc.s()[i] += fc.ss()(j, i);
@@ -476,7 +545,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   gt.tr() = {1.26032e-01, 2.93160e-01, 2.84240e-01, 2.80960e-01,
              3.34440e-01, 5.65640e-01, 1.17215e+00};
   // clang-format off
-  gt.ss().asVector() = {
+  ss.asVector() = {
     6.61659e-02, 5.90700e-02, 2.83340e-04, 1.46220e-06, 2.06420e-08, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 2.40377e-01, 5.24350e-02, 2.49900e-04, 1.92390e-05, 2.98750e-06, 4.21400e-07,
     0.00000e+00, 0.00000e+00, 1.83297e-01, 9.23970e-02, 6.94460e-03, 1.08030e-03, 2.05670e-04,
@@ -485,6 +554,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 9.17260e-04, 3.16765e-01, 2.38770e-01,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 4.97920e-02, 1.09912e+00};
   // clang-format on
+  gt.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       gt.s()[i] += gt.ss()(j, i);
@@ -522,7 +592,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
   mo.tr() = {1.59206e-01, 4.12970e-01, 5.90310e-01, 5.84350e-01,
              7.18000e-01, 1.25445e+00, 2.65038e+00};
   // clang-format off
-  mo.ss().asVector() = {
+  ss.asVector() = {
     4.44777e-02, 1.13400e-01, 7.23470e-04, 3.74990e-06, 5.31840e-08, 0.00000e+00, 0.00000e+00,
     0.00000e+00, 2.82334e-01, 1.29940e-01, 6.23400e-04, 4.80020e-05, 7.44860e-06, 1.04550e-06,
     0.00000e+00, 0.00000e+00, 3.45256e-01, 2.24570e-01, 1.69990e-02, 2.64430e-03, 5.03440e-04,
@@ -531,6 +601,7 @@ getC5G7XSecs() noexcept -> Vector<XSec>
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 2.21570e-03, 6.99913e-01, 5.37320e-01,
     0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 0.00000e+00, 1.32440e-01, 2.48070e+00};
   // clang-format on
+  mo.ss() = BandedMatrix<Float>(ss);
   for (Int i = 0; i < num_groups; ++i) {
     for (Int j = 0; j < num_groups; ++j) {
       mo.s()[i] += mo.ss()(j, i);
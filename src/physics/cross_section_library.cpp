@@ -1,4 +1,5 @@
 #include <um2/common/logger.hpp>
+#include <um2/common/settings.hpp>
 #include <um2/common/strto.hpp>
 #include <um2/config.hpp>
 #include <um2/physics/cross_section.hpp>
@@ -7,12 +8,21 @@
 #include <um2/stdlib/assert.hpp>
 #include <um2/stdlib/string.hpp>
 #include <um2/stdlib/string_view.hpp>
+#include <um2/stdlib/utility/move.hpp>
 #include <um2/stdlib/vector.hpp>
 
 #include <cctype>
-#include <cstdint>
+#include <cstdint> // int32_t, int64_t, uint64_t
+#include <cstdio>  // rename, remove
+#include <cstdlib> // mkstemp
+#include <cstring> // memcpy, memcmp
 #include <fstream>
 
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // stat, fstat, fchmod
+#include <unistd.h>   // close, write
+
 namespace um2
 {
 
@@ -24,9 +34,183 @@ isSpace(char c) -> bool
   return std::isspace(static_cast<unsigned char>(c)) != 0;
 }
 
+// Read the cross section data of a nuclide, starting from the XSD+ line. The
+// ZAID and temperatures of the nuclide must already be set.
+void
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+readNuclideXS(std::ifstream & file, Int const num_groups, Nuclide & nuclide)
+{
+  uint64_t const max_line_length = 1024;
+  char line[max_line_length];
+  StringView line_view;
+  StringView token;
+  char * end = nullptr;
+  [[maybe_unused]] Int const zaid = nuclide.zaid();
+  Int const num_temps = nuclide.temperatures().size();
+  nuclide.xs().resize(num_temps);
+  for (Int itemp = 0; itemp < num_temps; ++itemp) {
+    auto & xsec = nuclide.xs()[itemp];
+    xsec = XSec(num_groups);
+  }
+
+  // Read the cross section data
+  // 0. group index
+  // 1. temperature index
+  // 2. absorption
+  // 3. fission
+  // 4. nu-fission
+  // 5. transport
+  // 6. total scattering
+  // 7+. scattering matrix
+  file.getline(line, max_line_length);
+  line_view = StringView(line);
+  line_view.removeLeadingSpaces();
+  ASSERT(line_view.starts_with("XSD+"));
+  for (Int ig = 0; ig < num_groups; ++ig) {
+    for (Int itemp = 0; itemp < num_temps; ++itemp) {
+
+      file.getline(line, max_line_length);
+      line_view = StringView(line);
+      line_view.removeLeadingSpaces();
+
+      // Group index
+      token = line_view.getTokenAndShrink();
+#if UM2_ENABLE_ASSERTS
+      Int const group_index = strto<Int>(token.data(), &end);
+      ASSERT(end != nullptr);
+      end = nullptr;
+      ASSERT(group_index == ig + 1);
+#endif
+
+      // Temperature index
+      token = line_view.getTokenAndShrink();
+#if UM2_ENABLE_ASSERTS
+      Int const temp_index = strto<Int>(token.data(), &end);
+      ASSERT(end != nullptr);
+      end = nullptr;
+      ASSERT(temp_index == itemp + 1);
+#endif
+
+      auto & xsec = nuclide.xs()[itemp];
+
+      // Absorption
+      token = line_view.getTokenAndShrink();
+      Float const absorption = strto<Float>(token.data(), &end);
+      ASSERT(end != nullptr);
+      end = nullptr;
+      if (absorption < 0) {
+        LOG_DEBUG("Nuclide with ZAID ", zaid,
+                  " has negative absorption cross section at group ", ig,
+                  " and temperature ", itemp);
+      }
+      xsec.a()[ig] = absorption;
+
+      // If this token is empty, only absorption is given
+      token = line_view.getTokenAndShrink();
+      bool const absorption_only = token.empty();
+      if (!absorption_only) {
+
+        // Fission
+        Float const fission = strto<Float>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        if (fission > 0) {
+          nuclide.isFissile() = true;
+          xsec.isFissile() = true;
+        }
+        if (fission < 0) {
+          LOG_DEBUG("Nuclide with ZAID ", zaid,
+                    " has negative fission cross section at group ", ig,
+                    " and temperature ", itemp);
+        }
+        xsec.f()[ig] = fission;
+
+        // nu-fission
+        token = line_view.getTokenAndShrink();
+        Float const nu_fission = strto<Float>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        if (nu_fission < 0) {
+          LOG_DEBUG("Nuclide with ZAID ", zaid,
+                    " has negative nu-fission cross section at group ", ig,
+                    " and temperature ", itemp);
+        }
+        xsec.nuf()[ig] = nu_fission;
+
+        // Transport
+        token = line_view.getTokenAndShrink();
+        Float const transport = strto<Float>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        if (transport < 0) {
+          LOG_DEBUG("Nuclide with ZAID ", zaid,
+                    " has negative transport cross section at group ", ig,
+                    " and temperature ", itemp);
+        }
+        xsec.tr()[ig] = transport;
+
+        // Total scattering
+        token = line_view.getTokenAndShrink();
+        Float const total_scatter = strto<Float>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        if (total_scatter < 0) {
+          LOG_DEBUG("Nuclide with ZAID ", zaid,
+                    " has negative P0 scattering cross section at group ", ig,
+                    " and temperature ", itemp);
+        }
+        xsec.s()[ig] = total_scatter;
+
+        // Scattering matrix
+        // Minimum column index
+        token = line_view.getTokenAndShrink();
+        Int const min_col = strto<Int>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        ASSERT(min_col >= 1); // MPACT is 1-based
+        Int const min_col0 = min_col - 1;
+
+        // Maximum column index
+        token = line_view.getTokenAndShrink();
+        Int const max_col = strto<Int>(token.data(), &end);
+        ASSERT(end != nullptr);
+        end = nullptr;
+        ASSERT(max_col >= min_col);
+
+        // Number of columns
+        Int const num_cols = max_col - min_col + 1;
+
+        // Read the scattering matrix elements. The rows are read in order and
+        // later rows are still empty, so widening the band is cheap.
+        xsec.ss().widenRow(ig, min_col0, min_col0 + num_cols);
+        Float * const ss_row =
+            xsec.ss().rowData(ig) + (min_col0 - xsec.ss().rowFirst(ig));
+        for (Int icol = 0; icol < num_cols; ++icol) {
+          token = line_view.getTokenAndShrink();
+          Float const value = strto<Float>(token.data(), &end);
+          ASSERT(end != nullptr);
+          end = nullptr;
+          if (value < 0) {
+            LOG_DEBUG("Nuclide with ZAID ", zaid,
+                      " has negative scattering matrix element at group ", ig,
+                      " and temperature ", itemp);
+          }
+          ss_row[icol] = value;
+        }
+      } // if (!absorption_only)
+    } // for (Int itemp = 0; itemp < num_temps; ++itemp)
+  } // for (Int ig = 0; ig < num_groups; ++ig)
+
+  nuclide.validate();
+}
+
+// Read the library. If xs_offsets is not null, only read the ZAID, mass, and
+// temperatures of each nuclide, and store the offset of the cross section data
+// of each nuclide in the file in xs_offsets, to be read by readNuclideXS.
 void
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-readMPACTLibrary(String const & filename, XSLibrary & lib)
+readMPACTLibrary(String const & filename, XSLibrary & lib,
+                 Vector<int64_t> * const xs_offsets = nullptr)
 {
   LOG_INFO("Reading MPACT cross section library: ", filename);
 
@@ -258,11 +442,6 @@ readMPACTLibrary(String const & filename, XSLibrary & lib)
     end = nullptr;
     ASSERT(num_temps > 0);
     nuclide.temperatures().resize(num_temps);
-    nuclide.xs().resize(num_temps);
-    for (Int itemp = 0; itemp < num_temps; ++itemp) {
-      auto & xsec = nuclide.xs()[itemp];
-      xsec = XSec(num_groups);
-    }
 
     // Read the temperature data
     file.getline(line, max_line_length);
@@ -284,151 +463,12 @@ readMPACTLibrary(String const & filename, XSLibrary & lib)
       nuclide.temperatures()[itemp] = temp;
     }
 
-    // Read the cross section data
-    // 0. group index
-    // 1. temperature index
-    // 2. absorption
-    // 3. fission
-    // 4. nu-fission
-    // 5. transport
-    // 6. total scattering
-    // 7+. scattering matrix
-    file.getline(line, max_line_length);
-    line_view = StringView(line);
-    line_view.removeLeadingSpaces();
-    ASSERT(line_view.starts_with("XSD+"));
-    for (Int ig = 0; ig < num_groups; ++ig) {
-      for (Int itemp = 0; itemp < num_temps; ++itemp) {
-
-        file.getline(line, max_line_length);
-        line_view = StringView(line);
-        line_view.removeLeadingSpaces();
-
-        // Group index
-        token = line_view.getTokenAndShrink();
-#if UM2_ENABLE_ASSERTS
-        Int const group_index = strto<Int>(token.data(), &end);
-        ASSERT(end != nullptr);
-        end = nullptr;
-        ASSERT(group_index == ig + 1);
-#endif
-
-        // Temperature index
-        token = line_view.getTokenAndShrink();
-#if UM2_ENABLE_ASSERTS
-        Int const temp_index = strto<Int>(token.data(), &end);
-        ASSERT(end != nullptr);
-        end = nullptr;
-        ASSERT(temp_index == itemp + 1);
-#endif
-
-        auto & xsec = nuclide.xs()[itemp];
-
-        // Absorption
-        token = line_view.getTokenAndShrink();
-        Float const absorption = strto<Float>(token.data(), &end);
-        ASSERT(end != nullptr);
-        end = nullptr;
-        if (absorption < 0) {
-          LOG_DEBUG("Nuclide with ZAID ", zaid,
-                    " has negative absorption cross section at group ", ig,
-                    " and temperature ", itemp);
-        }
-        xsec.a()[ig] = absorption;
-
-        // If this token is empty, only absorption is given
-        token = line_view.getTokenAndShrink();
-        bool const absorption_only = token.empty();
-        if (!absorption_only) {
-
-          // Fission
-          Float const fission = strto<Float>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          if (fission > 0) {
-            nuclide.isFissile() = true;
-            xsec.isFissile() = true;
-          }
-          if (fission < 0) {
-            LOG_DEBUG("Nuclide with ZAID ", zaid,
-                      " has negative fission cross section at group ", ig,
-                      " and temperature ", itemp);
-          }
-          xsec.f()[ig] = fission;
-
-          // nu-fission
-          token = line_view.getTokenAndShrink();
-          Float const nu_fission = strto<Float>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          if (nu_fission < 0) {
-            LOG_DEBUG("Nuclide with ZAID ", zaid,
-                      " has negative nu-fission cross section at group ", ig,
-                      " and temperature ", itemp);
-          }
-          xsec.nuf()[ig] = nu_fission;
-
-          // Transport
-          token = line_view.getTokenAndShrink();
-          Float const transport = strto<Float>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          if (transport < 0) {
-            LOG_DEBUG("Nuclide with ZAID ", zaid,
-                      " has negative transport cross section at group ", ig,
-                      " and temperature ", itemp);
-          }
-          xsec.tr()[ig] = transport;
-
-          // Total scattering
-          token = line_view.getTokenAndShrink();
-          Float const total_scatter = strto<Float>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          if (total_scatter < 0) {
-            LOG_DEBUG("Nuclide with ZAID ", zaid,
-                      " has negative P0 scattering cross section at group ", ig,
-                      " and temperature ", itemp);
-          }
-          xsec.s()[ig] = total_scatter;
-
-          // Scattering matrix
-          // Minimum column index
-          token = line_view.getTokenAndShrink();
-          Int const min_col = strto<Int>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          ASSERT(min_col >= 1); // MPACT is 1-based
-          Int const min_col0 = min_col - 1;
-
-          // Maximum column index
-          token = line_view.getTokenAndShrink();
-          Int const max_col = strto<Int>(token.data(), &end);
-          ASSERT(end != nullptr);
-          end = nullptr;
-          ASSERT(max_col >= min_col);
-
-          // Number of columns
-          Int const num_cols = max_col - min_col + 1;
-
-          // Read the scattering matrix elements
-          for (Int icol = 0; icol < num_cols; ++icol) {
-            token = line_view.getTokenAndShrink();
-            Float const value = strto<Float>(token.data(), &end);
-            ASSERT(end != nullptr);
-            end = nullptr;
-            if (value < 0) {
-              LOG_DEBUG("Nuclide with ZAID ", zaid,
-                        " has negative scattering matrix element at group ", ig,
-                        " and temperature ", itemp);
-            }
-            xsec.ss()(ig, min_col0 + icol) = value;
-          }
-        } // if (!absorption_only)
-      } // for (Int itemp = 0; itemp < num_temps; ++itemp)
-    } // for (Int ig = 0; ig < num_groups; ++ig)
-
-    nuclide.validate();
+    if (xs_offsets == nullptr) {
+      readNuclideXS(file, num_groups, nuclide);
+    } else {
+      // Read the cross section data later, on demand.
+      xs_offsets->emplace_back(static_cast<int64_t>(file.tellg()));
+    }
 
     // Skip the other sections until we find the next nuclide or the end of the file
     while (file.getline(line, max_line_length)) {
@@ -446,24 +486,464 @@ readMPACTLibrary(String const & filename, XSLibrary & lib)
   file.close();
 } // readMPACTLibrary
 
+//==============================================================================
+// Binary cache
+//==============================================================================
+// The cache is a header followed by the payload, which is the library written
+// field by field in native byte order:
+//  num_groups, num_nuclides, group_bounds, chi,
+//  for each nuclide:
+//    zaid, is_fissile, mass, num_temps, temperatures,
+//    for each temperature:
+//      is_macro, is_fissile, a, f, nuf, tr, s,
+//      ss: num_stored, first (G), offsets (G + 1), values (num_stored)
+// Int and bool fields are written as Int. Since the sizes of Int and Float are
+// recorded in the header, a cache is never read by a build with other types.
+
+char constexpr xs_cache_magic[8] = {'U', 'M', '2', 'X', 'S', 'L', 'I', 'B'};
+int32_t constexpr xs_cache_version = 2; // 2: banded scattering matrices
+
+struct XSCacheHeader {
+  char magic[8];
+  int32_t version;
+  int32_t int_size;
+  int32_t float_size;
+  int32_t padding;
+  // The library file the cache was made from
+  int64_t source_size;
+  int64_t source_mtime_sec;
+  int64_t source_mtime_nsec;
+  // The payload which follows the header
+  int64_t payload_size;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(XSCacheHeader) % 8 == 0);
+
+// Set the source fields of the header from the library file.
+auto
+statSource(String const & filename, XSCacheHeader & header) -> bool
+{
+  struct stat st = {};
+  if (stat(filename.data(), &st) != 0) {
+    return false;
+  }
+  header.source_size = static_cast<int64_t>(st.st_size);
+  // st_mtime is POSIX. The nanoseconds are only available through
+  // platform-specific fields, so they are 0 elsewhere and the cache is then
+  // validated to the second.
+  header.source_mtime_sec = static_cast<int64_t>(st.st_mtime);
+#if defined(__APPLE__)
+  header.source_mtime_nsec = static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+#elif defined(__linux__)
+  header.source_mtime_nsec = static_cast<int64_t>(st.st_mtim.tv_nsec);
+#else
+  header.source_mtime_nsec = 0;
+#endif
+  return true;
+}
+
+// FNV-1a over 8-byte words, then over the remaining bytes.
+PURE auto
+checksum(unsigned char const * data, int64_t const size) noexcept -> uint64_t
+{
+  uint64_t constexpr prime = 1099511628211ULL;
+  uint64_t h = 14695981039346656037ULL;
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, sizeof(uint64_t));
+    h ^= word;
+    h *= prime;
+  }
+  for (; i < size; ++i) {
+    h ^= data[i];
+    h *= prime;
+  }
+  return h;
+}
+
+// Write the payload to buffer and return its size. If buffer is null, only
+// compute the size.
+auto
+serializeLibrary(XSLibrary const & lib, unsigned char * const buffer) -> int64_t
+{
+  int64_t pos = 0;
+  auto const put = [&](void const * data, int64_t const size) {
+    if (buffer != nullptr) {
+      std::memcpy(buffer + pos, data, static_cast<size_t>(size));
+    }
+    pos += size;
+  };
+  auto const put_int = [&](Int const value) { put(&value, sizeof(Int)); };
+  auto const put_ints = [&](Int const * data, Int const n) {
+    put(data, static_cast<int64_t>(n) * static_cast<int64_t>(sizeof(Int)));
+  };
+  auto const put_floats = [&](Float const * data, Int const n) {
+    put(data, static_cast<int64_t>(n) * static_cast<int64_t>(sizeof(Float)));
+  };
+
+  Int const num_groups = lib.numGroups();
+  put_int(num_groups);
+  put_int(lib.nuclides().size());
+  put_floats(lib.groupBounds().data(), num_groups);
+  put_floats(lib.chi().data(), num_groups);
+  for (auto const & nuclide : lib.nuclides()) {
+    put_int(nuclide.zaid());
+    put_int(nuclide.isFissile() ? 1 : 0);
+    put(&nuclide.mass(), sizeof(Float));
+    Int const num_temps = nuclide.temperatures().size();
+    put_int(num_temps);
+    put_floats(nuclide.temperatures().data(), num_temps);
+    for (auto const & xsec : nuclide.xs()) {
+      ASSERT(xsec.numGroups() == num_groups);
+      put_int(xsec.isMacro() ? 1 : 0);
+      put_int(xsec.isFissile() ? 1 : 0);
+      put_floats(xsec.a().data(), num_groups);
+      put_floats(xsec.f().data(), num_groups);
+      put_floats(xsec.nuf().data(), num_groups);
+      put_floats(xsec.tr().data(), num_groups);
+      put_floats(xsec.s().data(), num_groups);
+      // The bands of the scattering matrix
+      auto const & ss = xsec.ss();
+      put_int(ss.numStored());
+      put_ints(ss.rowFirsts().data(), num_groups);
+      put_ints(ss.offsets().data(), num_groups + 1);
+      put_floats(ss.values().data(), ss.numStored());
+    }
+  }
+  return pos;
+}
+
+// Read the payload into lib. Returns false if the payload is malformed.
+auto
+deserializeLibrary(unsigned char const * const data, int64_t const size,
+                   XSLibrary & lib) -> bool
+{
+  int64_t pos = 0;
+  bool ok = true;
+  auto const get = [&](void * out, int64_t const n) {
+    if (!ok || n < 0 || size - pos < n) {
+      ok = false;
+      return;
+    }
+    std::memcpy(out, data + pos, static_cast<size_t>(n));
+    pos += n;
+  };
+  auto const get_int = [&]() {
+    Int value = 0;
+    get(&value, sizeof(Int));
+    return value;
+  };
+  auto const get_ints = [&](Int * out, Int const n) {
+    get(out, static_cast<int64_t>(n) * static_cast<int64_t>(sizeof(Int)));
+  };
+  auto const get_floats = [&](Float * out, Int const n) {
+    get(out, static_cast<int64_t>(n) * static_cast<int64_t>(sizeof(Float)));
+  };
+
+  Int const num_groups = get_int();
+  Int const num_nuclides = get_int();
+  if (!ok || num_groups <= 0 || num_nuclides < 0) {
+    return false;
+  }
+  lib.groupBounds().resize(num_groups);
+  lib.chi().resize(num_groups);
+  get_floats(lib.groupBounds().data(), num_groups);
+  get_floats(lib.chi().data(), num_groups);
+  lib.nuclides().resize(num_nuclides);
+  for (auto & nuclide : lib.nuclides()) {
+    nuclide.zaid() = get_int();
+    nuclide.isFissile() = get_int() != 0;
+    get(&nuclide.mass(), sizeof(Float));
+    Int const num_temps = get_int();
+    if (!ok || num_temps < 0) {
+      return false;
+    }
+    nuclide.temperatures().resize(num_temps);
+    get_floats(nuclide.temperatures().data(), num_temps);
+    nuclide.xs().resize(num_temps);
+    for (auto & xsec : nuclide.xs()) {
+      xsec = XSec(num_groups);
+      xsec.isMacro() = get_int() != 0;
+      xsec.isFissile() = get_int() != 0;
+      get_floats(xsec.a().data(), num_groups);
+      get_floats(xsec.f().data(), num_groups);
+      get_floats(xsec.nuf().data(), num_groups);
+      get_floats(xsec.tr().data(), num_groups);
+      get_floats(xsec.s().data(), num_groups);
+      Int const num_stored = get_int();
+      if (!ok || num_stored < 0 || num_stored > num_groups * num_groups) {
+        return false;
+      }
+      Vector<Int> first(num_groups);
+      Vector<Int> offsets(num_groups + 1);
+      Vector<Float> values(num_stored);
+      get_ints(first.data(), num_groups);
+      get_ints(offsets.data(), num_groups + 1);
+      get_floats(values.data(), num_stored);
+      if (!ok || !xsec.ss().setStorage(num_groups, num_groups, um2::move(first),
+                                       um2::move(offsets), um2::move(values))) {
+        return false;
+      }
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return ok && pos == size;
+}
+
 } // namespace
 
-XSLibrary::XSLibrary(String const & filename)
+//==============================================================================
+// Constructors
+//==============================================================================
+
+XSLibrary::XSLibrary(String const & filename, bool const lazy)
 {
+  if (lazy) {
+    // Assume MPACT format for now
+    readMPACTLibrary(filename, *this, &_xs_offsets);
+    ASSERT(_xs_offsets.size() == _nuclides.size());
+    _filename = filename;
+    _is_loaded = Vector<int8_t>(_nuclides.size(), 0);
+    rebuildZAIDTable();
+    return;
+  }
+  String const cache_filename = xsLibraryCacheFilename(filename);
+  if (settings::xs::use_library_cache && readCache(cache_filename, filename)) {
+    return;
+  }
   // Assume MPACT format for now
   readMPACTLibrary(filename, *this);
+  rebuildZAIDTable();
+  if (settings::xs::use_library_cache && !_nuclides.empty()) {
+    writeCache(cache_filename, filename);
+  }
+}
+
+//==============================================================================
+// Methods
+//==============================================================================
+
+namespace
+{
+
+// Fibonacci hashing. The high bits of the product are well mixed.
+CONST auto
+hashZAID(Int const zaid) noexcept -> uint64_t
+{
+  return (static_cast<uint64_t>(zaid) * 11400714819323198485ULL) >> 32U;
+}
+
+} // namespace
+
+void
+XSLibrary::rebuildZAIDTable()
+{
+  Int capacity = 16;
+  while (capacity < 2 * _nuclides.size()) {
+    capacity *= 2;
+  }
+  _zaid_table = Vector<Int>(capacity, -1);
+  auto const mask = static_cast<uint64_t>(capacity) - 1;
+  for (Int i = 0; i < _nuclides.size(); ++i) {
+    uint64_t slot = hashZAID(_nuclides[i].zaid()) & mask;
+    while (_zaid_table[static_cast<Int>(slot)] != -1) {
+      slot = (slot + 1) & mask;
+    }
+    _zaid_table[static_cast<Int>(slot)] = i;
+  }
 }
 
-PURE [[nodiscard]] auto
-XSLibrary::getNuclide(Int zaid) const noexcept -> Nuclide const &
+PURE auto
+XSLibrary::getNuclideIndex(Int const zaid) const noexcept -> Int
 {
-  for (auto const & nuclide : _nuclides) {
-    if (nuclide.zaid() == zaid) {
-      return nuclide;
+  if (!_zaid_table.empty()) {
+    auto const mask = static_cast<uint64_t>(_zaid_table.size()) - 1;
+    uint64_t slot = hashZAID(zaid) & mask;
+    while (true) {
+      Int const i = _zaid_table[static_cast<Int>(slot)];
+      if (i == -1) {
+        break;
+      }
+      if (i < _nuclides.size() && _nuclides[i].zaid() == zaid) {
+        return i;
+      }
+      slot = (slot + 1) & mask;
     }
   }
-  LOG_ERROR("Nuclide with ZAID ", zaid, " not found in library");
-  return _nuclides[0];
+  // The table is missing or out of date if the nuclides were modified through
+  // nuclides(). Fall back to a linear search.
+  for (Int i = 0; i < _nuclides.size(); ++i) {
+    if (_nuclides[i].zaid() == zaid) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void
+XSLibrary::loadNuclide(Int const i) const
+{
+  if (!isLazy()) {
+    return;
+  }
+  ASSERT(0 <= i);
+  ASSERT(i < _nuclides.size());
+  // Several threads may request nuclides at once. Each nuclide is read once.
+#if UM2_USE_OPENMP
+#  pragma omp critical(um2_xslibrary_load_nuclide)
+#endif
+  {
+    if (_is_loaded[i] == 0) {
+      std::ifstream file(_filename.data());
+      if (!file.is_open()) {
+        LOG_ERROR("Could not open file: ", _filename);
+      } else {
+        file.seekg(static_cast<std::streamoff>(_xs_offsets[i]));
+        readNuclideXS(file, numGroups(), _nuclides[i]);
+        _is_loaded[i] = 1;
+      }
+    }
+  }
+}
+
+auto
+XSLibrary::getNuclide(Int const zaid) const noexcept -> Nuclide const &
+{
+  Int const i = getNuclideIndex(zaid);
+  if (i == -1) {
+    LOG_ERROR("Nuclide with ZAID ", zaid, " not found in library");
+    return _nuclides[0];
+  }
+  loadNuclide(i);
+  return _nuclides[i];
+}
+
+auto
+XSLibrary::writeCache(String const & cache_filename,
+                      String const & source_filename) const -> bool
+{
+  XSCacheHeader header = {};
+  std::memcpy(header.magic, xs_cache_magic, sizeof(header.magic));
+  header.version = xs_cache_version;
+  header.int_size = static_cast<int32_t>(sizeof(Int));
+  header.float_size = static_cast<int32_t>(sizeof(Float));
+  if (!statSource(source_filename, header)) {
+    LOG_WARN("Could not stat cross section library: ", source_filename);
+    return false;
+  }
+  for (Int i = 0; i < _nuclides.size(); ++i) {
+    loadNuclide(i);
+  }
+  header.payload_size = serializeLibrary(*this, nullptr);
+  Vector<unsigned char> payload(static_cast<Int>(header.payload_size));
+  serializeLibrary(*this, payload.data());
+  header.checksum = checksum(payload.data(), header.payload_size);
+
+  // Write to a uniquely named temporary file in the same directory, then
+  // rename it over the cache. The rename is atomic, so readers see either the
+  // old cache or a complete new one, and processes writing the same cache at
+  // the same time never write into the same file.
+  String const tmp_template = cache_filename + ".XXXXXX";
+  Vector<char> tmp_filename(tmp_template.size() + 1);
+  std::memcpy(tmp_filename.data(), tmp_template.data(),
+              static_cast<size_t>(tmp_template.size()));
+  tmp_filename.back() = '\0';
+  int const fd = mkstemp(tmp_filename.data());
+  if (fd < 0) {
+    LOG_WARN("Could not write cross section library cache: ", cache_filename);
+    return false;
+  }
+  // mkstemp creates the file readable only by its owner
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  auto const write_all = [fd](void const * data, int64_t size) {
+    auto const * p = static_cast<char const *>(data);
+    while (size > 0) {
+      ssize_t const n = write(fd, p, static_cast<size_t>(size));
+      if (n <= 0) {
+        return false;
+      }
+      p += n;
+      size -= n;
+    }
+    return true;
+  };
+  bool ok = write_all(&header, sizeof(XSCacheHeader)) &&
+            write_all(payload.data(), header.payload_size);
+  ok = (close(fd) == 0) && ok;
+  if (!ok || std::rename(tmp_filename.data(), cache_filename.data()) != 0) {
+    std::remove(tmp_filename.data());
+    LOG_WARN("Could not write cross section library cache: ", cache_filename);
+    return false;
+  }
+  LOG_INFO("Wrote cross section library cache: ", cache_filename);
+  return true;
+}
+
+auto
+XSLibrary::readCache(String const & cache_filename, String const & source_filename)
+    -> bool
+{
+  int const fd = ::open(cache_filename.data(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(XSCacheHeader))) {
+    ::close(fd);
+    LOG_INFO("Ignoring invalid cross section library cache: ", cache_filename);
+    return false;
+  }
+  auto const size = static_cast<size_t>(st.st_size);
+  void * map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  auto const * const base = static_cast<unsigned char const *>(map);
+
+  // The header must match this build and the current library file.
+  XSCacheHeader header = {};
+  std::memcpy(&header, base, sizeof(XSCacheHeader));
+  XSCacheHeader source = {};
+  bool valid = std::memcmp(header.magic, xs_cache_magic, sizeof(header.magic)) == 0 &&
+               header.version == xs_cache_version &&
+               header.int_size == static_cast<int32_t>(sizeof(Int)) &&
+               header.float_size == static_cast<int32_t>(sizeof(Float)) &&
+               statSource(source_filename, source) &&
+               header.source_size == source.source_size &&
+               header.source_mtime_sec == source.source_mtime_sec &&
+               header.source_mtime_nsec == source.source_mtime_nsec &&
+               header.payload_size ==
+                   static_cast<int64_t>(size - sizeof(XSCacheHeader));
+  unsigned char const * const payload = base + sizeof(XSCacheHeader);
+  valid = valid && checksum(payload, header.payload_size) == header.checksum;
+
+  // Read into a temporary, so that the library is unchanged on failure.
+  XSLibrary lib;
+  valid = valid && deserializeLibrary(payload, header.payload_size, lib);
+  munmap(map, size);
+  if (!valid) {
+    LOG_INFO("Ignoring out of date cross section library cache: ", cache_filename);
+    return false;
+  }
+  LOG_INFO("Read cross section library cache: ", cache_filename);
+  *this = um2::move(lib);
+  rebuildZAIDTable();
+  return true;
+}
+
+//==============================================================================
+// Free functions
+//==============================================================================
+
+PURE auto
+xsLibraryCacheFilename(String const & filename) -> String
+{
+  return filename + ".um2cache";
 }
 
 } // namespace um2
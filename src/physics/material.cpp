@@ -473,23 +473,9 @@ Material::populateXSec(XSLibrary const & xsec_lib) noexcept
   for (Int inuc = 0; inuc < num_nuclides; ++inuc) {
     auto const zaid = _zaid[inuc];
     auto const & lib_nuc = xsec_lib.getNuclide(zaid);
-    auto const xs_nuc = lib_nuc.interpXS(getTemperature());
     auto const atom_density = numDensity(inuc);
     ASSERT(atom_density > 0);
-    if (xs_nuc.isFissile()) {
-      _xsec.isFissile() = true;
-    }
-    // TODO(kcvaughn): This should be done using arithmetic operations on XSec
-    for (Int ig = 0; ig < num_groups; ++ig) {
-      _xsec.a()[ig] += xs_nuc.a()[ig] * atom_density;
-      _xsec.f()[ig] += xs_nuc.f()[ig] * atom_density;
-      _xsec.nuf()[ig] += xs_nuc.nuf()[ig] * atom_density;
-      _xsec.tr()[ig] += xs_nuc.tr()[ig] * atom_density;
-      _xsec.s()[ig] += xs_nuc.s()[ig] * atom_density;
-      for (Int jg = 0; jg < num_groups; ++jg) {
-        _xsec.ss()(jg, ig) += xs_nuc.ss()(jg, ig) * atom_density;
-      }
-    }
+    lib_nuc.addInterpXS(getTemperature(), atom_density, _xsec);
   }
   _xsec.validate();
 }
@@ -654,4 +640,18 @@ getC5G7Materials() noexcept -> Vector<Material>
   return materials;
 }
 
+void
+populateXSec(Vector<Material> & materials, XSLibrary const & xsec_lib) noexcept
+{
+  // Each material only writes its own cross sections, and a lazy library reads
+  // each nuclide once under a lock, so the materials are independent.
+  Int const num_materials = materials.size();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (Int i = 0; i < num_materials; ++i) {
+    materials[i].populateXSec(xsec_lib);
+  }
+}
+
 } // namespace um2
@@ -63,61 +63,78 @@ Nuclide::validate() const noexcept
   }
 }
 
-PURE [[nodiscard]] auto
-Nuclide::interpXS(Float const temperature) const noexcept -> XSec
+namespace
 {
-  // Linearly interpolate the cross sections over the sqrt of temperature
-  //
-  // XS = XS0 + (sqrt_t - sqrt_t0) / (sqrt_t1 - sqrt_t0) * (XS1 - XS0)
-  //
-  // First, make sure we have enough data to interpolate
-  if (_temperatures.size() == 1) {
-    return _xs[0];
-  }
 
+// Find the temperatures which bracket the temperature. The cross sections at
+// the temperature are xs[i0] + d * (xs[i0 + 1] - xs[i0]), where d is linear in
+// the sqrt of temperature. Returns false if no interpolation is needed, since
+// the temperature is outside the range of the data or there is only one
+// temperature, in which case the cross sections are simply xs[i0].
+auto
+getInterpBracket(Vector<Float> const & temperatures, Float const temperature,
+                 Int & i0, Float & d) noexcept -> bool
+{
+  ASSERT(!temperatures.empty());
+  d = 0;
+  i0 = 0;
   // If the requested temperature is outside the range, use the closest value
-  if (temperature <= _temperatures[0]) {
-    return _xs[0];
+  if (temperatures.size() == 1 || temperature <= temperatures[0]) {
+    return false;
   }
-  if (temperature >= _temperatures.back()) {
-    return _xs.back();
+  if (temperature >= temperatures.back()) {
+    i0 = temperatures.size() - 1;
+    return false;
   }
 
   // Find the temperature range that contains the requested temperature
   // We know it's in the range, so we don't need to check for that
   Int i = 0;
-  while (temperature >= _temperatures[i]) {
+  while (temperature >= temperatures[i]) {
     ++i;
   }
   // Now i is the index of the upper temperature
-  Int const i0 = i - 1;
-  Int const i1 = i;
-  Float const t0 = _temperatures[i0];
-  Float const t1 = _temperatures[i1];
-  Float const sqrt_t0 = um2::sqrt(t0);
-  Float const sqrt_t1 = um2::sqrt(t1);
+  i0 = i - 1;
+  Float const sqrt_t0 = um2::sqrt(temperatures[i0]);
+  Float const sqrt_t1 = um2::sqrt(temperatures[i]);
   Float const sqrt_t = um2::sqrt(temperature);
-  Float const d = (sqrt_t - sqrt_t0) / (sqrt_t1 - sqrt_t0);
+  d = (sqrt_t - sqrt_t0) / (sqrt_t1 - sqrt_t0);
+  return true;
+}
+
+} // namespace
+
+void
+Nuclide::addInterpXS(Float const temperature, Float const scale,
+                     XSec & xs) const noexcept
+{
+  // Linearly interpolate the cross sections over the sqrt of temperature
+  //
+  // XS = XS0 + (sqrt_t - sqrt_t0) / (sqrt_t1 - sqrt_t0) * (XS1 - XS0)
+  //
+  // and accumulate scale * XS into xs in one pass over its data, without a
+  // temporary XSec.
+  Int i0 = 0;
+  Float d = 0;
+  bool const interpolate = getInterpBracket(_temperatures, temperature, i0, d);
   XSec const & xs0 = _xs[i0];
-  XSec const & xs1 = _xs[i1];
-  Int const ng = xs0.numGroups();
-  XSec xs(xs0.numGroups());
-  ASSERT(xs1.numGroups() == ng);
-  xs.isMacro() = xs0.isMacro();
-  xs.isFissile() = xs0.isFissile();
-
-  // Interpolate the cross sections
-  // TODO(kcvaughn): This should be handled with arithmetic operators on the XSec
-  for (Int g = 0; g < ng; ++g) {
-    xs.a()[g] = xs0.a()[g] + d * (xs1.a()[g] - xs0.a()[g]);
-    xs.f()[g] = xs0.f()[g] + d * (xs1.f()[g] - xs0.f()[g]);
-    xs.nuf()[g] = xs0.nuf()[g] + d * (xs1.nuf()[g] - xs0.nuf()[g]);
-    xs.tr()[g] = xs0.tr()[g] + d * (xs1.tr()[g] - xs0.tr()[g]);
-    xs.s()[g] = xs0.s()[g] + d * (xs1.s()[g] - xs0.s()[g]);
-    for (Int gg = 0; gg < ng; ++gg) {
-      xs.ss()(gg, g) = xs0.ss()(gg, g) + d * (xs1.ss()(gg, g) - xs0.ss()(gg, g));
-    }
+  ASSERT(xs.numGroups() == xs0.numGroups());
+  if (xs0.isFissile()) {
+    xs.isFissile() = true;
   }
+  if (interpolate) {
+    xs.addLerp(scale, d, xs0, _xs[i0 + 1]);
+  } else {
+    xs.axpy(scale, xs0);
+  }
+}
+
+PURE [[nodiscard]] auto
+Nuclide::interpXS(Float const temperature) const noexcept -> XSec
+{
+  XSec xs(_xs[0].numGroups());
+  xs.isMacro() = _xs[0].isMacro();
+  addInterpXS(temperature, 1, xs);
   return xs;
 }
 
@@ -128,6 +128,22 @@ um2MPACTNumAssemblies(void * const model, Int * const n)
   ASSERT(*n > 0);
 }
 
+void
+um2MPACTNumCoarseCellsTotal(void * const model, Int * const n)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  *n = sp.numCoarseCellsTotal();
+  ASSERT(*n > 0);
+}
+
+void
+um2MPACTNumFineCellsTotal(void * const model, Int * const n)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  *n = sp.numFineCellsTotal();
+  ASSERT(*n > 0);
+}
+
 // NumCells
 //------------------------------------------------------------------------------
 
@@ -406,6 +422,59 @@ um2MPACTRTMHeight(void * const model, Int const rtm_id, Float * const height)
   *height = sp.getRTM(rtm_id).grid().extents(1);
 }
 
+void
+um2MPACTFindFSR(void * const model, Float const x, Float const y, Float const z,
+                Int * const fsr_id)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  *fsr_id = sp.findFSR(um2::Point3F(x, y, z));
+}
+
+void
+um2MPACTFindFSRs(void * const model, Int const n, Float const * const xyz,
+                 Int * const fsr_ids)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  um2::Vector<um2::Point3F> points(n);
+  for (Int i = 0; i < n; ++i) {
+    points[i] = um2::Point3F(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+  }
+  auto const ids = sp.findFSRs(points);
+  for (Int i = 0; i < n; ++i) {
+    fsr_ids[i] = ids[i];
+  }
+}
+
+void
+um2MPACTFSRCoarseCell(void * const model, Int const fsr_id, Int * const cc_id,
+                      Int * const face_id)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  if (fsr_id < 0 || fsr_id >= sp.numFineCellsTotal()) {
+    LOG_ERROR("Invalid FSR ID ", fsr_id);
+    *cc_id = -1;
+    *face_id = -1;
+    return;
+  }
+  auto const location = sp.getFSRLocation(fsr_id);
+  *cc_id = sp.coarseCellInstances()[location.first].cc_id;
+  *face_id = location.second;
+}
+
+void
+um2MPACTCoarseCellInstanceFSROffset(void * const model, Int const instance,
+                                    Int * const fsr_offset)
+{
+  auto const & sp = *reinterpret_cast<um2::mpact::Model *>(model);
+  auto const & instances = sp.coarseCellInstances();
+  if (instance < 0 || instance >= instances.size()) {
+    LOG_ERROR("Invalid coarse cell instance ", instance);
+    *fsr_offset = -1;
+    return;
+  }
+  *fsr_offset = instances[instance].fsr_offset;
+}
+
 void
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 um2MPACTCoarseCellHeights(void * model, Int * const n, Int ** cc_ids, Float ** heights)
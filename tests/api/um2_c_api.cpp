@@ -1,4 +1,5 @@
 #include <um2/common/cast_if_not.hpp>
+#include <um2/common/logger.hpp>
 #include <um2/config.hpp>
 #include <um2/math/vec.hpp>
 #include <um2/mpact/model.hpp>
@@ -77,6 +78,42 @@ TEST_CASE(read_mpact_model)
   ASSERT(n == 1);
   n = -1;
 
+  // Point location
+  auto const box = model.getCore().grid().boundingBox();
+  auto const center = box.centroid();
+  Float const z = model.getAssembly(0).grid().getBox(0).centroid()[0];
+  um2MPACTFindFSR(sp, center[0], center[1], z, &n);
+  ASSERT(n == model.findFSR(center));
+  ASSERT(0 <= n);
+  ASSERT(n < model.numFineCellsTotal());
+  Float const xyz[6] = {center[0], center[1], z, box.maxima(0) + 1, center[1], z};
+  Int fsr_ids[2] = {-2, -2};
+  um2MPACTFindFSRs(sp, 2, xyz, fsr_ids);
+  ASSERT(fsr_ids[0] == n);
+  ASSERT(fsr_ids[1] == -1);
+
+  // Global fine cell indices
+  Int num_fsrs = -1;
+  um2MPACTNumFineCellsTotal(sp, &num_fsrs);
+  ASSERT(num_fsrs == model.numFineCellsTotal());
+  Int cc_id = -1;
+  Int face_id = -1;
+  um2MPACTFSRCoarseCell(sp, num_fsrs - 1, &cc_id, &face_id);
+  ASSERT(cc_id == model.coarseCellInstances().back().cc_id);
+  ASSERT(face_id == model.getCoarseCell(cc_id).numFaces() - 1);
+  Int offset = -1;
+  um2MPACTCoarseCellInstanceFSROffset(sp, 0, &offset);
+  ASSERT(offset == 0);
+
+  // Out of range IDs are reported, not read
+  um2::logger::exit_on_error = false;
+  um2MPACTFSRCoarseCell(sp, num_fsrs, &cc_id, &face_id);
+  ASSERT(cc_id == -1);
+  ASSERT(face_id == -1);
+  um2MPACTCoarseCellInstanceFSROffset(sp, -1, &offset);
+  ASSERT(offset == -1);
+  um2::logger::exit_on_error = true;
+
   um2DeleteMPACTModel(sp);
   um2Finalize();
 }
@@ -0,0 +1,55 @@
+#include <um2/common/radix_sort.hpp>
+#include <um2/config.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include "../test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+
+template <class U>
+TEST_CASE(radixSortPermutation)
+{
+  Int constexpr n = 1000;
+  std::mt19937_64 rng(42);
+  um2::Vector<U> keys(n);
+  for (auto & key : keys) {
+    key = static_cast<U>(rng());
+  }
+  // Duplicate keys to check stability.
+  for (Int i = 0; i < n; i += 10) {
+    keys[i + 1] = keys[i];
+  }
+  um2::Vector<Int> perm(n);
+  um2::radixSortPermutation(keys.cbegin(), keys.cend(), perm.begin());
+  for (Int i = 1; i < n; ++i) {
+    U const a = keys[perm[i - 1]];
+    U const b = keys[perm[i]];
+    ASSERT(a <= b);
+    if (a == b) {
+      ASSERT(perm[i - 1] < perm[i]);
+    }
+  }
+
+  // Keys that differ only in the low digit, so the higher digits are skipped.
+  for (Int i = 0; i < n; ++i) {
+    keys[i] = static_cast<U>((n - i) % 256);
+  }
+  um2::radixSortPermutation(keys.cbegin(), keys.cend(), perm.begin());
+  for (Int i = 1; i < n; ++i) {
+    ASSERT(keys[perm[i - 1]] <= keys[perm[i]]);
+  }
+}
+
+TEST_SUITE(radix_sort)
+{
+  TEST((radixSortPermutation<uint32_t>));
+  TEST((radixSortPermutation<uint64_t>));
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(radix_sort);
+  return 0;
+}
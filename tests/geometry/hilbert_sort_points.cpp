@@ -0,0 +1,74 @@
+#include <um2/common/settings.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/hilbert_sort_points.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/space_filling_curve_sort.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include "../test_macros.hpp"
+
+// The order in which the Hilbert curve visits a 4 by 4 grid.
+Int constexpr hilbert_x[16] = {0, 1, 1, 0, 0, 0, 1, 1, 2, 2, 3, 3, 3, 2, 2, 3};
+Int constexpr hilbert_y[16] = {0, 0, 1, 1, 2, 3, 3, 2, 2, 3, 3, 2, 1, 1, 0, 0};
+
+template <class T>
+auto
+makeGrid() -> um2::Vector<um2::Point2<T>>
+{
+  // Map a 4 by 4 grid of points to the unit square.
+  um2::Vector<um2::Point2<T>> points(16);
+  for (Int i = 0; i < 4; ++i) {
+    for (Int j = 0; j < 4; ++j) {
+      points[i * 4 + j] = um2::Point2<T>(i, j);
+      points[i * 4 + j] /= 3;
+    }
+  }
+  return points;
+}
+
+template <class T>
+TEST_CASE(hilbertSort)
+{
+  auto points = makeGrid<T>();
+  um2::hilbertSort(points.begin(), points.end());
+  for (Int i = 0; i < 16; ++i) {
+    ASSERT(points[i].isApprox(um2::Point2<T>(hilbert_x[i], hilbert_y[i]) / 3));
+  }
+}
+
+template <class T>
+TEST_CASE(spaceFillingCurveSort)
+{
+  // The Hilbert curve.
+  auto points = makeGrid<T>();
+  um2::spaceFillingCurveSort(points.begin(), points.end(),
+                             um2::SpaceFillingCurve::Hilbert);
+  for (Int i = 0; i < 16; ++i) {
+    ASSERT(points[i].isApprox(um2::Point2<T>(hilbert_x[i], hilbert_y[i]) / 3));
+  }
+
+  // The Morton curve, selected by the global setting.
+  points = makeGrid<T>();
+  auto expected = makeGrid<T>();
+  um2::mortonSort<2>(expected.begin(), expected.end());
+  um2::settings::mesh::space_filling_curve = um2::SpaceFillingCurve::Morton;
+  um2::spaceFillingCurveSort(points.begin(), points.end());
+  for (Int i = 0; i < 16; ++i) {
+    ASSERT(points[i].isApprox(expected[i]));
+  }
+}
+
+template <class T>
+TEST_SUITE(hilbertSortSuite)
+{
+  TEST(hilbertSort<T>);
+  TEST(spaceFillingCurveSort<T>);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(hilbertSortSuite<float>);
+  RUN_SUITE(hilbertSortSuite<double>);
+  return 0;
+}
@@ -285,6 +285,41 @@ TEST_CASE(intersect)
   }
 }
 
+template <class T>
+HOSTDEV
+TEST_CASE(intersect_packet)
+{
+  // Each lane of the packet must match the single ray intersection exactly.
+  Int constexpr k = 4;
+  um2::Point2<T> const p0(0, 0);
+  T const dang = um2::pi<T> / 16;
+  for (T ang = dang; ang < 2 * um2::pi<T>; ang += dang) {
+    um2::Point2<T> const p1(um2::cos(ang), um2::sin(ang));
+    um2::LineSegment2<T> const line(p0, p1);
+    auto aabb = line.boundingBox();
+    aabb.scale(castIfNot<T>(1.1));
+    um2::ModularRayParams const params(um2::pi<T> / 5, aabb.extents(0) / 16, aabb);
+    Int const num_rays = params.getTotalNumRays();
+    for (Int i = 0; i + k <= num_rays; i += k) {
+      um2::Vec<k, T> ox;
+      um2::Vec<k, T> oy;
+      for (Int j = 0; j < k; ++j) {
+        ox[j] = params.getRay(i + j).origin()[0];
+        oy[j] = params.getRay(i + j).origin()[1];
+      }
+      um2::RayPacket2<k, T> const packet(ox, oy, params.getDirection());
+      um2::Vec<k, T> r;
+      uint32_t const mask = line.intersect(packet, r);
+      for (Int j = 0; j < k; ++j) {
+        T rj = 0;
+        Int const hit = line.intersect(packet.getRay(j), &rj);
+        ASSERT(hit == static_cast<Int>((mask >> static_cast<uint32_t>(j)) & 1U));
+        ASSERT_NEAR(r[j], rj, 0);
+      }
+    }
+  }
+}
+
 #if UM2_USE_CUDA
 template <Int D, class T>
 MAKE_CUDA_KERNEL(accessors, D, T);
@@ -309,6 +344,7 @@ TEST_SUITE(LineSegment)
     TEST_HOSTDEV(getRotation, T);
     TEST_HOSTDEV(isLeft, T);
     TEST_HOSTDEV(intersect, T);
+    TEST_HOSTDEV(intersect_packet, T);
   }
 }
 
@@ -0,0 +1,174 @@
+#include <um2/common/cast_if_not.hpp>
+#include <um2/config.hpp>
+#include <um2/math/banded_matrix.hpp>
+#include <um2/math/matrix.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include "../test_macros.hpp"
+
+// A 4 by 4 lower Hessenberg matrix, like a scattering matrix with one group of
+// upscatter.
+//  1  2  0  0
+//  3  4  5  0
+//  0  6  7  8
+//  0  0  0  9
+template <class T>
+auto
+makeDense() -> um2::Matrix<T>
+{
+  um2::Matrix<T> m(4, 4, static_cast<T>(0));
+  m(0, 0) = 1;
+  m(0, 1) = 2;
+  m(1, 0) = 3;
+  m(1, 1) = 4;
+  m(1, 2) = 5;
+  m(2, 1) = 6;
+  m(2, 2) = 7;
+  m(2, 3) = 8;
+  m(3, 3) = 9;
+  return m;
+}
+
+template <class T>
+TEST_CASE(from_dense)
+{
+  auto const eps = castIfNot<T>(1e-6);
+  auto const dense = makeDense<T>();
+  um2::BandedMatrix<T> const a(dense);
+  ASSERT(a.rows() == 4);
+  ASSERT(a.cols() == 4);
+  ASSERT(a.numStored() == 9);
+  ASSERT(a.rowFirst(0) == 0);
+  ASSERT(a.rowLast(0) == 2);
+  ASSERT(a.rowFirst(2) == 1);
+  ASSERT(a.rowLast(2) == 4);
+  ASSERT(a.rowFirst(3) == 3);
+  ASSERT(a.rowLast(3) == 4);
+  auto const back = a.toDense();
+  for (Int j = 0; j < 4; ++j) {
+    for (Int i = 0; i < 4; ++i) {
+      ASSERT_NEAR(a(i, j), dense(i, j), eps);
+      ASSERT_NEAR(back(i, j), dense(i, j), eps);
+    }
+  }
+  ASSERT_NEAR(a.sum(), static_cast<T>(45), eps);
+
+  // An all-zero matrix stores nothing
+  um2::BandedMatrix<T> const z(um2::Matrix<T>(3, 3, static_cast<T>(0)));
+  ASSERT(z.numStored() == 0);
+  ASSERT_NEAR(z(1, 2), static_cast<T>(0), eps);
+}
+
+template <class T>
+TEST_CASE(set_widen)
+{
+  auto const eps = castIfNot<T>(1e-6);
+  um2::BandedMatrix<T> a(3, 3);
+  ASSERT(a.numStored() == 0);
+  a.set(1, 1, 4);
+  ASSERT(a.numStored() == 1);
+  // Widening a row fills the gap with zeros and leaves other rows alone
+  a.set(1, 2, 5);
+  a.set(0, 0, 1);
+  a.set(1, 0, 3);
+  ASSERT(a.numStored() == 4);
+  ASSERT(a.rowFirst(1) == 0);
+  ASSERT(a.rowLast(1) == 3);
+  ASSERT_NEAR(a(1, 0), static_cast<T>(3), eps);
+  ASSERT_NEAR(a(1, 1), static_cast<T>(4), eps);
+  ASSERT_NEAR(a(1, 2), static_cast<T>(5), eps);
+  ASSERT_NEAR(a(0, 0), static_cast<T>(1), eps);
+  ASSERT_NEAR(a(0, 1), static_cast<T>(0), eps);
+  ASSERT_NEAR(a(2, 2), static_cast<T>(0), eps);
+  a.widenRow(2, 0, 2);
+  ASSERT(a.numStored() == 6);
+  ASSERT_NEAR(a(2, 0), static_cast<T>(0), eps);
+  // Writing within the band does not allocate
+  a.set(2, 1, 6);
+  ASSERT(a.numStored() == 6);
+  ASSERT_NEAR(a(2, 1), static_cast<T>(6), eps);
+
+  // Bad storage is rejected
+  um2::Vector<Int> first = {0, 0, 0};
+  um2::Vector<Int> offsets = {0, 2, 4, 6};
+  um2::Vector<T> values(6, static_cast<T>(1));
+  ASSERT(!a.setStorage(3, 1, first, offsets, values));
+  ASSERT(a.numStored() == 6);
+  ASSERT(a.setStorage(3, 3, first, offsets, values));
+  ASSERT_NEAR(a.sum(), static_cast<T>(6), eps);
+}
+
+template <class T>
+TEST_CASE(arithmetic)
+{
+  auto const eps = castIfNot<T>(1e-6);
+  auto const dense = makeDense<T>();
+  um2::BandedMatrix<T> const x0(dense);
+  um2::BandedMatrix<T> x1(4, 4);
+  x1.set(3, 0, 10);
+  x1.set(0, 0, 2);
+
+  // y = 2 * x0 + x1
+  um2::BandedMatrix<T> y(4, 4);
+  y.addScaled(2, x0);
+  y.addScaled(1, x1);
+  for (Int j = 0; j < 4; ++j) {
+    for (Int i = 0; i < 4; ++i) {
+      ASSERT_NEAR(y(i, j), 2 * dense(i, j) + x1(i, j), eps);
+    }
+  }
+  y *= static_cast<T>(0.5);
+  ASSERT_NEAR(y(3, 0), static_cast<T>(5), eps);
+  ASSERT_NEAR(y(2, 3), static_cast<T>(8), eps);
+
+  // Interpolation with matching and mismatched bands
+  T const d = static_cast<T>(0.25);
+  um2::BandedMatrix<T> z(4, 4);
+  z.addInterp(2, d, x0, x0);
+  z.addInterp(1, d, x0, x1);
+  for (Int j = 0; j < 4; ++j) {
+    for (Int i = 0; i < 4; ++i) {
+      T const expected = 2 * dense(i, j) + dense(i, j) + d * (x1(i, j) - dense(i, j));
+      ASSERT_NEAR(z(i, j), expected, eps);
+    }
+  }
+}
+
+template <class T>
+TEST_CASE(multiply)
+{
+  auto const eps = castIfNot<T>(1e-6);
+  auto const dense = makeDense<T>();
+  um2::BandedMatrix<T> const a(dense);
+  um2::Vector<T> const x = {1, 2, 3, 4};
+  um2::Vector<T> y(4);
+  a.multiply(x.data(), y.data());
+  ASSERT_NEAR(y[0], static_cast<T>(5), eps);
+  ASSERT_NEAR(y[1], static_cast<T>(26), eps);
+  ASSERT_NEAR(y[2], static_cast<T>(65), eps);
+  ASSERT_NEAR(y[3], static_cast<T>(36), eps);
+
+  um2::Vector<T> sums(4);
+  a.columnSums(sums.data());
+  ASSERT_NEAR(sums[0], static_cast<T>(4), eps);
+  ASSERT_NEAR(sums[1], static_cast<T>(12), eps);
+  ASSERT_NEAR(sums[2], static_cast<T>(12), eps);
+  ASSERT_NEAR(sums[3], static_cast<T>(17), eps);
+}
+
+template <class T>
+TEST_SUITE(BandedMatrix)
+{
+  TEST(from_dense<T>);
+  TEST(set_widen<T>);
+  TEST(arithmetic<T>);
+  TEST(multiply<T>);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(BandedMatrix<float>);
+  RUN_SUITE(BandedMatrix<double>);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <um2/math/hilbert.hpp>
+
+#include <um2/config.hpp>
+
+#include <cstdint>
+
+// NOLINTNEXTLINE(misc-include-cleaner)
+#include <concepts>
+
+#include "../test_macros.hpp"
+
+template <std::unsigned_integral U>
+HOSTDEV
+TEST_CASE(hilbertEncode)
+{
+  // The order in which the Hilbert curve visits a 4 by 4 grid.
+  U const xs[16] = {0, 1, 1, 0, 0, 0, 1, 1, 2, 2, 3, 3, 3, 2, 2, 3};
+  U const ys[16] = {0, 0, 1, 1, 2, 3, 3, 2, 2, 3, 3, 2, 1, 1, 0, 0};
+  for (U i = 0; i < 16; ++i) {
+    ASSERT(um2::hilbertEncode(xs[i], ys[i]) == i);
+  }
+  // The curve ends at the bottom right corner.
+  U constexpr max_coord = um2::max_2d_hilbert_coord<U>;
+  U constexpr zero = 0;
+  ASSERT(um2::hilbertEncode(max_coord, zero) == static_cast<U>(-1));
+}
+
+template <std::unsigned_integral U>
+HOSTDEV
+TEST_CASE(hilbertDecode)
+{
+  U const codes[6] = {0, 1, 7, 12, 1000, 123456};
+  for (auto const code : codes) {
+    U x;
+    U y;
+    um2::hilbertDecode(code, x, y);
+    ASSERT(um2::hilbertEncode(x, y) == code);
+  }
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+HOSTDEV
+TEST_CASE(hilbertEncodeDecodeFloat)
+{
+  T const x = static_cast<T>(0.25);
+  T const y = static_cast<T>(0.75);
+  U const code = um2::hilbertEncode<U>(x, y);
+  T xd;
+  T yd;
+  um2::hilbertDecode(code, xd, yd);
+  T const tol = static_cast<T>(1e-4);
+  ASSERT_NEAR(xd, x, tol);
+  ASSERT_NEAR(yd, y, tol);
+}
+
+#if UM2_USE_CUDA
+template <std::unsigned_integral U>
+MAKE_CUDA_KERNEL(hilbertEncode, U);
+
+template <std::unsigned_integral U>
+MAKE_CUDA_KERNEL(hilbertDecode, U);
+
+template <std::unsigned_integral U, std::floating_point T>
+MAKE_CUDA_KERNEL(hilbertEncodeDecodeFloat, U, T);
+#endif
+
+template <std::unsigned_integral U>
+TEST_SUITE(hilbert)
+{
+  TEST_HOSTDEV(hilbertEncode, U);
+  TEST_HOSTDEV(hilbertDecode, U);
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_SUITE(hilbertFloat)
+{
+  TEST_HOSTDEV(hilbertEncodeDecodeFloat, U, T);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(hilbert<uint32_t>);
+  RUN_SUITE(hilbert<uint64_t>);
+  RUN_SUITE((hilbertFloat<uint32_t, float>));
+  RUN_SUITE((hilbertFloat<uint64_t, double>));
+  return 0;
+}
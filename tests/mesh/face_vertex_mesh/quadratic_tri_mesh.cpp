@@ -1,11 +1,24 @@
+#include <um2/common/cast_if_not.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/geometry/polytope.hpp>
+#include <um2/geometry/ray.hpp>
+#include <um2/math/vec.hpp>
 #include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mesh/polytope_soup.hpp>
+#include <um2/stdlib/math/roots.hpp>
+#include <um2/stdlib/math/trigonometric_functions.hpp>
+#include <um2/stdlib/numbers.hpp>
+#include <um2/stdlib/vector.hpp>
 
 #include "../helpers/setup_mesh.hpp"
 #include "../helpers/setup_polytope_soup.hpp"
 
 #include "../../test_macros.hpp"
 
-F constexpr eps = condCast<F>(1e-6);
+#include <algorithm>
+
+auto constexpr eps = castIfNot<Float>(1e-6);
 
 HOSTDEV
 TEST_CASE(accessors)
@@ -14,26 +27,20 @@ TEST_CASE(accessors)
   ASSERT(mesh.numVertices() == 9);
   ASSERT(mesh.numFaces() == 2);
   // face
-  um2::QuadraticTriangle2 tri0_ref(mesh.getVertex(0), mesh.getVertex(1),
-                                   mesh.getVertex(2), mesh.getVertex(3),
-                                   mesh.getVertex(4), mesh.getVertex(5));
+  um2::QuadraticTriangle2F const tri0_ref(mesh.getVertex(0), mesh.getVertex(1),
+                                          mesh.getVertex(2), mesh.getVertex(3),
+                                          mesh.getVertex(4), mesh.getVertex(5));
   auto const tri0 = mesh.getFace(0);
-  ASSERT(um2::isApprox(tri0[0], tri0_ref[0]));
-  ASSERT(um2::isApprox(tri0[1], tri0_ref[1]));
-  ASSERT(um2::isApprox(tri0[2], tri0_ref[2]));
-  ASSERT(um2::isApprox(tri0[3], tri0_ref[3]));
-  ASSERT(um2::isApprox(tri0[4], tri0_ref[4]));
-  ASSERT(um2::isApprox(tri0[5], tri0_ref[5]));
-  um2::QuadraticTriangle2 tri1_ref(mesh.getVertex(1), mesh.getVertex(6),
-                                   mesh.getVertex(2), mesh.getVertex(7),
-                                   mesh.getVertex(8), mesh.getVertex(4));
+  for (Int i = 0; i < 6; ++i) {
+    ASSERT(tri0[i].isApprox(tri0_ref[i]));
+  }
+  um2::QuadraticTriangle2F const tri1_ref(mesh.getVertex(1), mesh.getVertex(6),
+                                          mesh.getVertex(2), mesh.getVertex(7),
+                                          mesh.getVertex(8), mesh.getVertex(4));
   auto const tri1 = mesh.getFace(1);
-  ASSERT(um2::isApprox(tri1[0], tri1_ref[0]));
-  ASSERT(um2::isApprox(tri1[1], tri1_ref[1]));
-  ASSERT(um2::isApprox(tri1[2], tri1_ref[2]));
-  ASSERT(um2::isApprox(tri1[3], tri1_ref[3]));
-  ASSERT(um2::isApprox(tri1[4], tri1_ref[4]));
-  ASSERT(um2::isApprox(tri1[5], tri1_ref[5]));
+  for (Int i = 0; i < 6; ++i) {
+    ASSERT(tri1[i].isApprox(tri1_ref[i]));
+  }
 }
 
 TEST_CASE(addVertex_addFace)
@@ -42,34 +49,24 @@ TEST_CASE(addVertex_addFace)
   mesh.addVertex({0, 0});
   mesh.addVertex({1, 0});
   mesh.addVertex({0, 1});
-  mesh.addVertex({condCast<F>(0.5), condCast<F>(0.0)});
-  mesh.addVertex({condCast<F>(0.7), condCast<F>(0.5)});
-  mesh.addVertex({condCast<F>(0.0), condCast<F>(0.5)});
+  mesh.addVertex({castIfNot<Float>(0.5), castIfNot<Float>(0.0)});
+  mesh.addVertex({castIfNot<Float>(0.7), castIfNot<Float>(0.5)});
+  mesh.addVertex({castIfNot<Float>(0.0), castIfNot<Float>(0.5)});
   mesh.addVertex({1, 1});
-  mesh.addVertex({condCast<F>(1.0), condCast<F>(0.5)});
-  mesh.addVertex({condCast<F>(0.5), condCast<F>(1.0)});
+  mesh.addVertex({castIfNot<Float>(1.0), castIfNot<Float>(0.5)});
+  mesh.addVertex({castIfNot<Float>(0.5), castIfNot<Float>(1.0)});
   mesh.addFace({0, 1, 2, 3, 4, 5});
   mesh.addFace({1, 6, 2, 7, 8, 4});
-  um2::QuadraticTriangle2 tri0_ref(mesh.getVertex(0), mesh.getVertex(1),
-                                   mesh.getVertex(2), mesh.getVertex(3),
-                                   mesh.getVertex(4), mesh.getVertex(5));
-  auto const tri0 = mesh.getFace(0);
-  ASSERT(um2::isApprox(tri0[0], tri0_ref[0]));
-  ASSERT(um2::isApprox(tri0[1], tri0_ref[1]));
-  ASSERT(um2::isApprox(tri0[2], tri0_ref[2]));
-  ASSERT(um2::isApprox(tri0[3], tri0_ref[3]));
-  ASSERT(um2::isApprox(tri0[4], tri0_ref[4]));
-  ASSERT(um2::isApprox(tri0[5], tri0_ref[5]));
-  um2::QuadraticTriangle2 tri1_ref(mesh.getVertex(1), mesh.getVertex(6),
-                                   mesh.getVertex(2), mesh.getVertex(7),
-                                   mesh.getVertex(8), mesh.getVertex(4));
-  auto const tri1 = mesh.getFace(1);
-  ASSERT(um2::isApprox(tri1[0], tri1_ref[0]));
-  ASSERT(um2::isApprox(tri1[1], tri1_ref[1]));
-  ASSERT(um2::isApprox(tri1[2], tri1_ref[2]));
-  ASSERT(um2::isApprox(tri1[3], tri1_ref[3]));
-  ASSERT(um2::isApprox(tri1[4], tri1_ref[4]));
-  ASSERT(um2::isApprox(tri1[5], tri1_ref[5]));
+  um2::Tri6FVM const mesh_ref = makeTri6ReferenceMesh();
+  ASSERT(mesh.numVertices() == mesh_ref.numVertices());
+  ASSERT(mesh.numFaces() == mesh_ref.numFaces());
+  for (Int iface = 0; iface < mesh.numFaces(); ++iface) {
+    auto const face = mesh.getFace(iface);
+    auto const face_ref = mesh_ref.getFace(iface);
+    for (Int i = 0; i < 6; ++i) {
+      ASSERT(face[i].isApprox(face_ref[i]));
+    }
+  }
 }
 
 TEST_CASE(poly_soup_constructor)
@@ -79,14 +76,14 @@ TEST_CASE(poly_soup_constructor)
   um2::Tri6FVM const mesh_ref = makeTri6ReferenceMesh();
   um2::Tri6FVM const mesh(poly_soup);
   ASSERT(mesh.numVertices() == mesh_ref.numVertices());
-  for (I i = 0; i < mesh.numVertices(); ++i) {
-    ASSERT(um2::isApprox(mesh.getVertex(i), mesh_ref.getVertex(i)));
+  for (Int i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(mesh.getVertex(i).isApprox(mesh_ref.getVertex(i)));
   }
-  for (I i = 0; i < mesh.numFaces(); ++i) {
+  for (Int i = 0; i < mesh.numFaces(); ++i) {
     auto const face = mesh.getFace(i);
     auto const face_ref = mesh_ref.getFace(i);
-    for (I j = 0; j < 6; ++j) {
-      ASSERT(um2::isApprox(face[j], face_ref[j]));
+    for (Int j = 0; j < 6; ++j) {
+      ASSERT(face[j].isApprox(face_ref[j]));
     }
   }
 }
@@ -95,29 +92,52 @@ TEST_CASE(boundingBox)
 {
   um2::Tri6FVM const mesh = makeTri6ReferenceMesh();
   auto const box = mesh.boundingBox();
-  ASSERT_NEAR(box.xMin(), condCast<F>(0), eps);
-  ASSERT_NEAR(box.xMax(), condCast<F>(1), eps);
-  ASSERT_NEAR(box.yMin(), condCast<F>(0), eps);
-  ASSERT_NEAR(box.yMax(), condCast<F>(1), eps);
+  ASSERT_NEAR(box.minima()[0], castIfNot<Float>(0), eps);
+  ASSERT_NEAR(box.maxima()[0], castIfNot<Float>(1), eps);
+  ASSERT_NEAR(box.minima()[1], castIfNot<Float>(0), eps);
+  ASSERT_NEAR(box.maxima()[1], castIfNot<Float>(1), eps);
 }
 
 TEST_CASE(faceContaining)
 {
   um2::Tri6FVM const mesh = makeTri6ReferenceMesh();
-  um2::Point2 p(condCast<F>(0.6), condCast<F>(0.5));
+  um2::Point2F p(castIfNot<Float>(0.6), castIfNot<Float>(0.5));
   ASSERT(mesh.faceContaining(p) == 0);
-  p = um2::Point2(condCast<F>(0.8), condCast<F>(0.5));
+  p = um2::Point2F(castIfNot<Float>(0.8), castIfNot<Float>(0.5));
   ASSERT(mesh.faceContaining(p) == 1);
 }
 
+TEST_CASE(validateSelfIntersections)
+{
+  // A quadratic triangle with a nearly straight edge which intersects a curved
+  // edge. Constructing the mesh validates it, which should perturb the midpoint
+  // of the curved edge to repair it without changing the bounding box.
+  um2::Vector<um2::Point2F> const v = {
+      {castIfNot<Float>(3.90250), castIfNot<Float>(1.93887)},
+      {castIfNot<Float>(3.90250), castIfNot<Float>(1.95125)},
+      {castIfNot<Float>(3.75839), castIfNot<Float>(1.85233)},
+      {castIfNot<Float>(3.90250), castIfNot<Float>(1.94506)},
+      {castIfNot<Float>(3.83044), castIfNot<Float>(1.90179)},
+      {castIfNot<Float>(3.82672), castIfNot<Float>(1.90180)}
+  };
+  um2::Vector<um2::Vec<6, Int>> const fv = {
+      {0, 1, 2, 3, 4, 5}
+  };
+  um2::QuadraticTriangle2F const tri(v[0], v[1], v[2], v[3], v[4], v[5]);
+  ASSERT(tri.hasSelfIntersection());
+  um2::Tri6FVM const mesh(v, fv);
+  ASSERT(!mesh.getFace(0).hasSelfIntersection());
+  ASSERT(tri.boundingBox().isApprox(mesh.boundingBox()));
+}
+
 TEST_CASE(populateVF)
 {
   um2::Tri6FVM mesh = makeTri6ReferenceMesh();
   ASSERT(mesh.vertexFaceOffsets().empty());
   ASSERT(mesh.vertexFaceConn().empty());
   mesh.populateVF();
-  um2::Vector<I> const vf_offsets_ref = {0, 1, 3, 5, 6, 8, 9, 10, 11, 12};
-  um2::Vector<I> const vf_ref = {0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 1, 1};
+  um2::Vector<Int> const vf_offsets_ref = {0, 1, 3, 5, 6, 8, 9, 10, 11, 12};
+  um2::Vector<Int> const vf_ref = {0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 1, 1};
   ASSERT(mesh.vertexFaceOffsets() == vf_offsets_ref);
   ASSERT(mesh.vertexFaceConn() == vf_ref);
 }
@@ -125,32 +145,66 @@ TEST_CASE(populateVF)
 TEST_CASE(intersect)
 {
   um2::Tri6FVM const mesh = makeTri6ReferenceMesh();
-  um2::Point2 const origin(0, 0);
-  um2::Vec2<F> direction(condCast<F>(0.7), condCast<F>(0.5));
+  um2::Point2F const origin(0, 0);
+  um2::Vec2F direction(castIfNot<Float>(0.7), castIfNot<Float>(0.5));
   direction.normalize();
-  um2::Ray2 const ray(origin, direction);
-  um2::Vector<F> intersections;
-  mesh.intersect(ray, intersections);
-  ASSERT(intersections.size() == 5);
-  F const it1 = um2::sqrt(condCast<F>(0.74));
-  F const it2 = 1 / (condCast<F>(0.7) / it1);
-  ASSERT_NEAR(intersections[0], 0, eps);
-  ASSERT_NEAR(intersections[1], 0, eps);
-  ASSERT_NEAR(intersections[2], it1, eps);
-  ASSERT_NEAR(intersections[3], it1, eps);
-  ASSERT_NEAR(intersections[4], it2, eps);
+  um2::Ray2F const ray(origin, direction);
+  Float coords[24];
+  Int const hits = mesh.intersect(ray, coords);
+  std::sort(coords, coords + hits);
+  ASSERT(hits == 5);
+  Float const it1 = um2::sqrt(castIfNot<Float>(0.74));
+  Float const it2 = 1 / (castIfNot<Float>(0.7) / it1);
+  ASSERT_NEAR(coords[0], 0, eps);
+  ASSERT_NEAR(coords[1], 0, eps);
+  ASSERT_NEAR(coords[2], it1, eps);
+  ASSERT_NEAR(coords[3], it1, eps);
+  ASSERT_NEAR(coords[4], it2, eps);
 }
 
-// TEST_CASE(toPolytopeSoup)
-//{
-//   um2::Tri6FVM const quad_mesh = makeTri6ReferenceMesh();
-//   um2::PolytopeSoup quad_poly_soup_ref;
-//   makeReferenceTri6PolytopeSoup(quad_poly_soup_ref);
-//   um2::PolytopeSoup quad_poly_soup;
-//   quad_mesh.toPolytopeSoup(quad_poly_soup);
-//   ASSERT(quad_poly_soup.compareTo(quad_poly_soup_ref) == 10);
-//   ASSERT(quad_poly_soup.getMeshType() == um2::MeshType::QuadraticTri);
-// }
+TEST_CASE(populateEdgeCache)
+{
+  // The reference mesh has both straight and curved edges. Intersecting with
+  // the edge cache must find the same faces, at the same coordinates up to
+  // the linear approximation of the straight edges.
+  um2::Tri6FVM const mesh = makeTri6ReferenceMesh();
+  um2::Tri6FVM mesh_cache = mesh;
+  mesh_cache.populateEdgeCache();
+
+  Int constexpr buffer_size = 16;
+  Float coords[buffer_size];
+  Int offsets[buffer_size];
+  Int faces[buffer_size];
+  Float coords_cache[buffer_size];
+  Int offsets_cache[buffer_size];
+  Int faces_cache[buffer_size];
+  Int constexpr num_angles = 16;
+  Int constexpr num_rays = 32;
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    Float const angle = um2::pi<Float> * (castIfNot<Float>(ia) + castIfNot<Float>(0.5)) /
+                        castIfNot<Float>(num_angles);
+    um2::Vec2F const dir(um2::cos(angle), um2::sin(angle));
+    for (Int ir = 0; ir < num_rays; ++ir) {
+      Float const x = castIfNot<Float>(-2) +
+                      castIfNot<Float>(5 * ir) / castIfNot<Float>(num_rays);
+      um2::Ray2F const ray(um2::Point2F(x, castIfNot<Float>(-1)), dir);
+      Int const hits = mesh.intersect(ray, coords);
+      Int const hits_cache = mesh_cache.intersect(ray, coords_cache);
+      ASSERT(hits == hits_cache);
+      auto const hits_faces = mesh.intersect(ray, coords, offsets, faces);
+      auto const hits_faces_cache =
+          mesh_cache.intersect(ray, coords_cache, offsets_cache, faces_cache);
+      ASSERT(hits_faces == hits_faces_cache);
+      for (Int i = 0; i < hits_faces[0]; ++i) {
+        ASSERT_NEAR(coords[i], coords_cache[i], um2::epsDistance<Float>());
+      }
+      for (Int i = 0; i < hits_faces[1]; ++i) {
+        ASSERT(offsets[i + 1] == offsets_cache[i + 1]);
+        ASSERT(faces[i] == faces_cache[i]);
+      }
+    }
+  }
+}
 
 #if UM2_USE_CUDA
 MAKE_CUDA_KERNEL(accessors)
@@ -163,10 +217,10 @@ TEST_SUITE(Tri6FVM)
   TEST(poly_soup_constructor);
   TEST(boundingBox);
   TEST(faceContaining);
+  TEST(validateSelfIntersections);
   TEST(populateVF);
   TEST(intersect);
-
-  //  TEST((toPolytopeSoup));
+  TEST(populateEdgeCache);
 }
 
 auto
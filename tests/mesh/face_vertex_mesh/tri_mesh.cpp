@@ -1,13 +1,19 @@
 #include <um2/common/cast_if_not.hpp>
 #include <um2/common/logger.hpp>
+#include <um2/common/settings.hpp>
 #include <um2/config.hpp>
 #include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
 #include <um2/geometry/point.hpp>
 #include <um2/geometry/polytope.hpp>
 #include <um2/geometry/ray.hpp>
+#include <um2/math/hilbert.hpp>
 #include <um2/math/vec.hpp>
 #include <um2/mesh/face_vertex_mesh.hpp>
 #include <um2/mesh/polytope_soup.hpp>
+#include <um2/stdlib/math/roots.hpp>
+#include <um2/stdlib/math/trigonometric_functions.hpp>
+#include <um2/stdlib/numbers.hpp>
 #include <um2/stdlib/string_view.hpp>
 #include <um2/stdlib/vector.hpp>
 
@@ -198,9 +204,17 @@ TEST_CASE(faceContaining)
     um2::TriFVM mesh2;
     makeTriangleMesh(mesh2, ntri);
     perturb(mesh2); // maximum perturbation is 0.1
+    // The BVH and the walk from a hint face must agree with the linear search.
+    um2::TriFVM indexed = mesh2;
+    indexed.populateBVH();
+    indexed.populateFF();
+    Int hint = 0;
     for (Int i = 0; i < npoints; ++i) {
       um2::Point2F const pt(dis(gen), dis(gen));
       Int const iface = mesh2.faceContaining(pt);
+      ASSERT(indexed.faceContaining(pt) == iface);
+      ASSERT(indexed.faceContaining(pt, hint) == iface);
+      hint = iface;
       if (iface == -1) {
         ASSERT(!box.contains(pt));
       } else {
@@ -215,6 +229,31 @@ TEST_CASE(faceContaining)
   }
 }
 
+// The bulk face properties must match the per-face Polygon functions exactly.
+TEST_CASE(faceProperties)
+{
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, 8);
+  perturb(mesh);
+  Int const num_faces = mesh.numFaces();
+  um2::Vector<Float> areas(num_faces);
+  um2::Vector<um2::Point2F> centroids(num_faces);
+  um2::Vector<um2::AxisAlignedBox2F> boxes(num_faces);
+  um2::Vector<Float> mcls(num_faces);
+  mesh.faceAreas(areas.data());
+  mesh.faceCentroids(centroids.data());
+  mesh.faceBoundingBoxes(boxes.data());
+  mesh.faceMeanChordLengths(mcls.data());
+  for (Int i = 0; i < num_faces; ++i) {
+    auto const face = mesh.getFace(i);
+    ASSERT_NEAR(areas[i], face.area(), eps);
+    ASSERT_NEAR(centroids[i][0], face.centroid()[0], eps);
+    ASSERT_NEAR(centroids[i][1], face.centroid()[1], eps);
+    ASSERT(boxes[i].isApprox(face.boundingBox()));
+    ASSERT_NEAR(mcls[i], face.meanChordLength(), eps);
+  }
+}
+
 TEST_CASE(validate)
 {
   // Check that clockwise faces are fixed
@@ -323,6 +362,26 @@ TEST_CASE(validate)
   mesh2.validate();
   sv = um2::logger::getLastMessage();
   ASSERT(sv.find_first_of("Mesh has a hole in its interior") != um2::StringView::npos);
+
+  // Mesh with overlapping faces
+  // 2 ---- 3
+  // | \    |
+  // |    \ |
+  // 0 ---- 1
+  // F0 = {0, 1, 2}
+  // F1 = {1, 3, 2}
+  // F2 = {0, 1, 3} <- overlaps F0 and F1
+  um2::TriFVM mesh3;
+  mesh3.addVertex({0, 0});
+  mesh3.addVertex({1, 0});
+  mesh3.addVertex({0, 1});
+  mesh3.addVertex({1, 1});
+  mesh3.addFace({0, 1, 2});
+  mesh3.addFace({1, 3, 2});
+  mesh3.addFace({0, 1, 3});
+  mesh3.validate();
+  sv = um2::logger::getLastMessage();
+  ASSERT(sv.find_first_of("Mesh has overlapping faces") != um2::StringView::npos);
   um2::logger::exit_on_error = true;
 }
 
@@ -436,6 +495,31 @@ TEST_CASE(mortonSortFaces)
   mesh.validate();
 }
 
+TEST_CASE(hilbertSortFaces)
+{
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, 4);
+  um2::TriFVM const original = mesh;
+  auto const perm = mesh.spaceFillingCurveSortFaces(um2::SpaceFillingCurve::Hilbert);
+  ASSERT(perm.size() == mesh.numFaces());
+  // The i-th face after sorting is face perm[i] before sorting.
+  for (Int i = 0; i < mesh.numFaces(); ++i) {
+    ASSERT(mesh.getFaceConn(i) == original.getFaceConn(perm[i]));
+  }
+  // The centroids are in Hilbert order.
+  auto const box = mesh.boundingBox();
+  um2::Vec2F const inv_scale = 1 / box.extents();
+  using Key = um2::MortonKey<Float>;
+  Key prev = 0;
+  for (Int i = 0; i < mesh.numFaces(); ++i) {
+    um2::Point2F const p = (mesh.getFace(i).centroid() - box.minima()) * inv_scale;
+    Key const key = um2::hilbertEncode<Key, Float>(p[0], p[1]);
+    ASSERT(prev <= key);
+    prev = key;
+  }
+  mesh.validate();
+}
+
 TEST_CASE(intersect)
 {
   um2::TriFVM mesh;
@@ -535,6 +619,211 @@ TEST_CASE(intersect)
   ASSERT_NEAR(sorted_coords[7], castIfNot<Float>(3.0), eps);
 }
 
+TEST_CASE(populateBVH)
+{
+  // The BVH accelerated intersection must produce exactly the same output as
+  // the brute-force search.
+  Int constexpr n = 16;
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, n);
+  perturb(mesh);
+  mesh.mortonSort();
+  um2::TriFVM mesh_bvh = mesh;
+  mesh_bvh.populateBVH(4);
+
+  Int constexpr buffer_size = 16 * n;
+  Float coords[buffer_size];
+  Int offsets[buffer_size];
+  Int faces[buffer_size];
+  Float coords_bvh[buffer_size];
+  Int offsets_bvh[buffer_size];
+  Int faces_bvh[buffer_size];
+  Int constexpr num_angles = 16;
+  Int constexpr num_rays = 32;
+  auto const box = mesh.boundingBox();
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    // Avoid the axis-aligned angles
+    Float const angle = um2::pi<Float> * (castIfNot<Float>(ia) + castIfNot<Float>(0.5)) /
+                        castIfNot<Float>(num_angles);
+    um2::Vec2F const dir(um2::cos(angle), um2::sin(angle));
+    for (Int ir = 0; ir < num_rays; ++ir) {
+      // Start the rays along a line below the mesh
+      Float const x = box.minima(0) - castIfNot<Float>(n) +
+                      castIfNot<Float>(3 * n * ir) / castIfNot<Float>(num_rays);
+      um2::Ray2F const ray(um2::Point2F(x, box.minima(1) - 1), dir);
+      Int const hits = mesh.intersect(ray, coords);
+      Int const hits_bvh = mesh_bvh.intersect(ray, coords_bvh);
+      ASSERT(hits == hits_bvh);
+      for (Int i = 0; i < hits; ++i) {
+        ASSERT_NEAR(coords[i], coords_bvh[i], 0);
+      }
+      auto const hits_faces = mesh.intersect(ray, coords, offsets, faces);
+      auto const hits_faces_bvh = mesh_bvh.intersect(ray, coords_bvh, offsets_bvh, faces_bvh);
+      ASSERT(hits_faces == hits_faces_bvh);
+      for (Int i = 0; i < hits_faces[0]; ++i) {
+        ASSERT_NEAR(coords[i], coords_bvh[i], 0);
+      }
+      for (Int i = 0; i < hits_faces[1]; ++i) {
+        ASSERT(offsets[i + 1] == offsets_bvh[i + 1]);
+        ASSERT(faces[i] == faces_bvh[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE(populateFF)
+{
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, 2);
+  mesh.populateFF();
+  // 6------7------8
+  // |\   5 |\   7 |
+  // |  \   |  \   |
+  // | 4  \ | 6  \ |
+  // 3------4------5
+  // |\   1 |\   3 |
+  // |  \   |  \   |
+  // | 0  \ | 2  \ |
+  // 0------1------2
+  // Face 0 = {0, 1, 3}, face 1 = {4, 3, 1}
+  ASSERT(mesh.getAdjacentFace(0, 0) == um2::Vec2I(-1, -1));
+  ASSERT(mesh.getAdjacentFace(0, 1) == um2::Vec2I(1, 1));
+  ASSERT(mesh.getAdjacentFace(0, 2) == um2::Vec2I(-1, -1));
+  ASSERT(mesh.getAdjacentFace(1, 0) == um2::Vec2I(4, 0));
+  ASSERT(mesh.getAdjacentFace(1, 1) == um2::Vec2I(0, 1));
+  ASSERT(mesh.getAdjacentFace(1, 2) == um2::Vec2I(2, 2));
+  // Each adjacency is symmetric
+  Int constexpr num_edges = 3;
+  for (Int iface = 0; iface < mesh.numFaces(); ++iface) {
+    for (Int iedge = 0; iedge < num_edges; ++iedge) {
+      auto const adj = mesh.getAdjacentFace(iface, iedge);
+      if (adj[0] != -1) {
+        ASSERT(mesh.getAdjacentFace(adj[0], adj[1]) == um2::Vec2I(iface, iedge));
+      }
+    }
+  }
+}
+
+TEST_CASE(intersectWalk)
+{
+  // The walk must visit the same faces as the sorted brute-force search.
+  Int constexpr n = 8;
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, n);
+  perturb(mesh);
+  mesh.populateFF();
+
+  Int constexpr buffer_size = 16 * n;
+  Float coords[buffer_size];
+  Int offsets[buffer_size];
+  Int faces[buffer_size];
+  Float sorted_coords[buffer_size];
+  Int sorted_offsets[buffer_size];
+  Int sorted_faces[buffer_size];
+  Int perm[buffer_size];
+  Float walk_coords[buffer_size];
+  Int walk_offsets[buffer_size];
+  Int walk_faces[buffer_size];
+  Int constexpr num_angles = 8;
+  Int constexpr num_rays = 16;
+  auto const box = mesh.boundingBox();
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    Float const angle = um2::pi<Float> * (castIfNot<Float>(ia) + castIfNot<Float>(0.5)) /
+                        castIfNot<Float>(num_angles);
+    um2::Vec2F const dir(um2::cos(angle), um2::sin(angle));
+    for (Int ir = 0; ir < num_rays; ++ir) {
+      Float const x = box.minima(0) - castIfNot<Float>(n) +
+                      castIfNot<Float>(3 * n * ir) / castIfNot<Float>(num_rays);
+      um2::Ray2F const ray(um2::Point2F(x, box.minima(1) - 1), dir);
+      auto const hits_faces = mesh.intersect(ray, coords, offsets, faces);
+      um2::sortRayMeshIntersections(coords, offsets, faces, sorted_coords,
+                                    sorted_offsets, sorted_faces, perm, hits_faces);
+      auto const walk_hits_faces =
+          mesh.intersectWalk(ray, walk_coords, walk_offsets, walk_faces);
+      ASSERT(walk_hits_faces == hits_faces);
+      for (Int i = 0; i < hits_faces[1]; ++i) {
+        ASSERT(walk_faces[i] == sorted_faces[i]);
+        ASSERT(walk_offsets[i + 1] == sorted_offsets[i + 1]);
+      }
+      for (Int i = 0; i < hits_faces[0]; ++i) {
+        ASSERT_NEAR(walk_coords[i], sorted_coords[i], eps);
+      }
+    }
+  }
+
+  // Rays through the vertices of an unperturbed mesh must still traverse the
+  // whole mesh.
+  um2::TriFVM grid;
+  makeTriangleMesh(grid, n);
+  grid.populateFF();
+  um2::Vec2F const diag(castIfNot<Float>(1), castIfNot<Float>(1));
+  um2::Ray2F const ray(um2::Point2F(-1, -1), diag.normalized());
+  auto const walk_hits_faces =
+      grid.intersectWalk(ray, walk_coords, walk_offsets, walk_faces);
+  ASSERT(walk_hits_faces[1] > 0);
+  Float const length =
+      walk_coords[walk_hits_faces[0] - 1] - walk_coords[0];
+  ASSERT_NEAR(length, um2::sqrt(castIfNot<Float>(2)) * castIfNot<Float>(n), eps);
+  for (Int i = 1; i < walk_hits_faces[0] - 1; i += 2) {
+    ASSERT_NEAR(walk_coords[i], walk_coords[i + 1], eps);
+  }
+}
+
+TEST_CASE(intersect_batch)
+{
+  // The batch intersection must produce exactly the same output as
+  // intersecting and sorting each ray serially.
+  Int constexpr n = 16;
+  um2::TriFVM mesh;
+  makeTriangleMesh(mesh, n);
+  perturb(mesh);
+  mesh.mortonSort();
+  mesh.populateBVH();
+
+  Int constexpr num_angles = 8;
+  Int constexpr num_rays = 64;
+  auto const box = mesh.boundingBox();
+  um2::Vector<um2::Ray2F> rays;
+  for (Int ia = 0; ia < num_angles; ++ia) {
+    Float const angle = um2::pi<Float> * (castIfNot<Float>(ia) + castIfNot<Float>(0.5)) /
+                        castIfNot<Float>(num_angles);
+    um2::Vec2F const dir(um2::cos(angle), um2::sin(angle));
+    for (Int ir = 0; ir < num_rays; ++ir) {
+      Float const x = box.minima(0) - castIfNot<Float>(n) +
+                      castIfNot<Float>(3 * n * ir) / castIfNot<Float>(num_rays);
+      rays.emplace_back(um2::Point2F(x, box.minima(1) - 1), dir);
+    }
+  }
+  um2::RayMeshIntersections batch;
+  mesh.intersect(rays, batch);
+  ASSERT(batch.numRays() == rays.size());
+
+  Int constexpr buffer_size = 16 * n;
+  Float coords[buffer_size];
+  Int offsets[buffer_size];
+  Int faces[buffer_size];
+  Float sorted_coords[buffer_size];
+  Int sorted_offsets[buffer_size];
+  Int sorted_faces[buffer_size];
+  Int perm[buffer_size];
+  for (Int iray = 0; iray < rays.size(); ++iray) {
+    auto const hits_faces = mesh.intersect(rays[iray], coords, offsets, faces);
+    um2::sortRayMeshIntersections(coords, offsets, faces, sorted_coords,
+                                  sorted_offsets, sorted_faces, perm, hits_faces);
+    Int const first = batch.ray_offsets[iray];
+    ASSERT(batch.ray_offsets[iray + 1] - first == hits_faces[1]);
+    for (Int i = 0; i < hits_faces[1]; ++i) {
+      ASSERT(batch.faces[first + i] == sorted_faces[i]);
+      Int const c0 = batch.coord_offsets[first + i];
+      Int const c1 = batch.coord_offsets[first + i + 1];
+      ASSERT(c1 - c0 == sorted_offsets[i + 1] - sorted_offsets[i]);
+      for (Int j = 0; j < c1 - c0; ++j) {
+        ASSERT_NEAR(batch.coords[c0 + j], sorted_coords[sorted_offsets[i] + j], 0);
+      }
+    }
+  }
+}
+
 TEST_CASE(operator_PolytopeSoup)
 {
   um2::TriFVM const tri_mesh = makeTriReferenceMesh();
@@ -561,6 +850,15 @@ TEST_CASE(PolytopeSoup_constructor)
       ASSERT(face[j].isApprox(face_ref[j]));
     }
   }
+
+  // Construct from an rvalue, which empties the soup
+  um2::TriFVM const moved_mesh(um2::move(soup));
+  ASSERT(soup.numVertices() == 0);
+  ASSERT(soup.numElements() == 0);
+  for (Int i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(moved_mesh.getVertex(i).isApprox(mesh.getVertex(i)));
+  }
+  ASSERT(moved_mesh.faceVertexConn() == mesh.faceVertexConn());
 }
 
 TEST_SUITE(TriFVM)
@@ -569,11 +867,17 @@ TEST_SUITE(TriFVM)
   TEST(addVertex_addFace);
   TEST(boundingBox);
   TEST(faceContaining);
+  TEST(faceProperties);
   TEST(validate);
   TEST(populateVF);
   TEST(mortonSortVertices);
   TEST(mortonSortFaces);
+  TEST(hilbertSortFaces);
   TEST(intersect);
+  TEST(populateBVH);
+  TEST(populateFF);
+  TEST(intersectWalk);
+  TEST(intersect_batch);
   TEST(operator_PolytopeSoup);
   TEST(PolytopeSoup_constructor);
 }
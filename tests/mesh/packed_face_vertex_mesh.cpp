@@ -0,0 +1,107 @@
+#include <um2/common/cast_if_not.hpp>
+#include <um2/config.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/geometry/point.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/face_vertex_mesh.hpp>
+#include <um2/mesh/packed_face_vertex_mesh.hpp>
+#include <um2/stdlib/math/trigonometric_functions.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include "./helpers/setup_mesh.hpp"
+
+#include "../test_macros.hpp"
+
+// The packed mesh must reproduce the faces of the original mesh exactly. The
+// bulk operations must match the per-face Polygon functions up to rounding,
+// since the compiler may contract the operations differently.
+template <Int P, Int N>
+void
+testPacked(um2::FaceVertexMesh<P, N> const & mesh)
+{
+  um2::PackedFaceVertexMesh<P, N> const packed(mesh);
+  Int const num_faces = mesh.numFaces();
+  ASSERT(packed.numFaces() == num_faces);
+  for (Int i = 0; i < num_faces; ++i) {
+    auto const face = mesh.getFace(i);
+    auto const packed_face = packed.getFace(i);
+    for (Int j = 0; j < N; ++j) {
+      for (Int d = 0; d < 2; ++d) {
+        ASSERT_NEAR(packed_face[j][d], face[j][d], 0);
+        ASSERT_NEAR(packed.getVertex(i, j)[d], face[j][d], 0);
+      }
+      ASSERT_NEAR(packed.x(j)[i], face[j][0], 0);
+      ASSERT_NEAR(packed.y(j)[i], face[j][1], 0);
+    }
+  }
+
+  ASSERT(packed.boundingBox().isApprox(mesh.boundingBox()));
+
+  um2::Vector<Float> areas(num_faces);
+  um2::Vector<um2::Point2F> centroids(num_faces);
+  um2::Vector<um2::AxisAlignedBox2F> boxes(num_faces);
+  um2::Vector<Float> mcls(num_faces);
+  packed.faceAreas(areas.data());
+  packed.faceCentroids(centroids.data());
+  packed.faceBoundingBoxes(boxes.data());
+  packed.faceMeanChordLengths(mcls.data());
+  auto constexpr eps = um2::epsDistance<Float>();
+  for (Int i = 0; i < num_faces; ++i) {
+    auto const face = mesh.getFace(i);
+    ASSERT_NEAR(areas[i], face.area(), eps);
+    ASSERT_NEAR(centroids[i][0], face.centroid()[0], eps);
+    ASSERT_NEAR(centroids[i][1], face.centroid()[1], eps);
+    ASSERT(boxes[i].isApprox(face.boundingBox()));
+    ASSERT_NEAR(mcls[i], face.meanChordLength(), eps);
+  }
+}
+
+TEST_CASE(triMesh) { testPacked(makeTriReferenceMesh()); }
+
+TEST_CASE(quadMesh) { testPacked(makeQuadReferenceMesh()); }
+
+TEST_CASE(tri6Mesh) { testPacked(makeTri6ReferenceMesh()); }
+
+TEST_CASE(quad8Mesh) { testPacked(makeQuad8ReferenceMesh()); }
+
+// An n by n grid of perturbed quadrilaterals, with more faces than the block
+// of faces processed at once by faceBoundingBoxes.
+TEST_CASE(quadGrid)
+{
+  Int constexpr n = 12;
+  auto constexpr delta = castIfNot<Float>(0.2);
+  um2::Vector<um2::Point2F> vertices;
+  for (Int i = 0; i < n + 1; ++i) {
+    for (Int j = 0; j < n + 1; ++j) {
+      // A deterministic perturbation which keeps the quadrilaterals convex
+      Float const dx = delta * um2::sin(castIfNot<Float>(3 * i + 7 * j));
+      Float const dy = delta * um2::cos(castIfNot<Float>(5 * i + 2 * j));
+      vertices.emplace_back(castIfNot<Float>(j) + dx, castIfNot<Float>(i) + dy);
+    }
+  }
+  um2::Vector<um2::Vec<4, Int>> faces;
+  for (Int i = 0; i < n; ++i) {
+    for (Int j = 0; j < n; ++j) {
+      Int const v0 = i * (n + 1) + j;
+      faces.emplace_back(v0, v0 + 1, v0 + n + 2, v0 + n + 1);
+    }
+  }
+  um2::QuadFVM const mesh(vertices, faces);
+  testPacked(mesh);
+}
+
+TEST_SUITE(PackedFaceVertexMesh)
+{
+  TEST(triMesh);
+  TEST(quadMesh);
+  TEST(tri6Mesh);
+  TEST(quad8Mesh);
+  TEST(quadGrid);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(PackedFaceVertexMesh);
+  return 0;
+}
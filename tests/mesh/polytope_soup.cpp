@@ -54,6 +54,36 @@ TEST_CASE(addElement)
   ASSERT(conn == conn_ref);
 }
 
+TEST_CASE(addVertices_addElements)
+{
+  um2::PolytopeSoup soup;
+  um2::Vector<um2::Point2F> const vertices2 = {
+      {0, 0},
+      {1, 0}
+  };
+  um2::Vector<um2::Point3F> const vertices3 = {
+      {0, 1, 0},
+      {1, 1, 0}
+  };
+  ASSERT(soup.addVertices(vertices2) == 0);
+  ASSERT(soup.addVertices(vertices3) == 2);
+  ASSERT(soup.numVertices() == 4);
+  ASSERT(soup.getVertex(1).isApprox(um2::Point3F(1, 0, 0)));
+  ASSERT(soup.getVertex(3).isApprox(um2::Point3F(1, 1, 0)));
+
+  // Bulk elements after a single element match adding them one at a time
+  um2::PolytopeSoup ref;
+  ref.addVertices(vertices2);
+  ref.addVertices(vertices3);
+  ref.addElement(um2::VTKElemType::Line, {0, 1});
+  ref.addElement(um2::VTKElemType::Triangle, {0, 1, 3});
+  ref.addElement(um2::VTKElemType::Triangle, {0, 3, 2});
+  ASSERT(soup.addElement(um2::VTKElemType::Line, {0, 1}) == 0);
+  ASSERT(soup.addElements(um2::VTKElemType::Triangle, {0, 1, 3, 0, 3, 2}) == 1);
+  ASSERT(soup.compare(ref) == 0);
+  ASSERT(soup.elementOffsets() == ref.elementOffsets());
+}
+
 TEST_CASE(addElset)
 {
   um2::PolytopeSoup soup;
@@ -188,6 +218,29 @@ TEST_CASE(getSubset)
   ASSERT(elset_data.empty());
 }
 
+TEST_CASE(partitionByElsetPrefix)
+{
+  um2::PolytopeSoup tri_quad;
+  makeReferenceTriQuadPolytopeSoup(tri_quad);
+  ASSERT(tri_quad.getElsetIndex("A") == 0);
+  ASSERT(tri_quad.getElsetIndex("Material_UO2") == 3);
+  ASSERT(tri_quad.getElsetIndex("C") == -1);
+
+  um2::Vector<um2::String> names;
+  um2::Vector<um2::PolytopeSoup> subsets;
+  tri_quad.partitionByElsetPrefix("Material_", names, subsets);
+  ASSERT(names.size() == 2);
+  ASSERT(subsets.size() == 2);
+  ASSERT(names[0] == "Material_H2O");
+  ASSERT(names[1] == "Material_UO2");
+  for (Int i = 0; i < names.size(); ++i) {
+    um2::PolytopeSoup subset;
+    tri_quad.getSubset(names[i], subset);
+    ASSERT(subset.compare(subsets[i]) == 0);
+    ASSERT(subsets[i].getElsetIndex("A") == subset.getElsetIndex("A"));
+  }
+}
+
 TEST_CASE(operator_plus_equal)
 {
   um2::PolytopeSoup soup;
@@ -703,9 +756,11 @@ TEST_SUITE(PolytopeSoup)
 {
   TEST(addVertex);
   TEST(addElement);
+  TEST(addVertices_addElements);
   TEST(addElset);
   TEST(sortElsets);
   TEST(getSubset);
+  TEST(partitionByElsetPrefix);
   TEST(operator_plus_equal);
   TEST(io_abaqus_tri_mesh);
   TEST(io_abaqus_quad_mesh);
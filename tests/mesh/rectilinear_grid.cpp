@@ -1,3 +1,4 @@
+#include <um2/common/cast_if_not.hpp>
 #include <um2/config.hpp>
 #include <um2/geometry/axis_aligned_box.hpp>
 #include <um2/geometry/point.hpp>
@@ -180,6 +181,32 @@ TEST_CASE(id_array_constructor)
   }
 }
 
+template <class T>
+HOSTDEV
+TEST_CASE(getCellIndexContaining)
+{
+  um2::RectilinearGrid2<T> grid;
+  grid.divs(0) = {1.0, 1.5, 2.0, 2.5, 3.0};
+  grid.divs(1) = {-1.0, -0.75, 0.5, 1.0};
+  auto id = grid.getCellIndexContaining({castIfNot<T>(1.1), castIfNot<T>(-0.9)});
+  ASSERT(id[0] == 0);
+  ASSERT(id[1] == 0);
+  id = grid.getCellIndexContaining({castIfNot<T>(2.6), castIfNot<T>(0)});
+  ASSERT(id[0] == 3);
+  ASSERT(id[1] == 1);
+  // Interior boundaries belong to the upper cell, the maximum to the last cell.
+  id = grid.getCellIndexContaining({castIfNot<T>(1.5), castIfNot<T>(1)});
+  ASSERT(id[0] == 1);
+  ASSERT(id[1] == 2);
+  id = grid.getCellIndexContaining({castIfNot<T>(3), castIfNot<T>(-1)});
+  ASSERT(id[0] == 3);
+  ASSERT(id[1] == 0);
+  // Outside
+  id = grid.getCellIndexContaining({castIfNot<T>(0.9), castIfNot<T>(1.1)});
+  ASSERT(id[0] == -1);
+  ASSERT(id[1] == -1);
+}
+
 template <Int D, class T>
 TEST_SUITE(RectilinearGrid)
 {
@@ -188,6 +215,7 @@ TEST_SUITE(RectilinearGrid)
   TEST_HOSTDEV(boundingBox, D, T);
   if constexpr (D == 2) {
     TEST_HOSTDEV(getBox, T);
+    TEST_HOSTDEV(getCellIndexContaining, T);
     TEST(aabb_constructor<T>);
     TEST(id_array_constructor<T>);
   }
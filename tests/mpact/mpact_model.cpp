@@ -508,6 +508,213 @@ TEST_CASE(importCoarseCellMeshes)
   ASSERT(quad_mesh.faceVertexConn()[0][3] == 3);
 }
 
+TEST_CASE(importCoarseCellMeshes_duplicate)
+{
+  um2::mpact::Model model;
+  for (auto const * name : {"Clad", "H2O", "UO2"}) {
+    um2::Material mat;
+    mat.setName(name);
+    mat.xsec() = um2::XSec(1);
+    mat.xsec().isMacro() = true;
+    model.addMaterial(mat);
+  }
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model.addLattice({{0}});
+  model.addAssembly({0});
+  model.addCore({{0}});
+  model.importCoarseCellMeshes("./mpact_mesh_files/coarse_cells_duplicate.inp");
+
+  // Coarse cells 0 and 1 have translated copies of the same mesh, but different
+  // materials.
+  ASSERT(model.triMeshes().size() == 1);
+  ASSERT(model.quadMeshes().size() == 1);
+  auto const & cell0 = model.getCoarseCell(0);
+  auto const & cell1 = model.getCoarseCell(1);
+  ASSERT(cell0.mesh_type == um2::MeshType::Tri);
+  ASSERT(cell1.mesh_type == um2::MeshType::Tri);
+  ASSERT(cell0.mesh_id == 0);
+  ASSERT(cell1.mesh_id == 0);
+  ASSERT(cell0.material_ids[0] == 1);
+  ASSERT(cell0.material_ids[1] == 2);
+  ASSERT(cell1.material_ids[0] == 1);
+  ASSERT(cell1.material_ids[1] == 0);
+  ASSERT(model.getCoarseCell(2).mesh_id == 0);
+  ASSERT(model.numFineCellsTotal() == 6);
+}
+
+TEST_CASE(findFSR)
+{
+  um2::mpact::Model model;
+  for (auto const * name : {"Clad", "H2O", "UO2"}) {
+    um2::Material mat;
+    mat.setName(name);
+    mat.xsec() = um2::XSec(1);
+    mat.xsec().isMacro() = true;
+    model.addMaterial(mat);
+  }
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model.addLattice({{0}});
+  model.addAssembly({0});
+  model.addCore({{0}});
+  model.importCoarseCellMeshes("./mpact_mesh_files/coarse_cells.inp");
+  ASSERT(model.numFineCellsTotal() == 6);
+
+  // FSRs are numbered by coarse cell instance, then by face.
+  um2::Vector<um2::Point2F> const points = {
+      {0.75, 0.25},
+      {0.25, 0.75},
+      {1.2,  0.6 },
+      {1.8,  0.8 },
+      {0.5,  1.5 },
+      {1.5,  1.5 },
+      {2.5,  0.5 },
+      {0.5,  -0.5}
+  };
+  Int const expected[] = {0, 1, 2, 3, 4, 5, -1, -1};
+  auto const z = castIfNot<Float>(0);
+  for (Int i = 0; i < points.size(); ++i) {
+    ASSERT(model.findFSR(points[i]) == expected[i]);
+    ASSERT(model.findFSR(um2::Point3F(points[i][0], points[i][1], z)) == expected[i]);
+  }
+  // Above the top of the assembly
+  ASSERT(model.findFSR(um2::Point3F(points[0][0], points[0][1], z + 1)) == -1);
+
+  auto const fsrs = model.findFSRs(points);
+  ASSERT(fsrs.size() == points.size());
+  for (Int i = 0; i < points.size(); ++i) {
+    ASSERT(fsrs[i] == expected[i]);
+  }
+
+  // The RTM children are {0, 1, 2, 2}, with 2, 2, 1, and 1 faces.
+  ASSERT(model.numCoarseCellsTotal() == 4);
+  auto const & instances = model.coarseCellInstances();
+  ASSERT(instances.size() == 4);
+  Int const cc_ids[] = {0, 1, 2, 2};
+  Int const offsets[] = {0, 2, 4, 5};
+  for (Int i = 0; i < 4; ++i) {
+    ASSERT(instances[i].assembly == 0);
+    ASSERT(instances[i].lattice == 0);
+    ASSERT(instances[i].rtm == 0);
+    ASSERT(instances[i].coarse_cell == i);
+    ASSERT(instances[i].cc_id == cc_ids[i]);
+    ASSERT(instances[i].fsr_offset == offsets[i]);
+  }
+  for (Int i = 0; i < 6; ++i) {
+    auto const location = model.getFSRLocation(i);
+    ASSERT(model.getFSRIndex(location.first, location.second) == i);
+  }
+  ASSERT(model.getFSRLocation(3).first == 1);
+  ASSERT(model.getFSRLocation(3).second == 1);
+  ASSERT(model.getFSRLocation(5).first == 3);
+  ASSERT(model.getFSRLocation(5).second == 0);
+
+}
+
+TEST_CASE(findFSR_repeated)
+{
+  // The RTM of findFSR repeated twice in the lattice, and the assembly repeated
+  // twice in the core.
+  um2::mpact::Model model;
+  for (auto const * name : {"Clad", "H2O", "UO2"}) {
+    um2::Material mat;
+    mat.setName(name);
+    mat.xsec() = um2::XSec(1);
+    mat.xsec().isMacro() = true;
+    model.addMaterial(mat);
+  }
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addCoarseCell({1, 1});
+  model.addRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model.addLattice({{0, 0}});
+  model.addAssembly({0});
+  model.addCore({{0, 0}});
+  model.importCoarseCellMeshes("./mpact_mesh_files/coarse_cells.inp");
+  ASSERT(model.numFineCellsTotal() == 24);
+
+  um2::Vector<um2::Point2F> const points = {
+      {0.75, 0.25},
+      {0.25, 0.75},
+      {1.2,  0.6 },
+      {1.8,  0.8 },
+      {0.5,  1.5 },
+      {1.5,  1.5 }
+  };
+  for (Int i = 0; i < points.size(); ++i) {
+    for (Int j = 0; j < 4; ++j) {
+      um2::Point2F const p(points[i][0] + castIfNot<Float>(2 * j), points[i][1]);
+      ASSERT(model.findFSR(p) == i + 6 * j);
+    }
+  }
+  ASSERT(model.findFSR(um2::Point2F(castIfNot<Float>(8.5), castIfNot<Float>(0.5))) ==
+         -1);
+}
+
+TEST_CASE(spaceFillingCurveSort)
+{
+  // Two coarse cells share a pin mesh with different materials. After sorting,
+  // the material of each face must be the material it had before sorting.
+  um2::mpact::Model model;
+  for (auto const * name : {"Clad", "H2O", "UO2"}) {
+    um2::Material mat;
+    mat.setName(name);
+    mat.xsec() = um2::XSec(1);
+    mat.xsec().isMacro() = true;
+    model.addMaterial(mat);
+  }
+  auto const pitch = castIfNot<Float>(1.26);
+  um2::Vector<Float> const radii = {castIfNot<Float>(0.4096), castIfNot<Float>(0.475),
+                                    castIfNot<Float>(0.575)};
+  um2::Vector<Int> const num_rings = {3, 1, 1};
+  Int const mesh_id = model.addCylindricalPinMesh(pitch, radii, num_rings, 8, 1);
+  Int const num_faces = model.getQuadMesh(mesh_id).numFaces();
+  um2::Vector<MatID> mat_ids0(num_faces);
+  um2::Vector<MatID> mat_ids1(num_faces);
+  for (Int i = 0; i < num_faces; ++i) {
+    mat_ids0[i] = static_cast<MatID>(i % 3);
+    mat_ids1[i] = static_cast<MatID>((i / 8) % 3);
+  }
+  um2::Vec2F const dxdy(pitch, pitch);
+  model.addCoarseCell(dxdy, um2::MeshType::Quad, mesh_id, mat_ids0);
+  model.addCoarseCell(dxdy, um2::MeshType::Quad, mesh_id, mat_ids1);
+  um2::Vector<um2::Point2F> centroids(num_faces);
+  for (Int i = 0; i < num_faces; ++i) {
+    centroids[i] = model.getQuadMesh(mesh_id).getFace(i).centroid();
+  }
+
+  model.spaceFillingCurveSort();
+  auto const & mesh = model.getQuadMesh(mesh_id);
+  ASSERT(mesh.numFaces() == num_faces);
+  bool moved = false;
+  for (Int i = 0; i < num_faces; ++i) {
+    auto const c = mesh.getFace(i).centroid();
+    Int j = 0;
+    while (j < num_faces && !c.isApprox(centroids[j])) {
+      ++j;
+    }
+    ASSERT(j < num_faces);
+    moved = moved || j != i;
+    ASSERT(model.getCoarseCell(0).material_ids[i] == mat_ids0[j]);
+    ASSERT(model.getCoarseCell(1).material_ids[i] == mat_ids1[j]);
+  }
+  ASSERT(moved);
+}
+
 TEST_CASE(operator_PolytopeSoup)
 {
   um2::mpact::Model model_out;
@@ -964,6 +1171,10 @@ TEST_SUITE(mpact_Model)
   TEST(addCore);
   TEST(addCoarseGrid);
   TEST(importCoarseCellMeshes);
+  TEST(importCoarseCellMeshes_duplicate);
+  TEST(findFSR);
+  TEST(findFSR_repeated);
+  TEST(spaceFillingCurveSort);
   TEST(operator_PolytopeSoup);
   TEST(io);
   TEST(getCoarseCellHomogenizedXSec);
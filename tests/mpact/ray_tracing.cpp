@@ -0,0 +1,181 @@
+#include <um2/config.hpp>
+
+#include <um2/common/cast_if_not.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/element_types.hpp>
+#include <um2/mpact/model.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/physics/material.hpp>
+#include <um2/stdlib/math/abs.hpp>
+#include <um2/stdlib/numbers.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include "../test_macros.hpp"
+
+auto constexpr eps = um2::epsDistance<Float>();
+
+// A 2 by 2 RTM of identical pin cells, in a 1 by 2 lattice, in a single assembly.
+auto
+makePinModel() -> um2::mpact::Model
+{
+  um2::mpact::Model model;
+  um2::Material fuel;
+  fuel.setName("Fuel");
+  model.addMaterial(fuel, /*validate=*/false);
+  auto const pitch = castIfNot<Float>(1.26);
+  um2::Vector<Float> const radii = {castIfNot<Float>(0.4096), castIfNot<Float>(0.475),
+                                    castIfNot<Float>(0.575)};
+  um2::Vector<Int> const num_rings = {2, 1, 1};
+  Int const mesh_id = model.addCylindricalPinMesh(pitch, radii, num_rings, 8);
+  Int const num_faces = model.getQuadMesh(mesh_id).numFaces();
+  um2::Vector<MatID> const mat_ids(num_faces, 0);
+  model.addCoarseCell({pitch, pitch}, um2::MeshType::Quad, mesh_id, mat_ids);
+  model.addRTM({{0, 0}, {0, 0}});
+  model.addLattice({{0, 0}});
+  model.addAssembly({0});
+  model.addCore({{0}});
+  return model;
+}
+
+TEST_CASE(traceModularRays)
+{
+  um2::mpact::Model const model = makePinModel();
+  um2::Vector<Float> const angles = {
+      um2::pi<Float> / 8, castIfNot<Float>(3) * um2::pi<Float> / 8,
+      castIfNot<Float>(5) * um2::pi<Float> / 8, castIfNot<Float>(7) * um2::pi<Float> / 8};
+  auto const spacing = castIfNot<Float>(0.01);
+  auto const segments = um2::mpact::traceModularRays(model, angles, spacing);
+  ASSERT(segments.numAngles() == 4);
+  ASSERT(segments.ray_offsets.size() == 5);
+  ASSERT(segments.ray_offsets[4] == segments.numRays());
+  ASSERT(segments.segment_offsets[segments.numRays()] == segments.numSegments());
+  ASSERT(segments.lengths.size() == segments.numSegments());
+
+  Int const num_rtms = model.numRTMsTotal();
+  Int const num_fsrs = model.numFineCellsTotal();
+  auto const & mesh = model.getQuadMesh(0);
+  Int const num_faces = mesh.numFaces();
+  auto const rtm_box = model.getRTM(0).grid().boundingBox();
+  for (Int ia = 0; ia < segments.numAngles(); ++ia) {
+    auto const & params = segments.params[ia];
+    Int const num_rays = params.getTotalNumRays();
+    ASSERT(segments.ray_offsets[ia + 1] - segments.ray_offsets[ia] ==
+           num_rtms * num_rays);
+
+    // The segments of each ray must add up to the chord of the ray through the RTM.
+    for (Int irtm = 0; irtm < num_rtms; ++irtm) {
+      for (Int iray = 0; iray < num_rays; ++iray) {
+        Int const i = segments.ray_offsets[ia] + irtm * num_rays + iray;
+        auto const r = rtm_box.intersect(params.getRay(iray));
+        Float length = 0;
+        for (Int j = segments.segment_offsets[i]; j < segments.segment_offsets[i + 1];
+             ++j) {
+          ASSERT(0 <= segments.fsr_ids[j]);
+          ASSERT(segments.fsr_ids[j] < num_fsrs);
+          ASSERT(segments.lengths[j] > 0);
+          length += segments.lengths[j];
+        }
+        ASSERT_NEAR(length, r[1] - r[0], 10 * eps);
+      }
+    }
+
+    // The area of each face estimated from the segments should be close to
+    // its true area.
+    um2::Vector<Float> areas(num_faces, 0);
+    Float const perp_spacing = params.getSpacing()[0] * params.getDirection()[1];
+    for (Int j = segments.segment_offsets[segments.ray_offsets[ia]];
+         j < segments.segment_offsets[segments.ray_offsets[ia + 1]]; ++j) {
+      areas[segments.fsr_ids[j] % num_faces] += segments.lengths[j] * perp_spacing;
+    }
+    Int const num_instances = num_fsrs / num_faces;
+    for (Int i = 0; i < num_faces; ++i) {
+      Float const area = mesh.getFace(i).area();
+      Float const est = areas[i] / static_cast<Float>(num_instances);
+      ASSERT(um2::abs(est - area) / area < castIfNot<Float>(0.05));
+    }
+  }
+}
+
+TEST_CASE(getSegmentTemplates)
+{
+  um2::mpact::Model const model = makePinModel();
+  um2::Vector<Float> const angles = {um2::pi<Float> / 4,
+                                     castIfNot<Float>(3) * um2::pi<Float> / 4};
+  auto const spacing = castIfNot<Float>(0.05);
+  auto const templates = um2::mpact::getSegmentTemplates(model, angles, spacing);
+  ASSERT(templates.numAngles() == 2);
+  ASSERT(templates.numRTMs() == 2);
+  ASSERT(templates.rtm_ids[0] == 0);
+  ASSERT(templates.rtm_ids[1] == 0);
+  Int const rtm_fsrs = model.numFineCellsTotal() / 2;
+  ASSERT(templates.fsr_offsets[0] == 0);
+  ASSERT(templates.fsr_offsets[1] == rtm_fsrs);
+  for (Int ia = 0; ia < 2; ++ia) {
+    auto const & t = templates.getTemplate(0, ia);
+    ASSERT(t.numRays() == templates.params[ia].getTotalNumRays());
+    for (auto const id : t.fsr_ids) {
+      ASSERT(0 <= id);
+      ASSERT(id < rtm_fsrs);
+    }
+  }
+
+  // Both instances of the RTM are stitched from the same template.
+  auto const segments = um2::mpact::stitchSegmentTemplates(templates);
+  for (Int ia = 0; ia < 2; ++ia) {
+    auto const & t = templates.getTemplate(0, ia);
+    for (Int irtm = 0; irtm < 2; ++irtm) {
+      for (Int iray = 0; iray < t.numRays(); ++iray) {
+        Int const i = segments.ray_offsets[ia] + irtm * t.numRays() + iray;
+        Int const num_segs = segments.segment_offsets[i + 1] - segments.segment_offsets[i];
+        ASSERT(num_segs == t.segment_offsets[iray + 1] - t.segment_offsets[iray]);
+        for (Int j = 0; j < num_segs; ++j) {
+          Int const js = segments.segment_offsets[i] + j;
+          Int const jt = t.segment_offsets[iray] + j;
+          ASSERT(segments.fsr_ids[js] == templates.fsr_offsets[irtm] + t.fsr_ids[jt]);
+          ASSERT_NEAR(segments.lengths[js], t.lengths[jt], 0);
+        }
+      }
+    }
+  }
+}
+
+#if UM2_USE_OPENMP
+TEST_CASE(deterministic)
+{
+  // The segments must not depend on the number of threads.
+  um2::mpact::Model const model = makePinModel();
+  um2::Vector<Float> const angles = {um2::pi<Float> / 8,
+                                     castIfNot<Float>(5) * um2::pi<Float> / 8};
+  auto const spacing = castIfNot<Float>(0.02);
+  int const max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  auto const serial = um2::mpact::traceModularRays(model, angles, spacing);
+  omp_set_num_threads(4);
+  auto const parallel = um2::mpact::traceModularRays(model, angles, spacing);
+  omp_set_num_threads(max_threads);
+  ASSERT(serial.ray_offsets == parallel.ray_offsets);
+  ASSERT(serial.segment_offsets == parallel.segment_offsets);
+  ASSERT(serial.fsr_ids == parallel.fsr_ids);
+  ASSERT(serial.numSegments() == parallel.numSegments());
+  for (Int i = 0; i < serial.numSegments(); ++i) {
+    ASSERT_NEAR(serial.lengths[i], parallel.lengths[i], 0);
+  }
+}
+#endif
+
+TEST_SUITE(mpact_ray_tracing)
+{
+  TEST(traceModularRays);
+  TEST(getSegmentTemplates);
+#if UM2_USE_OPENMP
+  TEST(deterministic);
+#endif
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(mpact_ray_tracing);
+  return 0;
+}
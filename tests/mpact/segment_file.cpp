@@ -0,0 +1,180 @@
+#include <um2/config.hpp>
+
+#include <um2/common/cast_if_not.hpp>
+#include <um2/common/logger.hpp>
+#include <um2/geometry/axis_aligned_box.hpp>
+#include <um2/math/vec.hpp>
+#include <um2/mesh/element_types.hpp>
+#include <um2/mpact/model.hpp>
+#include <um2/mpact/ray_tracing.hpp>
+#include <um2/mpact/segment_file.hpp>
+#include <um2/physics/material.hpp>
+#include <um2/stdlib/algorithm/max.hpp>
+#include <um2/stdlib/math/abs.hpp>
+#include <um2/stdlib/numbers.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <cstdint> // int32_t, int64_t
+#include <cstdio>  // remove
+#include <fstream> // fstream
+
+#include "../test_macros.hpp"
+
+auto
+makePinModel() -> um2::mpact::Model
+{
+  um2::mpact::Model model;
+  um2::Material fuel;
+  fuel.setName("Fuel");
+  model.addMaterial(fuel, /*validate=*/false);
+  auto const pitch = castIfNot<Float>(1.26);
+  um2::Vector<Float> const radii = {castIfNot<Float>(0.4096), castIfNot<Float>(0.475),
+                                    castIfNot<Float>(0.575)};
+  um2::Vector<Int> const num_rings = {2, 1, 1};
+  Int const mesh_id = model.addCylindricalPinMesh(pitch, radii, num_rings, 8);
+  Int const num_faces = model.getQuadMesh(mesh_id).numFaces();
+  um2::Vector<MatID> const mat_ids(num_faces, 0);
+  model.addCoarseCell({pitch, pitch}, um2::MeshType::Quad, mesh_id, mat_ids);
+  model.addRTM({{0, 0}, {0, 0}});
+  model.addLattice({{0, 0}});
+  model.addAssembly({0});
+  model.addCore({{0}});
+  return model;
+}
+
+// Write the segments in the given format, read them back, and check that they
+// match. Lengths must be within rel_tol of the original value, or within
+// abs_tol.
+void
+checkRoundTrip(um2::mpact::ModularRaySegments const & segments,
+               um2::mpact::SegmentLengthFormat format, Float rel_tol, Float abs_tol)
+{
+  um2::String const filename("segments.bin");
+  um2::mpact::writeSegmentFile(filename, segments, format);
+  um2::mpact::SegmentFile file(filename);
+  ASSERT(file.isOpen());
+  ASSERT(file.lengthFormat() == format);
+  ASSERT(file.numAngles() == segments.numAngles());
+  ASSERT(file.numRays() == segments.numRays());
+  ASSERT(file.numSegments() == segments.numSegments());
+
+  for (Int ia = 0; ia < segments.numAngles(); ++ia) {
+    auto const & expected = segments.params[ia];
+    auto const params = file.getParams(ia);
+    ASSERT(params.getNumXRays() == expected.getNumXRays());
+    ASSERT(params.getNumYRays() == expected.getNumYRays());
+    ASSERT_NEAR(params.getSpacing()[0], expected.getSpacing()[0], 0);
+    ASSERT_NEAR(params.getSpacing()[1], expected.getSpacing()[1], 0);
+    ASSERT_NEAR(params.getDirection()[0], expected.getDirection()[0], 0);
+    ASSERT_NEAR(params.getDirection()[1], expected.getDirection()[1], 0);
+    ASSERT_NEAR(params.getBox().maxima(0), expected.getBox().maxima(0), 0);
+    ASSERT_NEAR(params.getBox().maxima(1), expected.getBox().maxima(1), 0);
+    ASSERT(file.getFirstRay(ia) == segments.ray_offsets[ia]);
+  }
+  ASSERT(file.getFirstRay(segments.numAngles()) == segments.numRays());
+
+  um2::Vector<Int> fsr_ids;
+  um2::Vector<Float> lengths;
+  for (Int i = 0; i < segments.numRays(); ++i) {
+    Int const first = segments.segment_offsets[i];
+    Int const n = segments.segment_offsets[i + 1] - first;
+    ASSERT(file.numSegments(i) == n);
+    fsr_ids.resize(um2::max(n, 1));
+    lengths.resize(um2::max(n, 1));
+    ASSERT(file.getRay(i, fsr_ids.data(), lengths.data()) == n);
+    for (Int j = 0; j < n; ++j) {
+      ASSERT(fsr_ids[j] == segments.fsr_ids[first + j]);
+      Float const l = segments.lengths[first + j];
+      ASSERT(um2::abs(lengths[j] - l) <= um2::max(rel_tol * l, abs_tol));
+    }
+  }
+  file.close();
+  ASSERT(!file.isOpen());
+  int const stat = std::remove(filename.data());
+  ASSERT(stat == 0);
+}
+
+TEST_CASE(roundTrip)
+{
+  um2::mpact::Model const model = makePinModel();
+  um2::Vector<Float> const angles = {um2::pi<Float> / 8,
+                                     castIfNot<Float>(5) * um2::pi<Float> / 8};
+  auto const spacing = castIfNot<Float>(0.05);
+  auto const segments = um2::mpact::traceModularRays(model, angles, spacing);
+  ASSERT(segments.numSegments() > 0);
+  Float max_length = 0;
+  for (auto const l : segments.lengths) {
+    max_length = um2::max(max_length, l);
+  }
+  checkRoundTrip(segments, um2::mpact::SegmentLengthFormat::Float32,
+                 castIfNot<Float>(1e-6), 0);
+  checkRoundTrip(segments, um2::mpact::SegmentLengthFormat::Float16,
+                 castIfNot<Float>(1e-3), castIfNot<Float>(1e-7));
+  checkRoundTrip(segments, um2::mpact::SegmentLengthFormat::Quantized16, 0,
+                 max_length / castIfNot<Float>(65535));
+}
+
+// Overwrite size bytes of the file at the given offset
+void
+patchFile(um2::String const & filename, std::streamoff offset, void const * data,
+          std::streamsize size)
+{
+  std::fstream file(filename.data(), std::ios::binary | std::ios::in | std::ios::out);
+  ASSERT(file.is_open());
+  file.seekp(offset);
+  file.write(static_cast<char const *>(data), size);
+}
+
+TEST_CASE(corruptFile)
+{
+  um2::mpact::Model const model = makePinModel();
+  um2::Vector<Float> const angles = {um2::pi<Float> / 8};
+  auto const segments =
+      um2::mpact::traceModularRays(model, angles, castIfNot<Float>(0.1));
+  um2::String const filename("segments_corrupt.bin");
+  um2::logger::exit_on_error = false;
+
+  // Invalid length format
+  um2::mpact::writeSegmentFile(filename, segments);
+  int32_t const bad_format = 7;
+  patchFile(filename, 12, &bad_format, sizeof(bad_format));
+  um2::mpact::SegmentFile file(filename);
+  ASSERT(!file.isOpen());
+
+  // Number of segments inconsistent with the segment offsets
+  um2::mpact::writeSegmentFile(filename, segments);
+  int64_t const bad_num_segments = segments.numSegments() + 1;
+  patchFile(filename, 24, &bad_num_segments, sizeof(bad_num_segments));
+  file.open(filename);
+  ASSERT(!file.isOpen());
+
+  // Section offset outside the file
+  um2::mpact::writeSegmentFile(filename, segments);
+  int64_t const bad_offset = int64_t{1} << 40;
+  patchFile(filename, 56, &bad_offset, sizeof(bad_offset));
+  file.open(filename);
+  ASSERT(!file.isOpen());
+
+  // The unmodified file opens
+  um2::mpact::writeSegmentFile(filename, segments);
+  file.open(filename);
+  ASSERT(file.isOpen());
+  file.close();
+
+  um2::logger::exit_on_error = true;
+  int const stat = std::remove(filename.data());
+  ASSERT(stat == 0);
+}
+
+TEST_SUITE(mpact_segment_file)
+{
+  TEST(roundTrip);
+  TEST(corruptFile);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(mpact_segment_file);
+  return 0;
+}
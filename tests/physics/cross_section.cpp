@@ -2,6 +2,9 @@
 #include <um2/config.hpp>
 #include <um2/math/stats.hpp>
 #include <um2/physics/cross_section.hpp>
+#include <um2/stdlib/vector.hpp>
+
+#include <cstdint> // uintptr_t
 
 #include "../test_macros.hpp"
 
@@ -17,10 +20,117 @@ TEST_CASE(collapseTo1GroupAvg)
   ASSERT_NEAR(oneg.nuf()[0], um2::mean(xsec.nuf().begin(), xsec.nuf().end()), eps);
   ASSERT_NEAR(oneg.tr()[0], um2::mean(xsec.tr().begin(), xsec.tr().end()), eps);
   ASSERT_NEAR(oneg.s()[0], um2::mean(xsec.s().begin(), xsec.s().end()), eps);
-  ASSERT_NEAR(oneg.ss()(0), um2::mean(xsec.s().begin(), xsec.s().end()), eps);
+  ASSERT_NEAR(oneg.ss()(0, 0), um2::mean(xsec.s().begin(), xsec.s().end()), eps);
 }
 
-TEST_SUITE(XSec) { TEST(collapseTo1GroupAvg); }
+TEST_CASE(banded_ss)
+{
+  auto constexpr eps = castIfNot<Float>(1e-6);
+  auto const xsecs = um2::getC5G7XSecs();
+  um2::XSec const & uo2 = xsecs[0];
+  Int const ng = uo2.numGroups();
+  // Only the band of each row is stored
+  ASSERT(uo2.ss().numStored() < ng * ng);
+
+  // The column sums of the scattering matrix are the total scattering
+  um2::Vector<Float> sums(ng);
+  uo2.ss().columnSums(sums.data());
+  for (Int g = 0; g < ng; ++g) {
+    ASSERT_NEAR(sums[g], uo2.s()[g], eps);
+  }
+
+  // The scattering source matches the dense product
+  um2::Vector<Float> phi(ng);
+  for (Int g = 0; g < ng; ++g) {
+    phi[g] = static_cast<Float>(g + 1);
+  }
+  um2::Vector<Float> q(ng);
+  uo2.scatteringSource(phi.data(), q.data());
+  auto const dense = uo2.ss().toDense();
+  for (Int g = 0; g < ng; ++g) {
+    Float expected = 0;
+    for (Int gg = 0; gg < ng; ++gg) {
+      expected += dense(g, gg) * phi[gg];
+    }
+    ASSERT_NEAR(q[g], expected, eps);
+  }
+
+  // Area-weighted average of two materials with different bands
+  um2::XSec const & mod = xsecs[6];
+  um2::XSec avg(ng);
+  avg.axpy(1, uo2);
+  avg.axpy(3, mod);
+  avg *= castIfNot<Float>(0.25);
+  for (Int g = 0; g < ng; ++g) {
+    ASSERT_NEAR(avg.a()[g], (uo2.a()[g] + 3 * mod.a()[g]) / 4, eps);
+    ASSERT_NEAR(avg.s()[g], (uo2.s()[g] + 3 * mod.s()[g]) / 4, eps);
+    for (Int gg = 0; gg < ng; ++gg) {
+      ASSERT_NEAR(avg.ss()(g, gg), (uo2.ss()(g, gg) + 3 * mod.ss()(g, gg)) / 4, eps);
+    }
+  }
+}
+
+TEST_CASE(arithmetic)
+{
+  auto constexpr eps = castIfNot<Float>(1e-6);
+  auto const xsecs = um2::getC5G7XSecs();
+  Int const ng = xsecs[0].numGroups();
+
+  // Each reaction starts on a 64-byte boundary
+  for (auto const & xs : xsecs) {
+    for (auto const * p : {xs.a().data(), xs.f().data(), xs.nuf().data(),
+                           xs.tr().data(), xs.s().data()}) {
+      ASSERT(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+    }
+  }
+
+  // this += a * lerp(x0, x1, d)
+  Float constexpr a = 2;
+  Float constexpr d = castIfNot<Float>(0.3);
+  um2::XSec y = xsecs[1];
+  y.addLerp(a, d, xsecs[0], xsecs[6]);
+  for (Int g = 0; g < ng; ++g) {
+    auto const lerp = [&](Float x0, Float x1) { return x0 + d * (x1 - x0); };
+    ASSERT_NEAR(y.a()[g], xsecs[1].a()[g] + a * lerp(xsecs[0].a()[g], xsecs[6].a()[g]),
+                eps);
+    ASSERT_NEAR(y.tr()[g],
+                xsecs[1].tr()[g] + a * lerp(xsecs[0].tr()[g], xsecs[6].tr()[g]), eps);
+    for (Int gg = 0; gg < ng; ++gg) {
+      ASSERT_NEAR(y.ss()(g, gg),
+                  xsecs[1].ss()(g, gg) +
+                      a * lerp(xsecs[0].ss()(g, gg), xsecs[6].ss()(g, gg)),
+                  eps);
+    }
+  }
+
+  // The weighted sum matches repeated axpy
+  um2::Vector<um2::XSec const *> ptrs;
+  um2::Vector<Float> weights;
+  um2::XSec ref(ng);
+  for (Int i = 0; i < xsecs.size(); ++i) {
+    ptrs.emplace_back(&xsecs[i]);
+    weights.emplace_back(static_cast<Float>(i + 1) / 28);
+    ref.axpy(weights.back(), xsecs[i]);
+  }
+  auto const sum = um2::weightedSum(ptrs.size(), ptrs.data(), weights.data());
+  for (Int g = 0; g < ng; ++g) {
+    ASSERT_NEAR(sum.a()[g], ref.a()[g], eps);
+    ASSERT_NEAR(sum.f()[g], ref.f()[g], eps);
+    ASSERT_NEAR(sum.nuf()[g], ref.nuf()[g], eps);
+    ASSERT_NEAR(sum.tr()[g], ref.tr()[g], eps);
+    ASSERT_NEAR(sum.s()[g], ref.s()[g], eps);
+    for (Int gg = 0; gg < ng; ++gg) {
+      ASSERT_NEAR(sum.ss()(g, gg), ref.ss()(g, gg), eps);
+    }
+  }
+}
+
+TEST_SUITE(XSec)
+{
+  TEST(collapseTo1GroupAvg);
+  TEST(banded_ss);
+  TEST(arithmetic);
+}
 
 auto
 main() -> int
@@ -9,6 +9,8 @@
 
 #  include "../test_macros.hpp"
 
+#  include <cstdio>
+
 TEST_CASE(readMPACTLibrary)
 {
   auto const eps = castIfNot<Float>(1e-4);
@@ -30,7 +32,101 @@ TEST_CASE(readMPACTLibrary)
   ASSERT(lib51.nuclides().size() == 298);
 }
 
-TEST_SUITE(XSLibrary) { TEST(readMPACTLibrary); }
+// A library read from the cache must be identical to the parsed library.
+TEST_CASE(cache)
+{
+  um2::String const filename =
+      um2::settings::xs::library_path + "/" + um2::mpact::XSLIB_8G;
+  um2::String const cache_filename = um2::xsLibraryCacheFilename(filename);
+  um2::settings::xs::use_library_cache = false;
+  um2::XSLibrary const parsed(filename);
+  um2::settings::xs::use_library_cache = true;
+  std::remove(cache_filename.data());
+  um2::XSLibrary const written(filename); // Parses and writes the cache
+  um2::XSLibrary cached;
+  ASSERT(cached.readCache(cache_filename, filename));
+  ASSERT(cached.numGroups() == parsed.numGroups());
+  for (Int ig = 0; ig < parsed.numGroups(); ++ig) {
+    ASSERT_NEAR(cached.groupBounds()[ig], parsed.groupBounds()[ig], 0);
+    ASSERT_NEAR(cached.chi()[ig], parsed.chi()[ig], 0);
+  }
+  ASSERT(cached.nuclides().size() == parsed.nuclides().size());
+  Int const num_groups = parsed.numGroups();
+  for (Int i = 0; i < parsed.nuclides().size(); ++i) {
+    auto const & a = cached.nuclides()[i];
+    auto const & b = parsed.nuclides()[i];
+    ASSERT(a.zaid() == b.zaid());
+    ASSERT(a.isFissile() == b.isFissile());
+    ASSERT_NEAR(a.mass(), b.mass(), 0);
+    ASSERT(a.xs().size() == b.xs().size());
+    for (Int it = 0; it < b.xs().size(); ++it) {
+      ASSERT_NEAR(a.temperatures()[it], b.temperatures()[it], 0);
+      auto const & xa = a.xs()[it];
+      auto const & xb = b.xs()[it];
+      ASSERT(xa.isFissile() == xb.isFissile());
+      for (Int ig = 0; ig < num_groups; ++ig) {
+        ASSERT_NEAR(xa.a()[ig], xb.a()[ig], 0);
+        ASSERT_NEAR(xa.nuf()[ig], xb.nuf()[ig], 0);
+        ASSERT_NEAR(xa.tr()[ig], xb.tr()[ig], 0);
+        for (Int jg = 0; jg < num_groups; ++jg) {
+          ASSERT_NEAR(xa.ss()(ig, jg), xb.ss()(ig, jg), 0);
+        }
+      }
+    }
+  }
+
+  // The cache does not match any other library file.
+  um2::String const other = um2::settings::xs::library_path + "/" + um2::mpact::XSLIB_51G;
+  ASSERT(!cached.readCache(cache_filename, other));
+  ASSERT(cached.numGroups() == parsed.numGroups());
+}
+
+// A lazy library reads the cross sections of a nuclide only when requested,
+// and they must match those of the fully parsed library.
+TEST_CASE(lazy)
+{
+  um2::String const filename =
+      um2::settings::xs::library_path + "/" + um2::mpact::XSLIB_8G;
+  um2::XSLibrary const eager(filename);
+  um2::XSLibrary const lazy(filename, /*lazy=*/true);
+  ASSERT(!eager.isLazy());
+  ASSERT(lazy.isLazy());
+  ASSERT(lazy.numGroups() == eager.numGroups());
+  ASSERT(lazy.nuclides().size() == eager.nuclides().size());
+  for (Int i = 0; i < eager.nuclides().size(); ++i) {
+    Int const zaid = eager.nuclides()[i].zaid();
+    ASSERT(eager.getNuclideIndex(zaid) == i);
+    ASSERT(lazy.getNuclideIndex(zaid) == i);
+    ASSERT(lazy.nuclides()[i].xs().empty());
+  }
+  ASSERT(eager.getNuclideIndex(-1) == -1);
+
+  Int const num_groups = eager.numGroups();
+  for (Int const zaid : {1001, 8016, 92235, 92238}) {
+    auto const & a = lazy.getNuclide(zaid);
+    auto const & b = eager.getNuclide(zaid);
+    ASSERT(a.zaid() == zaid);
+    ASSERT(a.isFissile() == b.isFissile());
+    ASSERT(a.xs().size() == b.xs().size());
+    for (Int it = 0; it < b.xs().size(); ++it) {
+      ASSERT_NEAR(a.temperatures()[it], b.temperatures()[it], 0);
+      for (Int ig = 0; ig < num_groups; ++ig) {
+        ASSERT_NEAR(a.xs()[it].a()[ig], b.xs()[it].a()[ig], 0);
+        ASSERT_NEAR(a.xs()[it].nuf()[ig], b.xs()[it].nuf()[ig], 0);
+        for (Int jg = 0; jg < num_groups; ++jg) {
+          ASSERT_NEAR(a.xs()[it].ss()(ig, jg), b.xs()[it].ss()(ig, jg), 0);
+        }
+      }
+    }
+  }
+}
+
+TEST_SUITE(XSLibrary)
+{
+  TEST(readMPACTLibrary);
+  TEST(cache);
+  TEST(lazy);
+}
 
 auto
 main() -> int
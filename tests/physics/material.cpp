@@ -58,6 +58,20 @@ TEST_CASE(getXS)
   fuel.populateXSec(lib8);
   ASSERT_NEAR(fuel.xsec().t(0), 9, 1)
   ASSERT_NEAR(fuel.xsec().t(1), 14, 1)
+
+  // Populating many materials at once must match populating them one by one.
+  um2::Vector<um2::Material> fuels(8, fuel);
+  for (Int i = 0; i < fuels.size(); ++i) {
+    fuels[i].setTemperature(castIfNot<Float>(300 + 100 * i));
+  }
+  um2::populateXSec(fuels, lib8);
+  for (Int i = 0; i < fuels.size(); ++i) {
+    um2::Material ref = fuels[i];
+    ref.populateXSec(lib8);
+    for (Int g = 0; g < ref.xsec().numGroups(); ++g) {
+      ASSERT_NEAR(fuels[i].xsec().t(g), ref.xsec().t(g), 0);
+    }
+  }
 }
 
 #endif
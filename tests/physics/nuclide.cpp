@@ -32,7 +32,7 @@ TEST_CASE(interpXS)
   auto & xs0ss = xs0.ss();
   for (int i = 0; i < 3; ++i) {
     for (int j = 0; j < 3; ++j) {
-      xs0ss(j, i) = j + 1;
+      xs0ss.set(j, i, static_cast<Float>(j + 1));
     }
   }
   um2::XSec xs1(3);
@@ -44,7 +44,7 @@ TEST_CASE(interpXS)
   auto & xs1ss = xs1.ss();
   for (int i = 0; i < 3; ++i) {
     for (int j = 0; j < 3; ++j) {
-      xs1ss(j, i) = j + 4;
+      xs1ss.set(j, i, static_cast<Float>(j + 4));
     }
   }
   um2::XSec xs2(3);
@@ -56,7 +56,7 @@ TEST_CASE(interpXS)
   auto & xs2ss = xs2.ss();
   for (int i = 0; i < 3; ++i) {
     for (int j = 0; j < 3; ++j) {
-      xs2ss(j, i) = j + 7;
+      xs2ss.set(j, i, static_cast<Float>(j + 7));
     }
   }
   nuc.xs() = {xs0, xs1, xs2};
@@ -89,9 +89,9 @@ TEST_CASE(interpXS)
 
   // Above max
   xs = nuc.interpXS(1000);
-  ASSERT_NEAR(xs.ss()(0), 7, eps);
-  ASSERT_NEAR(xs.ss()(1), 8, eps);
-  ASSERT_NEAR(xs.ss()(2), 9, eps);
+  ASSERT_NEAR(xs.ss()(0, 0), 7, eps);
+  ASSERT_NEAR(xs.ss()(1, 0), 8, eps);
+  ASSERT_NEAR(xs.ss()(2, 0), 9, eps);
 
   // Linear interpolation over sqrt of temperature
   Float constexpr temp = 450;
@@ -100,9 +100,32 @@ TEST_CASE(interpXS)
   ASSERT_NEAR(xs.f()[0], v0, eps);
   ASSERT_NEAR(xs.f()[1], v0 + 1, eps);
   ASSERT_NEAR(xs.f()[2], v0 + 2, eps);
-  ASSERT_NEAR(xs.ss()(0), v0, eps);
-  ASSERT_NEAR(xs.ss()(1), v0 + 1, eps);
-  ASSERT_NEAR(xs.ss()(2), v0 + 2, eps);
+  ASSERT_NEAR(xs.ss()(0, 0), v0, eps);
+  ASSERT_NEAR(xs.ss()(1, 0), v0 + 1, eps);
+  ASSERT_NEAR(xs.ss()(2, 0), v0 + 2, eps);
+
+  // Accumulating into an existing XSec must match adding the interpolated
+  // cross sections, both inside and outside the temperature range.
+  for (Float const t : {castIfNot<Float>(100), castIfNot<Float>(450),
+                        castIfNot<Float>(750), castIfNot<Float>(1000)}) {
+    Float constexpr scale = 2;
+    auto const ref = nuc.interpXS(t);
+    um2::XSec acc(3);
+    acc.a() = {1, 1, 1};
+    acc.ss().set(1, 2, 1);
+    nuc.addInterpXS(t, scale, acc);
+    for (Int g = 0; g < 3; ++g) {
+      ASSERT_NEAR(acc.a()[g], 1 + scale * ref.a()[g], eps);
+      ASSERT_NEAR(acc.f()[g], scale * ref.f()[g], eps);
+      ASSERT_NEAR(acc.nuf()[g], scale * ref.nuf()[g], eps);
+      ASSERT_NEAR(acc.tr()[g], scale * ref.tr()[g], eps);
+      ASSERT_NEAR(acc.s()[g], scale * ref.s()[g], eps);
+      for (Int gg = 0; gg < 3; ++gg) {
+        Float const init = (gg == 1 && g == 2) ? 1 : 0;
+        ASSERT_NEAR(acc.ss()(gg, g), init + scale * ref.ss()(gg, g), eps);
+      }
+    }
+  }
 }
 
 TEST_SUITE(Nuclide)